@@ -0,0 +1,118 @@
+/**
+ * @file bench_postprocess.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 各任务后处理在合成输出张量上的基准测试
+ * @date 2025-07-10
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "infer/postprocess.hpp"
+
+namespace {
+
+/**
+ * @brief 合成的批量输出张量，数值与真实引擎的输出范围一致
+ *
+ * 参数为每张图像的检测数量，张量按 [B, N, ...] 布局，批量中只有第 0 张图像被后处理。
+ */
+struct SyntheticOutputs {
+    static constexpr int kBatch     = 4;
+    static constexpr int kMaskSize  = 160;
+    static constexpr int kKeypoints = 17;
+    static constexpr int kTopk      = 5;
+
+    SyntheticOutputs(int detections, int box_size)
+        : num(kBatch, detections),
+          boxes(kBatch * detections * box_size),
+          scores(kBatch * detections, 0.5f),
+          classes(kBatch * detections),
+          masks(static_cast<size_t>(kBatch) * detections * kMaskSize * kMaskSize, 0.5f),
+          kpts(kBatch * detections * kKeypoints * 3, 1.0f),
+          topk(kBatch * kTopk * 2) {
+        for (int i = 0; i < kBatch * detections; ++i) {
+            float  offset = static_cast<float>(i % 500);
+            float* box    = &boxes[i * box_size];
+            box[0]        = offset;
+            box[1]        = offset;
+            box[2]        = offset + 60.0f;
+            box[3]        = offset + 40.0f;
+            if (box_size == 5) box[4] = 0.3f;
+            classes[i] = i % 80;
+        }
+        for (int i = 0; i < kBatch * kTopk; ++i) {
+            topk[i * 2]     = 0.9f;
+            topk[i * 2 + 1] = static_cast<float>(i % 1000);
+        }
+
+        set(trtyolo::OutputRole::Num, num.data(), {kBatch, 1, 0, 0}, sizeof(int));
+        set(trtyolo::OutputRole::Boxes, boxes.data(), {kBatch, detections, box_size, 0}, detections * box_size * sizeof(float));
+        set(trtyolo::OutputRole::Scores, scores.data(), {kBatch, detections, 0, 0}, detections * sizeof(float));
+        set(trtyolo::OutputRole::Classes, classes.data(), {kBatch, detections, 0, 0}, detections * sizeof(int));
+        set(trtyolo::OutputRole::Masks, masks.data(), {kBatch, detections, kMaskSize, kMaskSize}, static_cast<size_t>(detections) * kMaskSize * kMaskSize * sizeof(float));
+        set(trtyolo::OutputRole::Keypoints, kpts.data(), {kBatch, detections, kKeypoints, 3}, detections * kKeypoints * 3 * sizeof(float));
+        set(trtyolo::OutputRole::Topk, topk.data(), {kBatch, kTopk, 2, 0}, kTopk * 2 * sizeof(float));
+
+        transform = trtyolo::Transform{};
+        transform.update(1920, 1080, 640, 640);
+    }
+
+    void set(trtyolo::OutputRole role, const void* data, std::array<int64_t, 4> shape, size_t item_bytes) {
+        auto& view      = views[role];
+        view.data       = data;
+        view.shape      = shape;
+        view.item_bytes = item_bytes;
+    }
+
+    std::vector<int>     num;
+    std::vector<float>   boxes;
+    std::vector<float>   scores;
+    std::vector<int>     classes;
+    std::vector<float>   masks;
+    std::vector<float>   kpts;
+    std::vector<float>   topk;
+    trtyolo::OutputViews views;
+    trtyolo::Transform   transform;
+};
+
+template <typename Func>
+void runPostProcess(benchmark::State& state, int box_size, Func func) {
+    SyntheticOutputs outputs(static_cast<int>(state.range(0)), box_size);
+    for (auto _ : state) {
+        auto result = func(outputs.views, outputs.transform, 0);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PostProcessClassify(benchmark::State& state) {
+    runPostProcess(state, 4, trtyolo::postProcessClassify);
+}
+BENCHMARK(BM_PostProcessClassify)->Arg(1);
+
+void BM_PostProcessDetect(benchmark::State& state) {
+    runPostProcess(state, 4, trtyolo::postProcessDetect);
+}
+BENCHMARK(BM_PostProcessDetect)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_PostProcessOBB(benchmark::State& state) {
+    runPostProcess(state, 5, trtyolo::postProcessOBB);
+}
+BENCHMARK(BM_PostProcessOBB)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_PostProcessSegment(benchmark::State& state) {
+    runPostProcess(state, 4, trtyolo::postProcessSegment);
+}
+BENCHMARK(BM_PostProcessSegment)->Arg(10)->Arg(100);
+
+void BM_PostProcessPose(benchmark::State& state) {
+    runPostProcess(state, 4, trtyolo::postProcessPose);
+}
+BENCHMARK(BM_PostProcessPose)->Arg(10)->Arg(100);
+
+}  // namespace
@@ -0,0 +1,179 @@
+/**
+ * @file bench_python.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief Python 绑定热点的基准测试：NumPy 和 DLPack 输入转换、结果转 NumPy 数组和掩码粘贴
+ * @date 2025-07-10
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <benchmark/benchmark.h>
+#include <pybind11/embed.h>
+
+#include <vector>
+
+#include "binding/convert.hpp"
+#include "binding/dlpack.hpp"
+
+namespace {
+
+// 所有基准测试共用一个嵌入式解释器，进程退出时销毁
+void ensureInterpreter() {
+    static py::scoped_interpreter interpreter;
+}
+
+template <typename ResultType>
+ResultType makeResult(int num) {
+    ResultType result;
+    result.num = num;
+    for (int i = 0; i < num; ++i) {
+        float offset = static_cast<float>(i % 500);
+        if constexpr (std::is_same_v<ResultType, trtyolo::OBBRes>) {
+            result.boxes.emplace_back(offset, offset, offset + 60.0f, offset + 40.0f, 0.3f);
+        } else {
+            result.boxes.emplace_back(offset, offset, offset + 60.0f, offset + 40.0f);
+        }
+        result.scores.push_back(0.5f);
+        result.classes.push_back(i % 80);
+    }
+    return result;
+}
+
+void BM_PyArray2Image(benchmark::State& state) {
+    ensureInterpreter();
+    py::array_t<uint8_t> array({1080, 1920, 3});
+    for (auto _ : state) benchmark::DoNotOptimize(PyArray2Image(array));
+}
+BENCHMARK(BM_PyArray2Image);
+
+// 列表输入逐张转换与 (N, H, W, 3) 数组整体映射的对比
+void BM_PyList2Images(benchmark::State& state) {
+    ensureInterpreter();
+    std::vector<py::array> arrays;
+    for (int64_t i = 0; i < state.range(0); ++i) arrays.push_back(py::array_t<uint8_t>({1080, 1920, 3}));
+    py::list list = py::cast(arrays);
+    for (auto _ : state) {
+        auto inputs = list.cast<std::vector<py::array>>();
+        std::vector<trtyolo::Image> images;
+        for (auto& arr : inputs) images.push_back(PyArray2Image(arr));
+        benchmark::DoNotOptimize(images);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PyList2Images)->Arg(4)->Arg(16);
+
+void BM_PyArray2Images(benchmark::State& state) {
+    ensureInterpreter();
+    py::array batch = py::array_t<uint8_t>({static_cast<py::ssize_t>(state.range(0)), py::ssize_t{1080}, py::ssize_t{1920}, py::ssize_t{3}});
+    for (auto _ : state) benchmark::DoNotOptimize(PyArray2Images(batch));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PyArray2Images)->Arg(4)->Arg(16);
+
+// DLPack 输入走 NumPy 的 __dlpack__ 导出，覆盖 CPU 路径，不需要 GPU
+void BM_DLPack2Images(benchmark::State& state) {
+    ensureInterpreter();
+    py::array batch = py::array_t<uint8_t>({static_cast<py::ssize_t>(state.range(0)), py::ssize_t{1080}, py::ssize_t{1920}, py::ssize_t{3}});
+    for (auto _ : state) benchmark::DoNotOptimize(DLPack2Images(batch.attr("__dlpack__")()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DLPack2Images)->Arg(4)->Arg(16);
+
+void BM_Boxes2PyArray(benchmark::State& state) {
+    ensureInterpreter();
+    auto result = makeResult<trtyolo::DetectRes>(static_cast<int>(state.range(0)));
+    for (auto _ : state) benchmark::DoNotOptimize(Boxes2PyArray(result, py::none()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Boxes2PyArray)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_RotatedBoxes2PyArray(benchmark::State& state) {
+    ensureInterpreter();
+    auto result = makeResult<trtyolo::OBBRes>(static_cast<int>(state.range(0)));
+    for (auto _ : state) benchmark::DoNotOptimize(RotatedBoxes2PyArray(result));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RotatedBoxes2PyArray)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_ClassesScores2PyArray(benchmark::State& state) {
+    ensureInterpreter();
+    auto result = makeResult<trtyolo::DetectRes>(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Classes2PyArray(result, py::none()));
+        benchmark::DoNotOptimize(Scores2PyArray(result, py::none()));
+    }
+}
+BENCHMARK(BM_ClassesScores2PyArray)->Arg(100);
+
+void BM_Masks2PyArray(benchmark::State& state) {
+    ensureInterpreter();
+    auto result = makeResult<trtyolo::SegmentRes>(static_cast<int>(state.range(0)));
+    for (int i = 0; i < result.num; ++i) result.masks.emplace_back(160, 160);
+    for (auto _ : state) benchmark::DoNotOptimize(Masks2PyArray(result));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Masks2PyArray)->Arg(10)->Arg(100);
+
+void BM_Keypoints2PyArray(benchmark::State& state) {
+    ensureInterpreter();
+    auto result = makeResult<trtyolo::PoseRes>(static_cast<int>(state.range(0)));
+    for (int i = 0; i < result.num; ++i) result.kpts.emplace_back(17, trtyolo::KeyPoint(1.0f, 2.0f, 0.5f));
+    for (auto _ : state) benchmark::DoNotOptimize(Keypoints2PyArray(result));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Keypoints2PyArray)->Arg(10)->Arg(100);
+
+// 按列拼接整个批量的结果，对比逐张转换（BM_Boxes2PyArray 等）
+void BM_Results2BatchRes(benchmark::State& state) {
+    ensureInterpreter();
+    std::vector<trtyolo::DetectRes> results(static_cast<size_t>(state.range(0)), makeResult<trtyolo::DetectRes>(100));
+    for (auto _ : state) benchmark::DoNotOptimize(Results2BatchRes(results));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Results2BatchRes)->Arg(16)->Arg(256);
+
+// 写入调用方预分配的数组（predict(..., out=...)），对比 BM_Results2BatchRes，每次调用只检查数组、不创建数组
+void BM_WriteResults(benchmark::State& state) {
+    ensureInterpreter();
+    constexpr size_t                stride = 100;
+    size_t                          num    = static_cast<size_t>(state.range(0));
+    std::vector<trtyolo::DetectRes> results(num, makeResult<trtyolo::DetectRes>(stride));
+    py::array_t<float>              boxes({num * stride, size_t{4}});
+    py::array_t<float>              scores(num * stride);
+    py::array_t<int>                classes(num * stride);
+    auto                            out = py::make_tuple(boxes, scores, classes);
+
+    std::vector<int> counts;
+    for (auto _ : state) {
+        counts.clear();
+        WriteResults(results, PyTuple2OutArrays(out, num, stride, true), 0, counts);
+        benchmark::DoNotOptimize(counts.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WriteResults)->Arg(16)->Arg(256);
+
+// 掩码粘贴在 Python 包中实现（trtyolo.paste_masks_in_image），需要能导入 trtyolo 包
+void BM_PasteMasksInImage(benchmark::State& state) {
+    ensureInterpreter();
+    py::object paste;
+    try {
+        paste = py::module_::import("trtyolo").attr("paste_masks_in_image");
+    } catch (const py::error_already_set& e) {
+        state.SkipWithError("trtyolo Python package is not importable");
+        return;
+    }
+
+    auto result = makeResult<trtyolo::SegmentRes>(static_cast<int>(state.range(0)));
+    for (int i = 0; i < result.num; ++i) result.masks.emplace_back(160, 160);
+    auto masks = Masks2PyArray(result);
+    auto boxes = Boxes2PyArray(result, py::none());
+    auto shape = py::make_tuple(1080, 1920);
+
+    for (auto _ : state) benchmark::DoNotOptimize(paste(masks, boxes, shape));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PasteMasksInImage)->Arg(10)->Arg(100);
+
+}  // namespace
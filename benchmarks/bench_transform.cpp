@@ -0,0 +1,76 @@
+/**
+ * @file bench_transform.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 仿射变换和旋转框角点计算的基准测试
+ * @date 2025-07-10
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "infer/letterbox.hpp"
+#include "infer/trtyolo.hpp"
+
+namespace {
+
+// 尺寸不变时 update 直接返回，这是视频流的常见情况
+void BM_TransformUpdateCached(benchmark::State& state) {
+    trtyolo::Transform transform{};
+    transform.update(1920, 1080, 640, 640);
+    for (auto _ : state) {
+        transform.update(1920, 1080, 640, 640);
+        benchmark::DoNotOptimize(transform.meta);
+    }
+}
+BENCHMARK(BM_TransformUpdateCached);
+
+// 每次尺寸都变化时重新计算缩放比例和偏移量
+void BM_TransformUpdate(benchmark::State& state) {
+    trtyolo::Transform transform{};
+    int                width = 1920;
+    for (auto _ : state) {
+        transform.update(width, 1080, 640, 640);
+        width = width == 1920 ? 1280 : 1920;
+        benchmark::DoNotOptimize(transform.meta);
+    }
+}
+BENCHMARK(BM_TransformUpdate);
+
+void BM_TransformApply(benchmark::State& state) {
+    trtyolo::Transform transform{};
+    transform.update(1920, 1080, 640, 640);
+
+    std::vector<float> points(static_cast<size_t>(state.range(0)) * 2);
+    for (size_t i = 0; i < points.size(); ++i) points[i] = static_cast<float>(i % 640);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < points.size(); i += 2) {
+            float x, y;
+            transform.apply(points[i], points[i + 1], &x, &y);
+            benchmark::DoNotOptimize(x);
+            benchmark::DoNotOptimize(y);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformApply)->Arg(1)->Arg(100)->Arg(1000);
+
+void BM_RotatedBoxCorners(benchmark::State& state) {
+    std::vector<trtyolo::RotatedBox> boxes;
+    for (int i = 0; i < state.range(0); ++i) {
+        float offset = static_cast<float>(i % 500);
+        boxes.emplace_back(offset, offset, offset + 50.0f, offset + 30.0f, 0.01f * i);
+    }
+
+    for (auto _ : state) {
+        for (const auto& box : boxes) benchmark::DoNotOptimize(box.xyxyxyxy());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RotatedBoxCorners)->Arg(1)->Arg(100)->Arg(1000);
+
+}  // namespace
@@ -0,0 +1,96 @@
+#!/usr/bin/env python
+# -*-coding:utf-8 -*-
+# ==============================================================================
+# Copyright (c) 2025 laugh12321 Authors. All Rights Reserved.
+#
+# Licensed under the GNU General Public License v3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+# File    :   thread_scaling.py
+# Version :   6.4.0
+# Author  :   laugh12321
+# Contact :   laugh12321@vip.qq.com
+# Date    :   2025/07/12 10:20:00
+# Desc    :   Python 多线程吞吐量随线程数的变化，每个线程持有一个克隆
+# ==============================================================================
+import argparse
+import threading
+import time
+
+import numpy as np
+
+from trtyolo import TRTYOLO
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(description="Measure predict throughput as the number of Python threads grows.")
+    parser.add_argument("--engine", required=True, help="Path to the TensorRT engine file.")
+    parser.add_argument("--task", default=None, help="Task type, inferred from the engine when omitted.")
+    parser.add_argument("--threads", type=str, default="1,2,4,8", help="Comma separated thread counts to measure.")
+    parser.add_argument("--duration", type=float, default=5.0, help="Measurement duration per thread count in seconds.")
+    parser.add_argument("--size", type=str, default="1920x1080", help="Input image size as WxH.")
+    parser.add_argument("--wrapper", action="store_true", help="Call TRTYOLO.predict (including convert_to_sv) instead of the raw binding.")
+    return parser.parse_args()
+
+
+def worker(model, image, predict, stop, counts, index):
+    """在截止前循环推理，统计完成的次数"""
+    predict = model.predict if predict == "wrapper" else model._model.predict
+    count = 0
+    while not stop.is_set():
+        predict(image)
+        count += 1
+    counts[index] = count
+
+
+def measure(models, image, predict, duration):
+    """所有线程同时开始，持续 duration 秒，返回每秒完成的图像数量"""
+    stop = threading.Event()
+    counts = [0] * len(models)
+    threads = [threading.Thread(target=worker, args=(m, image, predict, stop, counts, i)) for i, m in enumerate(models)]
+
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    time.sleep(duration)
+    stop.set()
+    for t in threads:
+        t.join()
+    elapsed = time.perf_counter() - start
+    return sum(counts) / elapsed
+
+
+def main():
+    args = parse_arguments()
+    width, height = (int(v) for v in args.size.split("x"))
+    thread_counts = [int(n) for n in args.threads.split(",")]
+    predict = "wrapper" if args.wrapper else "binding"
+
+    model = TRTYOLO(args.engine, task=args.task, swap_rb=True)
+    models = [model] + [model.clone() for _ in range(max(thread_counts) - 1)]
+    image = np.random.default_rng(0).integers(0, 256, (height, width, 3), dtype=np.uint8)
+
+    # 预热，避免首次推理的初始化开销计入结果
+    for m in models:
+        m._model.predict(image)
+
+    print(f"Engine: {args.engine}, input {width}x{height}, predict via {predict}")
+    print(f"{'threads':>8} {'images/s':>10} {'speedup':>8}")
+    baseline = None
+    for n in thread_counts:
+        throughput = measure(models[:n], image, predict, args.duration)
+        baseline = baseline or throughput
+        print(f"{n:>8} {throughput:>10.1f} {throughput / baseline:>7.2f}x")
+
+
+if __name__ == '__main__':
+    main()
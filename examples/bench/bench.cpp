@@ -0,0 +1,436 @@
+/**
+ * @file bench.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief trtyolo-bench 压测工具：闭环/开环（泊松到达）负载，支持图像尺寸混合，报告吞吐量和延迟分位数
+ * @date 2025-07-11
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trtyolo.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// 一个工作线程独占的推理后端，返回本次请求检测到的目标总数
+using Backend = std::function<size_t(const std::vector<trtyolo::Image>&)>;
+
+struct Options {
+    std::vector<std::string>         engines;                 // < 引擎文件，多个时构建为引擎族
+    std::string                      task        = "detect";  // < 任务类型
+    std::string                      replay;                  // < 捕获文件，非空时使用重放后端
+    double                           mock_ms     = 0.0;       // < 重放/模拟后端每次请求额外等待的时间（毫秒）
+    int                              concurrency = 1;         // < 闭环：并发请求数；开环：工作线程数
+    double                           rate        = 0.0;       // < 开环到达率（请求/秒），0 表示闭环
+    int                              batch       = 1;         // < 每个请求的图像数量
+    double                           duration    = 10.0;      // < 测量时长（秒）
+    double                           warmup      = 2.0;       // < 预热时长（秒），预热期间的请求不计入统计
+    size_t                           max_queue   = 10000;     // < 开环队列上限，超过时丢弃请求
+    unsigned                         seed        = 42;        // < 随机数种子
+    std::vector<std::pair<int, int>> sizes{{1920, 1080}};     // < 图像尺寸（宽、高）
+    std::vector<double>              weights{1.0};            // < 各尺寸的权重
+};
+
+struct Sample {
+    double   latency_ms;  // < 从到达（闭环为发出）到完成的时间
+    uint32_t size_index;  // < 图像尺寸下标
+};
+
+struct Request {
+    Clock::time_point arrival;     // < 计划到达时间
+    uint32_t          size_index;  // < 图像尺寸下标
+};
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " (--engine <file>[,<file>...] [--task <task>] | --replay <capture_file> | --mock-ms <ms>) [options]\n"
+              << "  --task <task>          classify, detect, obb, segment, pose (default: detect)\n"
+              << "  --replay <file>        replay backend: re-run postprocessing on records of a capture file\n"
+              << "  --mock-ms <ms>         extra service time per request for the replay/mock backend\n"
+              << "  --concurrency <n>      closed loop: in-flight requests; open loop: worker threads (default: 1)\n"
+              << "  --rate <req/s>         open loop with Poisson arrivals at this mean rate (default: closed loop)\n"
+              << "  --batch <n>            images per request (default: 1)\n"
+              << "  --sizes <WxH[:w],...>  image size mix with optional weights (default: 1920x1080)\n"
+              << "  --duration <s>         measurement duration (default: 10)\n"
+              << "  --warmup <s>           warmup duration excluded from statistics (default: 2)\n"
+              << "  --max-queue <n>        open loop queue limit, requests beyond it are dropped (default: 10000)\n"
+              << "  --seed <n>             random seed (default: 42)\n"
+              << "e.g: " << program << " --engine yolo11n.engine --rate 200 --concurrency 4 --sizes 1920x1080:1,640x480:3" << std::endl;
+}
+
+std::vector<std::string> split(const std::string& text, char delimiter) {
+    std::vector<std::string> items;
+    std::stringstream        stream(text);
+    for (std::string item; std::getline(stream, item, delimiter);) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// 解析 WxH[:weight] 列表
+void parseSizes(const std::string& text, Options& options) {
+    options.sizes.clear();
+    options.weights.clear();
+    for (const auto& item : split(text, ',')) {
+        int    width = 0, height = 0;
+        double weight = 1.0;
+        char   x = 0, colon = 0;
+
+        std::stringstream stream(item);
+        stream >> width >> x >> height;
+        if (!stream.eof()) stream >> colon >> weight;
+        if (stream.fail() || x != 'x' || width <= 0 || height <= 0 || weight <= 0.0 || (colon && colon != ':')) {
+            throw std::invalid_argument("Invalid size '" + item + "', expected WxH or WxH:weight");
+        }
+        options.sizes.emplace_back(width, height);
+        options.weights.push_back(weight);
+    }
+    if (options.sizes.empty()) throw std::invalid_argument("--sizes must not be empty");
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + key);
+        std::string value = argv[++i];
+
+        if (key == "--engine") options.engines = split(value, ',');
+        else if (key == "--task") options.task = value;
+        else if (key == "--replay") options.replay = value;
+        else if (key == "--mock-ms") options.mock_ms = std::stod(value);
+        else if (key == "--concurrency") options.concurrency = std::stoi(value);
+        else if (key == "--rate") options.rate = std::stod(value);
+        else if (key == "--batch") options.batch = std::stoi(value);
+        else if (key == "--sizes") parseSizes(value, options);
+        else if (key == "--duration") options.duration = std::stod(value);
+        else if (key == "--warmup") options.warmup = std::stod(value);
+        else if (key == "--max-queue") options.max_queue = std::stoul(value);
+        else if (key == "--seed") options.seed = static_cast<unsigned>(std::stoul(value));
+        else throw std::invalid_argument("Unknown option " + key);
+    }
+
+    if (options.engines.empty() && options.replay.empty() && options.mock_ms <= 0.0) {
+        throw std::invalid_argument("One of --engine, --replay or --mock-ms is required");
+    }
+    if (options.concurrency < 1 || options.batch < 1 || options.duration <= 0.0 || options.warmup < 0.0 || options.rate < 0.0) {
+        throw std::invalid_argument("--concurrency and --batch must be >= 1, --duration > 0, --warmup and --rate >= 0");
+    }
+    return options;
+}
+
+template <typename Results>
+size_t countObjects(const Results& results) {
+    size_t num = 0;
+    for (const auto& result : results) num += result.num;
+    return num;
+}
+
+// 加载引擎并为每个工作线程克隆一个模型，克隆共享引擎权重
+template <typename ModelType>
+std::vector<Backend> makeEngineBackends(const Options& options) {
+    auto infer_option = trtyolo::InferOption();
+    infer_option.enableSwapRB();
+
+    auto model = std::make_shared<ModelType>(options.engines, infer_option);
+
+    std::vector<Backend> backends;
+    for (int i = 0; i < options.concurrency; ++i) {
+        std::shared_ptr<ModelType> clone = i == 0 ? model : std::shared_ptr<ModelType>(model->clone());
+        backends.emplace_back([model, clone](const std::vector<trtyolo::Image>& images) { return countObjects(clone->predict(images)); });
+    }
+    return backends;
+}
+
+// 重放/模拟后端：轮流重放捕获文件中的记录（不需要 GPU），并按需额外等待模拟推理耗时
+std::vector<Backend> makeMockBackends(const Options& options) {
+    std::shared_ptr<trtyolo::CaptureReader> reader;
+    if (!options.replay.empty()) {
+        reader = std::make_shared<trtyolo::CaptureReader>(options.replay);
+        if (reader->size() == 0) throw std::runtime_error("No complete records in " + options.replay);
+    }
+
+    auto service = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(options.mock_ms));
+    auto next    = std::make_shared<std::atomic<size_t>>(0);
+
+    Backend backend = [reader, service, next](const std::vector<trtyolo::Image>&) -> size_t {
+        if (service.count() > 0) std::this_thread::sleep_for(service);
+        if (!reader) return 0;
+
+        size_t index = next->fetch_add(1, std::memory_order_relaxed) % reader->size();
+        switch (reader->task(index)) {
+            case trtyolo::TaskType::Classify:
+                return countObjects(reader->replayClassify(index));
+            case trtyolo::TaskType::Detect:
+                return countObjects(reader->replayDetect(index));
+            case trtyolo::TaskType::OBB:
+                return countObjects(reader->replayOBB(index));
+            case trtyolo::TaskType::Segment:
+                return countObjects(reader->replaySegment(index));
+            case trtyolo::TaskType::Pose:
+                return countObjects(reader->replayPose(index));
+            default:
+                return 0;
+        }
+    };
+    return std::vector<Backend>(options.concurrency, backend);
+}
+
+std::vector<Backend> makeBackends(const Options& options) {
+    if (options.engines.empty()) return makeMockBackends(options);
+
+    if (options.task == "classify") return makeEngineBackends<trtyolo::ClassifyModel>(options);
+    if (options.task == "detect") return makeEngineBackends<trtyolo::DetectModel>(options);
+    if (options.task == "obb") return makeEngineBackends<trtyolo::OBBModel>(options);
+    if (options.task == "segment") return makeEngineBackends<trtyolo::SegmentModel>(options);
+    if (options.task == "pose") return makeEngineBackends<trtyolo::PoseModel>(options);
+    throw std::invalid_argument("Unknown task '" + options.task + "'");
+}
+
+// 每种尺寸生成一帧随机噪声图像，所有请求共享（只读）
+std::vector<std::vector<uint8_t>> makeFrames(const Options& options) {
+    std::mt19937                       rng(options.seed);
+    std::uniform_int_distribution<int> pixel(0, 255);
+
+    std::vector<std::vector<uint8_t>> frames;
+    for (const auto& [width, height] : options.sizes) {
+        std::vector<uint8_t> frame(static_cast<size_t>(width) * height * 3);
+        for (auto& value : frame) value = static_cast<uint8_t>(pixel(rng));
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+class LoadRunner {
+public:
+    LoadRunner(const Options& options, std::vector<Backend> backends)
+        : options_(options), backends_(std::move(backends)), frames_(makeFrames(options)), samples_(backends_.size()), objects_(backends_.size(), 0) {}
+
+    void run() {
+        start_   = Clock::now();
+        measure_ = start_ + seconds(options_.warmup);
+        end_     = measure_ + seconds(options_.duration);
+
+        // 任一线程出错时停止压测，所有线程结束后在调用线程中重新抛出第一个异常
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < backends_.size(); ++i) {
+            threads.emplace_back([this, i] {
+                try {
+                    options_.rate > 0.0 ? openWorker(i) : closedWorker(i);
+                } catch (...) {
+                    fail(std::current_exception());
+                }
+            });
+        }
+        if (options_.rate > 0.0) {
+            try {
+                generate();
+            } catch (...) {
+                fail(std::current_exception());
+            }
+        }
+        for (auto& thread : threads) thread.join();
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    void report() const {
+        std::vector<Sample> samples;
+        size_t              objects = 0;
+        for (size_t i = 0; i < samples_.size(); ++i) {
+            samples.insert(samples.end(), samples_[i].begin(), samples_[i].end());
+            objects += objects_[i];
+        }
+
+        std::cout << std::fixed << std::setprecision(2);
+        if (options_.rate > 0.0) {
+            std::cout << "Mode: open loop, Poisson arrivals at " << options_.rate << " req/s, " << backends_.size() << " workers";
+        } else {
+            std::cout << "Mode: closed loop, concurrency " << backends_.size();
+        }
+        std::cout << ", batch " << options_.batch << std::endl;
+
+        if (samples.empty()) {
+            std::cout << "No requests completed in the measurement window." << std::endl;
+            return;
+        }
+
+        double elapsed = std::chrono::duration<double>(last_done_.load() - measure_).count();
+        std::cout << "Requests: " << samples.size() << ", Dropped: " << dropped_ << ", Images: " << samples.size() * options_.batch
+                  << ", Objects: " << objects << std::endl;
+        std::cout << "Throughput: " << samples.size() / elapsed << " req/s, " << samples.size() * options_.batch / elapsed << " images/s" << std::endl;
+        if (options_.rate > 0.0) std::cout << "Max queue depth: " << max_depth_ << std::endl;
+
+        printLatency("Latency (ms)", samples);
+        if (options_.sizes.size() > 1) {
+            for (uint32_t s = 0; s < options_.sizes.size(); ++s) {
+                std::vector<Sample> subset;
+                std::copy_if(samples.begin(), samples.end(), std::back_inserter(subset), [s](const Sample& sample) { return sample.size_index == s; });
+                if (subset.empty()) continue;
+                printLatency("  " + std::to_string(options_.sizes[s].first) + "x" + std::to_string(options_.sizes[s].second), subset);
+            }
+        }
+    }
+
+private:
+    static Clock::duration seconds(double value) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(value));
+    }
+
+    static void printLatency(const std::string& label, std::vector<Sample> samples) {
+        std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.latency_ms < b.latency_ms; });
+        auto percentile = [&](double p) { return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))].latency_ms; };
+
+        double total = 0.0;
+        for (const auto& sample : samples) total += sample.latency_ms;
+
+        std::cout << label << ": n " << samples.size() << ", mean " << total / samples.size() << ", p50 " << percentile(0.50)
+                  << ", p90 " << percentile(0.90) << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999)
+                  << ", max " << samples.back().latency_ms << std::endl;
+    }
+
+    std::vector<trtyolo::Image> makeImages(uint32_t size_index) const {
+        auto [width, height] = options_.sizes[size_index];
+        auto* data           = const_cast<uint8_t*>(frames_[size_index].data());
+        return std::vector<trtyolo::Image>(options_.batch, trtyolo::Image(data, width, height));
+    }
+
+    // 记录第一个异常并停止所有线程：生成线程不再发出请求，工作线程丢弃队列中的请求后退出
+    void fail(std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::move(error);
+            queue_.clear();
+            stopped_ = true;  // 在锁内设置，避免工作线程检查条件后、进入等待前错过通知
+        }
+        cv_.notify_all();
+    }
+
+    // 执行一个请求，到达时间晚于预热结束的请求计入统计
+    void serve(size_t worker, const Request& request) {
+        size_t objects = backends_[worker](makeImages(request.size_index));
+        auto   done    = Clock::now();
+        if (request.arrival < measure_) return;
+
+        samples_[worker].push_back({std::chrono::duration<double, std::milli>(done - request.arrival).count(), request.size_index});
+        objects_[worker] += objects;
+
+        auto last = last_done_.load();
+        while (last < done && !last_done_.compare_exchange_weak(last, done)) {}
+    }
+
+    // 闭环：每个工作线程完成一个请求后立即发出下一个
+    void closedWorker(size_t worker) {
+        std::mt19937                    rng(options_.seed + static_cast<unsigned>(worker));
+        std::discrete_distribution<int> pick(options_.weights.begin(), options_.weights.end());
+        while (!stopped_ && Clock::now() < end_) serve(worker, {Clock::now(), static_cast<uint32_t>(pick(rng))});
+    }
+
+    // 开环：工作线程从队列中取出请求，延迟从计划到达时间算起，包含排队时间
+    void openWorker(size_t worker) {
+        while (true) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return !queue_.empty() || finished_ || stopped_; });
+                if (stopped_ || queue_.empty()) return;
+                request = queue_.front();
+                queue_.pop_front();
+            }
+            serve(worker, request);
+        }
+    }
+
+    // 按泊松过程（指数分布的到达间隔）生成请求，不受服务端处理速度影响
+    void generate() {
+        std::mt19937                    rng(options_.seed);
+        std::exponential_distribution<> interval(options_.rate);
+        std::discrete_distribution<int> pick(options_.weights.begin(), options_.weights.end());
+
+        for (auto arrival = start_; arrival < end_ && !stopped_; arrival += seconds(interval(rng))) {
+            std::this_thread::sleep_until(arrival);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (queue_.size() >= options_.max_queue) {
+                    if (arrival >= measure_) ++dropped_;
+                    continue;
+                }
+                queue_.push_back({arrival, static_cast<uint32_t>(pick(rng))});
+                max_depth_ = std::max(max_depth_, queue_.size());
+            }
+            cv_.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    const Options&                    options_;   // < 压测参数
+    std::vector<Backend>              backends_;  // < 每个工作线程一个后端
+    std::vector<std::vector<uint8_t>> frames_;    // < 每种尺寸的图像
+    std::vector<std::vector<Sample>>  samples_;   // < 每个工作线程的延迟样本
+    std::vector<size_t>               objects_;   // < 每个工作线程检测到的目标数量
+    Clock::time_point                 start_;     // < 开始时间
+    Clock::time_point                 measure_;   // < 预热结束、开始统计的时间
+    Clock::time_point                 end_;       // < 停止发出请求的时间
+    std::atomic<Clock::time_point>    last_done_{Clock::time_point{}};  // < 最后一个计入统计的请求的完成时间
+    std::atomic<bool>                 stopped_{false};                  // < 是否因出错而停止
+
+    std::mutex              mutex_;              // < 保护开环请求队列
+    std::condition_variable cv_;                 // < 通知工作线程有新请求
+    std::deque<Request>     queue_;              // < 开环请求队列
+    bool                    finished_  = false;  // < 是否已停止生成请求
+    size_t                  dropped_   = 0;      // < 队列已满时丢弃的请求数量
+    size_t                  max_depth_ = 0;      // < 开环队列的最大深度
+    std::exception_ptr      error_;              // < 第一个出错线程的异常
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return -1;
+    }
+
+    try {
+        Options options  = parseOptions(argc, argv);
+        auto    backends = makeBackends(options);
+
+        if (options.engines.empty()) {
+            std::cout << "Backend: " << (options.replay.empty() ? "mock" : "replay " + options.replay);
+            if (options.mock_ms > 0.0) std::cout << " (+" << options.mock_ms << " ms per request)";
+        } else {
+            std::cout << "Backend: engine " << options.engines.front() << " (" << options.task << ")";
+        }
+        std::cout << std::endl;
+
+        LoadRunner runner(options, std::move(backends));
+        runner.run();
+        runner.report();
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return -1;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
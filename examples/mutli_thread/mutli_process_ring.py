@@ -0,0 +1,84 @@
+#!/usr/bin/env python
+# -*-coding:utf-8 -*-
+# ==============================================================================
+# Copyright (c) 2025 laugh12321 Authors. All Rights Reserved.
+#
+# Licensed under the GNU General Public License v3.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.gnu.org/licenses/gpl-3.0.html
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+# File    :   mutli_process_ring.py
+# Version :   6.4.0
+# Author  :   laugh12321
+# Contact :   laugh12321@vip.qq.com
+# Date    :   2025/07/15 10:30:00
+# Desc    :   多进程共享内存帧环示例：主进程托管一份引擎，多个生产者进程提交图像
+# ==============================================================================
+import argparse
+import time
+from multiprocessing import Pool
+from pathlib import Path
+
+import cv2
+
+from trtyolo import c_lib_wrap as C
+from trtyolo import convert_to_sv
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(description="Multi-process inference through a shared-memory frame ring.")
+    parser.add_argument("--engine", required=True, help="Path to the TensorRT engine file.")
+    parser.add_argument("--image_path", type=str, required=True, help="Directory or file list of images to predict.")
+    parser.add_argument("--process_num", type=int, default=4, help="Number of producer processes.")
+    parser.add_argument("--workers", type=int, default=1, help="Number of inference threads (model clones) in the server.")
+    parser.add_argument("--name", type=str, default="/trtyolo_ring", help="Name of the shared memory segment.")
+    return parser.parse_args()
+
+
+def produce(name, image_files):
+    """生产者进程：读取图像并提交到帧环，不加载引擎"""
+    client = C.ring.FrameRingClient(name)
+    count = 0
+    for image_file in image_files:
+        image = cv2.imread(str(image_file))
+        if image is None or image.shape[1] > client.max_width or image.shape[0] > client.max_height:
+            continue
+        detections = convert_to_sv(client.predict(image), image.shape[:2])
+        count += len(detections)
+    return count
+
+
+def main():
+    args = parse_arguments()
+    image_files = [args.image_path] if Path(args.image_path).is_file() else list(Path(args.image_path).glob("**/*.jpg"))
+
+    option = C.option.InferOption()
+    option.enable_swap_rb()
+    options = C.ring.FrameRingOptions()
+    options.workers = args.workers
+
+    # 服务端在主进程中托管模型，生产者进程退出后停止
+    server = C.ring.FrameRingServer(args.name, "detect", [args.engine], option, options)
+    start_time = time.time()
+    try:
+        shards = [image_files[i :: args.process_num] for i in range(args.process_num)]
+        with Pool(args.process_num) as pool:
+            counts = pool.starmap(produce, [(args.name, shard) for shard in shards])
+    finally:
+        server.stop()
+    end_time = time.time()
+
+    print(f"Objects: {sum(counts)}, Frames: {server.frames}, Mean batch: {server.frames / max(server.batches, 1):.2f}")
+    print(f"Total time: {end_time - start_time:.2f} seconds")
+
+
+if __name__ == '__main__':
+    main()
@@ -68,11 +68,7 @@ void predict(trtyolo::DetectModel* model, int thread_id, const std::vector<std::
         auto results = model->predict(img_batch);
     }
 
-    auto [throughput_str, gpu_latency_str, cpu_latency_str] = model->performanceReport();
-
-    std::cout << "Thread Id: " << thread_id << ", Throughput: " << throughput_str << std::endl;
-    std::cout << "Thread Id: " << thread_id << ", GPU Latency: " << gpu_latency_str << std::endl;
-    std::cout << "Thread Id: " << thread_id << ", CPU Latency: " << cpu_latency_str << std::endl;
+    std::cout << "Thread Id: " << thread_id << " processed " << image_paths.size() << " images." << std::endl;
 }
 
 int main(int argc, char** argv) {
@@ -129,5 +125,11 @@ int main(int argc, char** argv) {
     }
 
     std::cout << "All threads completed successfully." << std::endl;
+
+    // 克隆共享性能统计，所有线程结束后读取一次即覆盖全部线程
+    auto [throughput_str, gpu_latency_str, cpu_latency_str] = model.performanceReport();
+    std::cout << throughput_str << std::endl;
+    std::cout << gpu_latency_str << std::endl;
+    std::cout << cpu_latency_str << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+/**
+ * @file replay.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 捕获文件离线重放示例：不需要 GPU 和引擎，重新执行后处理并统计耗时
+ * @date 2025-07-08
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "trtyolo.hpp"
+
+// 重放一条记录，返回检测到的目标总数
+size_t replay(const trtyolo::CaptureReader& reader, size_t index) {
+    auto count = [](const auto& results) {
+        size_t num = 0;
+        for (const auto& result : results) num += result.num;
+        return num;
+    };
+
+    switch (reader.task(index)) {
+        case trtyolo::TaskType::Classify:
+            return count(reader.replayClassify(index));
+        case trtyolo::TaskType::Detect:
+            return count(reader.replayDetect(index));
+        case trtyolo::TaskType::OBB:
+            return count(reader.replayOBB(index));
+        case trtyolo::TaskType::Segment:
+            return count(reader.replaySegment(index));
+        case trtyolo::TaskType::Pose:
+            return count(reader.replayPose(index));
+        default:
+            return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <capture_file> [repeat]" << std::endl;
+        std::cerr << "e.g: ./replay ./predict.trtycap 10" << std::endl;
+        return -1;
+    }
+
+    // 解析命令行参数
+    std::string capture_file = argv[1];
+    int         repeat       = argc == 3 ? std::max(1, std::atoi(argv[2])) : 1;
+
+    trtyolo::CaptureReader reader(capture_file);
+    if (reader.size() == 0) {
+        std::cerr << "No complete records in " << capture_file << std::endl;
+        return -1;
+    }
+
+    // 汇总记录信息
+    size_t                     images = 0, frames = 0;
+    std::map<std::string, int> tasks;
+    for (size_t i = 0; i < reader.size(); ++i) {
+        auto record  = reader.record(i);
+        images      += record.frames.size();
+        frames      += std::count_if(record.frames.begin(), record.frames.end(), [](const auto& frame) { return !frame.data.empty(); });
+        tasks[trtyolo::taskTypeToString(record.task)]++;
+    }
+
+    std::cout << "Records: " << reader.size() << ", Images: " << images << ", Stored frames: " << frames << std::endl;
+    for (const auto& [task, num] : tasks) std::cout << "  " << task << ": " << num << " records" << std::endl;
+
+    // 重复重放所有记录，统计每条记录的后处理耗时
+    std::vector<double> latencies;
+    latencies.reserve(reader.size() * repeat);
+    size_t objects = 0;
+    for (int r = 0; r < repeat; ++r) {
+        for (size_t i = 0; i < reader.size(); ++i) {
+            auto   start = std::chrono::steady_clock::now();
+            size_t num   = replay(reader, i);
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            if (r == 0) objects += num;
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))]; };
+
+    double total = 0.0;
+    for (double latency : latencies) total += latency;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Replayed " << latencies.size() << " records, " << objects << " objects per pass" << std::endl;
+    std::cout << "Postprocess latency (us): mean " << total / latencies.size() << ", p50 " << percentile(0.50)
+              << ", p90 " << percentile(0.90) << ", p99 " << percentile(0.99) << ", max " << latencies.back() << std::endl;
+    std::cout << "Throughput: " << images * repeat / (total / 1e6) << " images/s" << std::endl;
+    return 0;
+}
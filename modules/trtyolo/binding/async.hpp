@@ -0,0 +1,199 @@
+/**
+ * @file async.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief asyncio 推理支持：后台线程执行推理，通过 loop.call_soon_threadsafe 完成 asyncio.Future
+ * @date 2025-07-13
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ */
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "infer/trtyolo.hpp"
+
+namespace py = pybind11;
+
+/**
+ * @brief 后台推理线程，按提交顺序执行任务
+ *
+ * 每个 Python 模型对象对应一个线程：同一对象上的请求依次执行，不同克隆的请求并行执行。
+ * 析构时执行完队列中剩余的任务后退出，调用方不能持有 GIL。
+ */
+class AsyncWorker {
+public:
+    AsyncWorker() : thread_([this] { run(); }) {}
+
+    ~AsyncWorker() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    AsyncWorker(const AsyncWorker&)            = delete;
+    AsyncWorker& operator=(const AsyncWorker&) = delete;
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex                        mutex_;         // < 保护任务队列
+    std::condition_variable           cv_;            // < 通知有新任务或停止
+    std::deque<std::function<void()>> tasks_;         // < 待执行的任务
+    bool                              stop_ = false;  // < 是否停止
+    std::thread                       thread_;        // < 工作线程，最后初始化
+};
+
+/**
+ * @brief 获取 Python 模型对象的后台推理线程，不存在时创建
+ *
+ * 线程在模型对象被回收或解释器退出时停止。只能在持有 GIL 时调用。
+ *
+ * @param model Python 模型对象
+ * @return AsyncWorker& 后台推理线程
+ */
+inline AsyncWorker& GetAsyncWorker(const py::object& model) {
+    // 有意不析构：进程退出时 Python 已经终止，由 atexit 回调提前停止所有线程
+    static auto* workers = new std::unordered_map<PyObject*, std::unique_ptr<AsyncWorker>>();
+
+    // 停止线程时释放 GIL，让剩余任务能够完成各自的 Future
+    auto stop = [](std::unique_ptr<AsyncWorker> worker) {
+        py::gil_scoped_release release;
+        worker.reset();
+    };
+
+    static bool registered = false;
+    if (!registered) {
+        registered = true;
+        py::module_::import("atexit").attr("register")(py::cpp_function([stop]() {
+            while (!workers->empty()) {
+                auto worker = std::move(workers->begin()->second);
+                workers->erase(workers->begin());
+                stop(std::move(worker));
+            }
+        }));
+    }
+
+    auto it = workers->find(model.ptr());
+    if (it != workers->end()) return *it->second;
+
+    // 模型对象被回收时停止对应的线程，弱引用在回调中释放
+    py::cpp_function cleanup([key = model.ptr(), stop](py::handle weakref) {
+        auto found = workers->find(key);
+        if (found != workers->end()) {
+            auto worker = std::move(found->second);
+            workers->erase(found);
+            stop(std::move(worker));
+        }
+        weakref.dec_ref();
+    });
+    py::weakref(model, cleanup).release();
+
+    return *workers->emplace(model.ptr(), std::make_unique<AsyncWorker>()).first->second;
+}
+
+/**
+ * @brief 将 C++ 异常转换为对应的 Python 异常对象
+ */
+inline py::object Exception2PyObject(const std::exception_ptr& error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::invalid_argument& e) {
+        return py::reinterpret_borrow<py::object>(PyExc_ValueError)(e.what());
+    } catch (const std::out_of_range& e) {
+        return py::reinterpret_borrow<py::object>(PyExc_IndexError)(e.what());
+    } catch (const std::exception& e) {
+        return py::reinterpret_borrow<py::object>(PyExc_RuntimeError)(e.what());
+    } catch (...) {
+        return py::reinterpret_borrow<py::object>(PyExc_RuntimeError)("Unknown error in predict_async");
+    }
+}
+
+/**
+ * @brief 在后台线程中推理，返回当前事件循环中的 asyncio.Future
+ *
+ * 推理和后处理期间不持有 GIL，事件循环线程不会被阻塞；完成后获取 GIL 转换结果，
+ * 再通过 loop.call_soon_threadsafe 在事件循环线程中设置 Future 的结果或异常。
+ * Future 已被取消时结果会被丢弃。必须在运行中的事件循环内调用。
+ *
+ * @tparam ModelType 模型类型
+ * @param self Python 模型对象
+ * @param images 输入图像，指向 inputs 中的内存
+ * @param inputs 输入数组，推理结束前保持存活
+ * @param batch 为 true 时 Future 的结果为列表，否则为单个结果
+ * @return py::object asyncio.Future
+ */
+template <typename ModelType>
+py::object PredictAsync(const py::object& self, std::vector<trtyolo::Image> images, py::object inputs, bool batch) {
+    struct State {
+        py::object loop;    // < 调用方的事件循环
+        py::object future;  // < 返回给调用方的 Future
+        py::object inputs;  // < 输入数组
+    };
+
+    auto  loop   = py::module_::import("asyncio").attr("get_running_loop")();
+    auto  state  = std::make_shared<State>(State{loop, loop.attr("create_future")(), std::move(inputs)});
+    auto  model  = self.cast<std::shared_ptr<ModelType>>();
+    auto& worker = GetAsyncWorker(self);
+
+    worker.submit([model, images = std::move(images), state, batch]() mutable {
+        decltype(model->predict(images)) results;
+        std::exception_ptr               error;
+        try {
+            results = model->predict(images);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        py::gil_scoped_acquire acquire;
+        try {
+            py::object value = error ? Exception2PyObject(error) : batch ? py::cast(std::move(results)) : py::cast(std::move(results.front()));
+            py::cpp_function settle([](const py::object& future, const py::object& value, bool failed) {
+                if (future.attr("done")().cast<bool>()) return;  // 已被取消
+                future.attr(failed ? "set_exception" : "set_result")(value);
+            });
+            state->loop.attr("call_soon_threadsafe")(settle, state->future, value, static_cast<bool>(error));
+        } catch (py::error_already_set& e) {
+            e.discard_as_unraisable("predict_async");  // 事件循环已关闭
+        }
+        state.reset();  // 在持有 GIL 时释放 Python 对象
+    });
+
+    return state->future;
+}
@@ -0,0 +1,385 @@
+/**
+ * @file convert.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief NumPy 数组与 trtyolo 图像、结果之间的转换，供 Python 绑定和基准测试共用
+ * @date 2025-07-10
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ */
+
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "infer/trtyolo.hpp"
+
+namespace py = pybind11;
+
+/**
+ * @brief 将NumPy数组转换为trtyolo::Image对象。
+ *
+ * 此函数会把一个形状为(height, width, channels)、数据类型为uint8的3D NumPy数组，
+ * 转换为trtyolo::Image对象，该对象可用于后续的推理任务。
+ * 函数会检查输入数组的维度和通道数，若输入数组不是3维，或者第三维通道数不为3，
+ * 则抛出 std::invalid_argument 异常。
+ *
+ * @param src 输入的NumPy数组，要求形状为(height, width, channels)，数据类型为uint8。
+ * @return trtyolo::Image 转换后的可用于推理的图像对象。
+ * @throws std::invalid_argument 当输入数组不是3维，或者第三维通道数不为3时抛出此异常。
+ */
+inline trtyolo::Image PyArray2Image(const py::array_t<uint8_t>& src) {
+    py::buffer_info buf = src.request();
+    if (buf.ndim != 3 || buf.shape[2] != 3) {
+        throw std::invalid_argument("Require rank of array to be 3 with HWC format while converting it to trtyolo::Image.");
+    }
+
+    return trtyolo::Image(buf.ptr, buf.shape[1], buf.shape[0], buf.shape[2], buf.strides[0]);
+}
+
+/**
+ * @brief 将形状为(N, height, width, channels)的4D NumPy数组映射为一组trtyolo::Image对象，不拷贝像素。
+ *
+ * 每张图像直接指向数组中对应的内存，支持批量维度和行方向带步长的视图（如 `batch[::2]`、`batch[:, :h, :w]`）。
+ * 连续数组中的图像首尾相接，后端暂存时整个批量只需要一次 memcpy。
+ * 像素或通道不是紧密排列时（如 `batch[..., ::-1]`），src 会被替换为一份连续拷贝，
+ * 调用方需要在推理结束前持有 src。
+ *
+ * @param src 输入的NumPy数组，要求形状为(N, height, width, 3)，数据类型为uint8
+ * @return std::vector<trtyolo::Image> 批量中的每张图像
+ * @throws std::invalid_argument 当输入数组不是4维、第四维通道数不为3或数据类型不是uint8时抛出此异常。
+ */
+inline std::vector<trtyolo::Image> PyArray2Images(py::array& src) {
+    if (src.ndim() != 4 || src.shape(3) != 3 || !py::isinstance<py::array_t<uint8_t>>(src)) {
+        throw std::invalid_argument("Require a uint8 array of shape (N, H, W, 3) while converting it to a batch of trtyolo::Image.");
+    }
+    if (src.strides(3) != 1 || src.strides(2) != 3 || src.strides(1) < src.shape(2) * 3 || src.strides(0) < 0) {
+        src = py::array_t<uint8_t, py::array::c_style>::ensure(src);
+    }
+
+    auto* data = static_cast<uint8_t*>(const_cast<void*>(src.data()));  // 只读数组同样可以作为输入
+    int   num = static_cast<int>(src.shape(0)), height = static_cast<int>(src.shape(1)), width = static_cast<int>(src.shape(2));
+
+    std::vector<trtyolo::Image> images;
+    images.reserve(num);
+    for (int i = 0; i < num; ++i) images.emplace_back(data + i * src.strides(0), width, height, 3, static_cast<size_t>(src.strides(1)));
+    return images;
+}
+
+static_assert(sizeof(trtyolo::Box) == 4 * sizeof(float) && sizeof(trtyolo::RotatedBox) == 5 * sizeof(float),
+              "Box coordinates must be packed floats to be exposed as NumPy views");
+
+/**
+ * @brief 创建指向结果内部存储的NumPy视图，不拷贝数据
+ *
+ * 视图以 owner（Python 中的结果对象）为 base，视图存活期间结果对象不会被释放。
+ *
+ * @param owner 持有数据的Python对象
+ * @param data 数据指针
+ * @param shape 视图形状
+ * @param strides 视图步长（字节）
+ */
+template <typename T>
+py::array ResultView(py::handle owner, const T* data, std::vector<py::ssize_t> shape, std::vector<py::ssize_t> strides) {
+    if (shape.front() == 0) return py::array(py::dtype::of<T>(), std::move(shape), std::move(strides));
+    return py::array(py::dtype::of<T>(), std::move(shape), std::move(strides), data, owner);
+}
+
+/**
+ * @brief 将类别ID转换为形状为(n,)的NumPy数组，直接指向结果中的数据
+ */
+inline py::array Classes2PyArray(const trtyolo::BaseRes& r, py::handle owner) {
+    return ResultView(owner, r.classes.data(), {static_cast<py::ssize_t>(r.classes.size())}, {sizeof(int)});
+}
+
+/**
+ * @brief 将置信度转换为形状为(n,)的float32 NumPy数组，直接指向结果中的数据
+ */
+inline py::array Scores2PyArray(const trtyolo::BaseRes& r, py::handle owner) {
+    return ResultView(owner, r.scores.data(), {static_cast<py::ssize_t>(r.scores.size())}, {sizeof(float)});
+}
+
+/**
+ * @brief 将边界框转换为形状为(n, 4)的float32 NumPy数组，格式为[x1, y1, x2, y2]，直接指向结果中的数据
+ */
+template <typename ResultType>
+py::array Boxes2PyArray(const ResultType& r, py::handle owner) {
+    using BoxType     = typename decltype(r.boxes)::value_type;
+    const float* data = r.boxes.empty() ? nullptr : &r.boxes.front().left;
+    return ResultView(owner, data, {static_cast<py::ssize_t>(r.boxes.size()), 4}, {sizeof(BoxType), sizeof(float)});
+}
+
+/**
+ * @brief 将旋转框转换为形状为(n, 4, 2)的float32 NumPy数组，格式为[[x1, y1], [x2, y2], [x3, y3], [x4, y4]]
+ */
+inline py::array RotatedBoxes2PyArray(const trtyolo::OBBRes& r) {
+    py::array_t<float> array({r.boxes.size(), size_t{4}, size_t{2}});
+    float*             ptr = array.mutable_data();
+    for (const auto& b : r.boxes) {
+        const std::array<float, 8> corners = b.corners();
+        ptr = std::copy(corners.begin(), corners.end(), ptr);
+    }
+    return array;
+}
+
+/**
+ * @brief 将分割掩码转换为形状为(n, H, W)的NumPy数组
+ */
+inline py::array Masks2PyArray(const trtyolo::SegmentRes& r) {
+    if (r.masks.empty()) return py::array_t<float>();
+    size_t n = r.masks.size();
+    size_t h = r.masks[0].height;
+    size_t w = r.masks[0].width;
+
+    py::array_t<float> array({n, h, w});
+    float*             ptr = array.mutable_data();
+    for (const auto& mask : r.masks) ptr = std::copy(mask.data.begin(), mask.data.end(), ptr);
+    return array;
+}
+
+/**
+ * @brief 将关键点转换为形状为(n, m, c)的NumPy数组，c为2时每个点为[x, y]，为3时为[x, y, conf]
+ */
+inline py::array Keypoints2PyArray(const trtyolo::PoseRes& r) {
+    size_t n = r.kpts.size();
+    size_t m = r.kpts.empty() ? 0 : r.kpts[0].size();
+    size_t c = r.kpts.empty() || r.kpts[0].empty() ? 0 : r.kpts[0][0].conf ? 3 : 2;
+
+    py::array_t<float> array({n, m, c});
+    auto               rptr = array.mutable_unchecked<3>();
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+            rptr(i, j, 0) = r.kpts[i][j].x;
+            rptr(i, j, 1) = r.kpts[i][j].y;
+            if (c == 3) rptr(i, j, 2) = r.kpts[i][j].conf.value_or(0.0f);
+        }
+    }
+    return array;
+}
+
+/**
+ * @brief 按列存储的批量结果，批量中所有图像的目标按图像顺序拼接在一起
+ *
+ * 一次批量推理只创建一个Python对象和少量数组，避免为每张图像创建结果对象。
+ */
+struct BatchRes {
+    py::array  counts;       // < 每张图像的目标数量，形状为(N,)
+    py::array  image_index;  // < 每个目标所属图像的下标，形状为(M,)
+    py::array  classes;      // < 类别ID，形状为(M,)
+    py::array  scores;       // < 置信度，形状为(M,)
+    py::object boxes;        // < 边界框，形状为(M, 4)，分类任务为 None
+    py::object corners;      // < 旋转框角点，形状为(M, 4, 2)，仅旋转框检测任务
+    py::object masks;        // < 分割掩码，形状为(M, H, W)，仅分割任务
+    py::object kpts;         // < 关键点，形状为(M, K, C)，仅姿态估计任务
+};
+
+/**
+ * @brief 将一个批量的结果拼接为按列存储的BatchRes
+ *
+ * @tparam ResultType 结果类型
+ * @param results 每张图像的结果
+ * @return BatchRes 拼接后的结果
+ */
+template <typename ResultType>
+BatchRes Results2BatchRes(const std::vector<ResultType>& results) {
+    size_t total = 0;
+    for (const auto& r : results) total += r.num;
+
+    py::array_t<int>   counts(results.size());
+    py::array_t<int>   image_index(total);
+    py::array_t<int>   classes(total);
+    py::array_t<float> scores(total);
+
+    int*   counts_ptr = counts.mutable_data();
+    int*   index_ptr  = image_index.mutable_data();
+    int*   class_ptr  = classes.mutable_data();
+    float* score_ptr  = scores.mutable_data();
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        counts_ptr[i] = r.num;
+        index_ptr     = std::fill_n(index_ptr, r.num, static_cast<int>(i));
+        class_ptr     = std::copy_n(r.classes.begin(), r.num, class_ptr);
+        score_ptr     = std::copy_n(r.scores.begin(), r.num, score_ptr);
+    }
+
+    BatchRes batch{counts, image_index, classes, scores, py::none(), py::none(), py::none(), py::none()};
+
+    if constexpr (!std::is_same_v<ResultType, trtyolo::ClassifyRes>) {
+        py::array_t<float> boxes({total, size_t{4}});
+        float*             ptr = boxes.mutable_data();
+        for (const auto& r : results) {
+            for (int j = 0; j < r.num; ++j) ptr = std::copy_n(&r.boxes[j].left, 4, ptr);
+        }
+        batch.boxes = boxes;
+    }
+
+    if constexpr (std::is_same_v<ResultType, trtyolo::OBBRes>) {
+        py::array_t<float> corners({total, size_t{4}, size_t{2}});
+        float*             ptr = corners.mutable_data();
+        for (const auto& r : results) {
+            for (int j = 0; j < r.num; ++j) {
+                const std::array<float, 8> points = r.boxes[j].corners();
+                ptr = std::copy(points.begin(), points.end(), ptr);
+            }
+        }
+        batch.corners = corners;
+    }
+
+    if constexpr (std::is_same_v<ResultType, trtyolo::SegmentRes>) {
+        size_t h = 0, w = 0;
+        for (const auto& r : results) {
+            if (r.masks.empty()) continue;
+            h = r.masks[0].height;
+            w = r.masks[0].width;
+            break;
+        }
+
+        py::array_t<float> masks({total, h, w});
+        float*             ptr = masks.mutable_data();
+        for (const auto& r : results) {
+            for (const auto& mask : r.masks) ptr = std::copy(mask.data.begin(), mask.data.end(), ptr);
+        }
+        batch.masks = masks;
+    }
+
+    if constexpr (std::is_same_v<ResultType, trtyolo::PoseRes>) {
+        size_t k = 0, c = 0;
+        for (const auto& r : results) {
+            if (r.kpts.empty() || r.kpts[0].empty()) continue;
+            k = r.kpts[0].size();
+            c = r.kpts[0][0].conf ? 3 : 2;
+            break;
+        }
+
+        py::array_t<float> kpts({total, k, c});
+        float*             ptr = kpts.mutable_data();
+        for (const auto& r : results) {
+            for (const auto& points : r.kpts) {
+                for (const auto& kpt : points) {
+                    *ptr++ = kpt.x;
+                    *ptr++ = kpt.y;
+                    if (c == 3) *ptr++ = kpt.conf.value_or(0.0f);
+                }
+            }
+        }
+        batch.kpts = kpts;
+    }
+
+    return batch;
+}
+
+/**
+ * @brief 调用方预分配的结果数组，第 i 张图像的目标写在第 i * stride 行起的位置
+ */
+struct OutArrays {
+    float* boxes;    // < 边界框 [x1, y1, x2, y2]，分类任务为 nullptr
+    float* scores;   // < 置信度
+    int*   classes;  // < 类别ID
+    size_t stride;   // < 每张图像占用的行数，即模型的 numOutputBoxes
+};
+
+/**
+ * @brief 检查并取得调用方传入的结果数组 (boxes, scores, classes)
+ *
+ * 数组必须为 C 连续、可写，且数据类型与结果一致，否则写入的是临时拷贝，调用方看不到结果。
+ *
+ * @param out 元组 (boxes, scores, classes)：float32 (R, 4)、float32 (R,)、int32 (R,)，分类任务忽略 boxes（可以为 None）
+ * @param num_images 图像数量
+ * @param stride 每张图像占用的行数
+ * @param need_boxes 任务是否输出边界框
+ * @return OutArrays 指向数组内存的指针
+ * @throws std::invalid_argument 当数组的形状、数据类型、内存布局不满足要求或行数 R 小于 num_images * stride 时抛出此异常
+ */
+inline OutArrays PyTuple2OutArrays(const py::tuple& out, size_t num_images, size_t stride, bool need_boxes) {
+    if (out.size() != 3) throw std::invalid_argument("out must be a tuple of (boxes, scores, classes) arrays.");
+
+    size_t rows  = num_images * stride;
+    auto   check = [rows](const py::handle& obj, const char* name, const py::dtype& dtype, py::ssize_t width) -> void* {
+        if (!py::isinstance<py::array>(obj)) throw std::invalid_argument(std::string("out ") + name + " must be a numpy array.");
+        auto array = py::reinterpret_borrow<py::array>(obj);
+        if (!array.dtype().is(dtype)) throw std::invalid_argument(std::string("out ") + name + " must be of dtype " + py::str(dtype).cast<std::string>() + ".");
+        if (!(array.flags() & py::array::c_style) || !array.writeable()) {
+            throw std::invalid_argument(std::string("out ") + name + " must be C-contiguous and writeable.");
+        }
+        bool shape_ok = width ? array.ndim() == 2 && array.shape(1) == width : array.ndim() == 1;
+        if (!shape_ok || static_cast<size_t>(array.shape(0)) < rows) {
+            throw std::invalid_argument(std::string("out ") + name + " must have shape (" + std::to_string(rows) + (width ? ", 4)" : ",)") +
+                                        " or more rows, i.e. numOutputBoxes * number of images.");
+        }
+        return array.mutable_data();
+    };
+
+    OutArrays arrays{nullptr, nullptr, nullptr, stride};
+    if (need_boxes) arrays.boxes = static_cast<float*>(check(out[0], "boxes", py::dtype::of<float>(), 4));
+    arrays.scores  = static_cast<float*>(check(out[1], "scores", py::dtype::of<float>(), 0));
+    arrays.classes = static_cast<int*>(check(out[2], "classes", py::dtype::of<int>(), 0));
+    return arrays;
+}
+
+/**
+ * @brief 将一个批量的结果写入调用方预分配的数组
+ *
+ * @tparam ResultType 结果类型
+ * @param results 每张图像的结果
+ * @param out 结果数组
+ * @param first 第一张图像在整个请求中的下标
+ * @param counts 每张图像的目标数量追加到该列表
+ */
+template <typename ResultType>
+void WriteResults(const std::vector<ResultType>& results, const OutArrays& out, size_t first, std::vector<int>& counts) {
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r   = results[i];
+        size_t      row = (first + i) * out.stride;
+        int         num = std::min(r.num, static_cast<int>(out.stride));
+        std::copy_n(r.scores.begin(), num, out.scores + row);
+        std::copy_n(r.classes.begin(), num, out.classes + row);
+        if constexpr (!std::is_same_v<ResultType, trtyolo::ClassifyRes>) {
+            float* ptr = out.boxes + row * 4;
+            for (int j = 0; j < num; ++j) ptr = std::copy_n(&r.boxes[j].left, 4, ptr);
+        }
+        counts.push_back(num);
+    }
+}
+
+/**
+ * @brief 将各阶段延迟分解转换为Python字典，便于直接接入监控面板
+ *
+ * @param breakdown 各阶段延迟统计
+ * @return py::dict 以阶段名称为键的字典
+ */
+inline py::dict PerformanceBreakdown2Dict(const trtyolo::PerformanceBreakdown& breakdown) {
+    auto stats2dict = [](const trtyolo::LatencyStats& stats) {
+        py::dict dict;
+        dict["count"]  = stats.count;
+        dict["min"]    = stats.min;
+        dict["max"]    = stats.max;
+        dict["mean"]   = stats.mean;
+        dict["median"] = stats.median;
+        dict["p90"]    = stats.p90;
+        dict["p95"]    = stats.p95;
+        dict["p99"]    = stats.p99;
+        return dict;
+    };
+
+    py::dict dict;
+    dict["throughput"]  = breakdown.throughput;
+    dict["staging"]     = stats2dict(breakdown.staging);
+    dict["h2d"]         = stats2dict(breakdown.h2d);
+    dict["letterbox"]   = stats2dict(breakdown.letterbox);
+    dict["inference"]   = stats2dict(breakdown.inference);
+    dict["d2h"]         = stats2dict(breakdown.d2h);
+    dict["postprocess"] = stats2dict(breakdown.postprocess);
+    dict["cpu_total"]   = stats2dict(breakdown.cpu_total);
+    dict["gpu_total"]   = stats2dict(breakdown.gpu_total);
+    return dict;
+}
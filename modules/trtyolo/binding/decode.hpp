@@ -0,0 +1,192 @@
+/**
+ * @file decode.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 图像路径列表的并行解码：线程池按批次提前解码，与推理流水线执行
+ * @date 2025-07-17
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "infer/trtyolo.hpp"
+
+#ifdef TRTYOLO_WITH_OPENCV
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+/**
+ * @brief 图像路径列表的并行解码器
+ *
+ * 解码线程按路径顺序领取任务，只解码到 advance 给出的上限为止，避免整个列表同时驻留内存。
+ * 调用方按顺序 wait 每张图像，推理完一批后 advance 放开下一段，线程池在推理期间继续解码后续批次。
+ */
+class PathDecoder {
+public:
+    /**
+     * @brief 启动解码线程
+     *
+     * @param paths 图像路径
+     * @param threads 解码线程数，0 表示使用硬件线程数
+     * @param limit 初始允许解码的图像数量
+     */
+    PathDecoder(const std::vector<std::string>& paths, size_t threads, size_t limit)
+        : paths_(paths), slots_(paths.size()), limit_(std::min(limit, paths.size())) {
+        if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1u);
+        threads = std::min(threads, paths.size());
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) workers_.emplace_back([this] { run(); });
+    }
+
+    ~PathDecoder() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    PathDecoder(const PathDecoder&)            = delete;
+    PathDecoder& operator=(const PathDecoder&) = delete;
+
+    /**
+     * @brief 等待第 index 张图像解码完成
+     *
+     * @throws std::runtime_error 当图像无法读取时抛出此异常
+     */
+    const cv::Mat& wait(size_t index) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return slots_[index].ready; });
+        if (slots_[index].error) std::rethrow_exception(slots_[index].error);
+        return slots_[index].image;
+    }
+
+    /**
+     * @brief 将允许解码的图像数量提高到 limit
+     */
+    void advance(size_t limit) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            limit_ = std::max(limit_, std::min(limit, paths_.size()));
+        }
+        cv_.notify_all();
+    }
+
+    /**
+     * @brief 释放已推理完成的图像
+     */
+    void release(size_t begin, size_t end) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = begin; i < end; ++i) slots_[i].image.release();
+    }
+
+private:
+    struct Slot {
+        cv::Mat            image;          // < 解码得到的 BGR 图像
+        std::exception_ptr error;          // < 解码失败时的异常
+        bool               ready = false;  // < 是否已解码完成
+    };
+
+    void run() {
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || next_ < limit_ || next_ == paths_.size(); });
+                if (stop_ || next_ == paths_.size()) return;
+                index = next_++;
+            }
+
+            Slot slot;
+            try {
+                slot.image = cv::imread(paths_[index], cv::IMREAD_COLOR);
+                if (slot.image.empty()) throw std::runtime_error("Failed to read image: " + paths_[index]);
+            } catch (...) {
+                slot.error = std::current_exception();
+            }
+            slot.ready = true;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                slots_[index] = std::move(slot);
+            }
+            cv_.notify_all();
+        }
+    }
+
+    const std::vector<std::string>& paths_;          // < 图像路径
+    std::vector<Slot>               slots_;          // < 每张图像的解码结果
+    std::mutex                      mutex_;          // < 保护以下状态和 slots_
+    std::condition_variable         cv_;             // < 通知解码完成、上限提高或停止
+    size_t                          next_  = 0;      // < 下一张待领取的图像
+    size_t                          limit_ = 0;      // < 允许解码的图像数量
+    bool                            stop_  = false;  // < 是否停止
+    std::vector<std::thread>        workers_;        // < 解码线程，最后初始化
+};
+
+/**
+ * @brief 并行解码图像路径列表，并按模型的最大批量分块推理
+ *
+ * 线程池最多提前解码两个批次：推理当前批次时，后续批次已在解码，解码和推理重叠执行。
+ * 每个批次推理完成后释放其图像，内存占用与列表长度无关。调用时不应持有 GIL。
+ * 解码得到的图像是普通主机内存，由模型的锁页暂存缓冲区完成到设备的拷贝。
+ *
+ * @tparam ModelType 模型类型
+ * @param model 模型
+ * @param paths 图像路径，数量可以超过模型的最大批量
+ * @param threads 解码线程数，0 表示使用硬件线程数
+ * @return std::pair 每张图像的结果，以及每张图像的 (高, 宽)
+ * @throws std::runtime_error 当图像无法读取时抛出此异常
+ */
+template <typename ModelType>
+auto PredictPaths(ModelType& model, const std::vector<std::string>& paths, size_t threads) {
+    using Results = decltype(model.predict(std::vector<trtyolo::Image>{}));
+
+    std::pair<Results, std::vector<std::pair<int, int>>> output;
+    if (paths.empty()) return output;
+    output.first.reserve(paths.size());
+    output.second.reserve(paths.size());
+
+    size_t      batch = static_cast<size_t>(std::max(model.batch(), 1));
+    PathDecoder decoder(paths, threads, 2 * batch);
+    for (size_t start = 0; start < paths.size(); start += batch) {
+        size_t end = std::min(start + batch, paths.size());
+
+        std::vector<trtyolo::Image> images;
+        images.reserve(end - start);
+        for (size_t i = start; i < end; ++i) {
+            const cv::Mat& image = decoder.wait(i);
+            images.emplace_back(image.data, image.cols, image.rows, image.step[0]);
+            output.second.emplace_back(image.rows, image.cols);
+        }
+        decoder.advance(end + 2 * batch);
+
+        auto part = model.predict(images);
+        std::move(part.begin(), part.end(), std::back_inserter(output.first));
+        decoder.release(start, end);
+    }
+    return output;
+}
+
+#else
+
+template <typename ModelType>
+auto PredictPaths(ModelType& model, const std::vector<std::string>&, size_t)
+    -> std::pair<decltype(model.predict(std::vector<trtyolo::Image>{})), std::vector<std::pair<int, int>>> {
+    throw std::runtime_error("trtyolo was built without OpenCV; rebuild with -DBUILD_OPENCV_IO=ON to decode images natively.");
+}
+
+#endif
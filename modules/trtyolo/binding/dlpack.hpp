@@ -0,0 +1,124 @@
+/**
+ * @file dlpack.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief DLPack 张量输入：不经过 NumPy 直接接收 PyTorch、CuPy 等框架的主机或 CUDA 张量
+ * @date 2025-07-14
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ */
+
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "binding/dltensor.hpp"
+#include "infer/trtyolo.hpp"
+
+namespace py = pybind11;
+
+/**
+ * @brief DLPack 张量映射得到的输入图像
+ */
+struct DLPackImages {
+    std::vector<trtyolo::Image> images;  // < 每张图像，指向张量中的内存
+    int                         device;  // < 张量所在的 CUDA 设备 ID，主机内存为 -1
+    bool                        batch;   // < 输入是否为批量（4D 张量或张量列表）
+    py::object                  owner;   // < 持有张量的胶囊（或胶囊列表），推理结束前保持存活
+};
+
+/**
+ * @brief 判断对象是否可以作为 DLPack 张量输入（实现 __dlpack__ 协议的非 NumPy 对象或 "dltensor" 胶囊）
+ */
+inline bool IsDLPack(const py::handle& src) {
+    if (PyCapsule_CheckExact(src.ptr())) return true;
+    return !py::isinstance<py::array>(src) && py::hasattr(src, "__dlpack__");
+}
+
+/**
+ * @brief 取得 DLPack 张量的所有权
+ *
+ * CUDA 张量以 stream=1（legacy 默认流）导出：生产者保证数据在默认流上就绪，推理流由 cudaStreamCreate 创建，
+ * 隐式与默认流同步，无需额外等待。按照协议，被消费的胶囊重命名为 "used_dltensor"。
+ *
+ * @param src 实现 __dlpack__ 协议的对象或 "dltensor" 胶囊
+ * @return py::capsule 释放时调用生产者 deleter 的胶囊
+ */
+inline py::capsule ConsumeDLPack(const py::handle& src) {
+    if (!IsDLPack(src)) throw py::type_error("Expected a numpy array, an object implementing __dlpack__, or a list of them.");
+
+    py::object capsule;
+    if (PyCapsule_CheckExact(src.ptr())) {
+        capsule = py::reinterpret_borrow<py::object>(src);
+    } else {
+        int device_type = dlpack::kDLCPU;
+        if (py::hasattr(src, "__dlpack_device__")) device_type = src.attr("__dlpack_device__")().cast<py::tuple>()[0].cast<int>();
+        bool cuda = device_type == dlpack::kDLCUDA || device_type == dlpack::kDLCUDAManaged;
+        capsule   = cuda ? src.attr("__dlpack__")(py::arg("stream") = 1) : src.attr("__dlpack__")();
+    }
+
+    auto* tensor = static_cast<dlpack::ManagedTensor*>(PyCapsule_GetPointer(capsule.ptr(), "dltensor"));
+    if (tensor == nullptr) throw py::error_already_set();  // 胶囊已被消费或不是 DLPack 胶囊
+    PyCapsule_SetName(capsule.ptr(), "used_dltensor");
+
+    return py::capsule(tensor, +[](void* ptr) {
+        auto* tensor = static_cast<dlpack::ManagedTensor*>(ptr);
+        if (tensor->deleter) tensor->deleter(tensor);
+    });
+}
+
+/**
+ * @brief 将 DLPack 张量或张量列表映射为一组 trtyolo::Image 对象，不拷贝像素
+ *
+ * 列表中的张量须为 3D 且位于同一设备。返回的 owner 持有所有张量，调用方需要在推理结束前持有它。
+ *
+ * @param src 实现 __dlpack__ 协议的对象、"dltensor" 胶囊，或由它们组成的列表
+ * @return DLPackImages 映射得到的图像
+ * @throws std::invalid_argument 当张量不受支持或列表中的张量位于不同设备时抛出此异常
+ */
+inline DLPackImages DLPack2Images(const py::handle& src) {
+    DLPackImages result{{}, -1, true, py::none()};
+
+    if (!py::isinstance<py::list>(src) && !py::isinstance<py::tuple>(src)) {
+        py::capsule capsule = ConsumeDLPack(src);
+        const auto& tensor  = capsule.get_pointer<dlpack::ManagedTensor>()->dl_tensor;
+        result.device       = DLTensor2Images(tensor, result.images);
+        result.batch        = tensor.ndim == 4;
+        result.owner        = std::move(capsule);
+        return result;
+    }
+
+    py::list owners;
+    for (const auto& item : src) {
+        py::capsule capsule = ConsumeDLPack(item);
+        const auto& tensor  = capsule.get_pointer<dlpack::ManagedTensor>()->dl_tensor;
+        owners.append(capsule);
+        if (tensor.ndim != 3) throw std::invalid_argument("Require each DLPack tensor in a list to be of shape (H, W, 3).");
+
+        int device = DLTensor2Images(tensor, result.images);
+        if (owners.size() > 1 && device != result.device) throw std::invalid_argument("All DLPack tensors in a list must be on the same device.");
+        result.device = device;
+    }
+    result.owner = std::move(owners);
+    return result;
+}
+
+/**
+ * @brief 检查输入图像所在的设备与模型期望的一致
+ *
+ * @param expected 模型期望的设备，见 BaseModel::inputDevice
+ * @param device 输入所在的 CUDA 设备 ID，主机内存为 -1
+ * @throws std::invalid_argument 当输入和模型的设备不一致时抛出此异常
+ */
+inline void CheckInputDevice(int expected, int device) {
+    if (device == expected) return;
+    if (expected < 0) {
+        throw std::invalid_argument("CUDA tensors require a model created with InferOption.enable_cuda_memory().");
+    }
+    throw std::invalid_argument("The model was created with InferOption.enable_cuda_memory() and requires CUDA tensors on device " +
+                                std::to_string(expected) + (device < 0 ? ", got host memory." : ", got device " + std::to_string(device) + "."));
+}
@@ -0,0 +1,112 @@
+/**
+ * @file dltensor.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief DLPack 张量的结构定义及其到 trtyolo::Image 的映射，不依赖 Python，可以单独测试
+ * @date 2025-07-18
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "infer/trtyolo.hpp"
+
+namespace dlpack {
+
+// 以下结构与 dlpack.h（ABI 版本 0.x）中的 DLDevice、DLDataType、DLTensor、DLManagedTensor 布局一致
+
+enum DeviceType : int32_t {
+    kDLCPU         = 1,   // < 主机内存
+    kDLCUDA        = 2,   // < CUDA 显存
+    kDLCUDAHost    = 3,   // < cudaMallocHost 分配的锁页内存
+    kDLCUDAManaged = 13,  // < cudaMallocManaged 分配的统一内存
+};
+
+enum DataTypeCode : uint8_t {
+    kDLUInt = 1,  // < 无符号整数
+};
+
+struct Device {
+    int32_t device_type;  // < 设备类型
+    int32_t device_id;    // < 设备 ID
+};
+
+struct DataType {
+    uint8_t  code;   // < 类型代码
+    uint8_t  bits;   // < 位数
+    uint16_t lanes;  // < 向量通道数
+};
+
+struct Tensor {
+    void*    data;         // < 数据指针
+    Device   device;       // < 数据所在设备
+    int32_t  ndim;         // < 维度数
+    DataType dtype;        // < 数据类型
+    int64_t* shape;        // < 形状
+    int64_t* strides;      // < 步长（元素个数），为空时表示行主序紧密排列
+    uint64_t byte_offset;  // < 数据起始位置相对 data 的字节偏移
+};
+
+struct ManagedTensor {
+    Tensor dl_tensor;                      // < 张量描述
+    void*  manager_ctx;                    // < 生产者的上下文
+    void (*deleter)(ManagedTensor* self);  // < 释放张量的回调
+};
+
+}  // namespace dlpack
+
+/**
+ * @brief 将一个 DLPack 张量映射为一组 trtyolo::Image 对象，不拷贝像素
+ *
+ * 张量要求为 uint8，形状为 (H, W, 3) 或 (N, H, W, 3)，像素和通道紧密排列，行和批量维度可以带步长。
+ *
+ * @param tensor DLPack 张量
+ * @param images 映射得到的图像追加到该列表
+ * @return int 张量所在的 CUDA 设备 ID，主机内存为 -1
+ * @throws std::invalid_argument 当数据类型、形状、步长或设备类型不受支持时抛出此异常
+ */
+inline int DLTensor2Images(const dlpack::Tensor& tensor, std::vector<trtyolo::Image>& images) {
+    if (tensor.dtype.code != dlpack::kDLUInt || tensor.dtype.bits != 8 || tensor.dtype.lanes != 1) {
+        throw std::invalid_argument("Require a uint8 DLPack tensor while converting it to trtyolo::Image.");
+    }
+    if ((tensor.ndim != 3 && tensor.ndim != 4) || tensor.shape[tensor.ndim - 1] != 3) {
+        throw std::invalid_argument("Require a DLPack tensor of shape (H, W, 3) or (N, H, W, 3) while converting it to trtyolo::Image.");
+    }
+
+    // 长度为 1 的维度步长没有意义，按紧密排列处理
+    auto stride = [&](int dim, int64_t packed) {
+        return tensor.strides && tensor.shape[dim] != 1 ? tensor.strides[dim] : packed;
+    };
+
+    int     offset = tensor.ndim - 3;
+    int64_t num = offset ? tensor.shape[0] : 1, height = tensor.shape[offset], width = tensor.shape[offset + 1];
+    int64_t row_stride   = stride(offset, width * 3);
+    int64_t batch_stride = offset ? stride(0, height * row_stride) : 0;
+    if (stride(offset + 2, 1) != 1 || stride(offset + 1, 3) != 3 || row_stride < width * 3 || batch_stride < 0) {
+        throw std::invalid_argument("Require a DLPack tensor with packed HWC pixels, call .contiguous() on it first.");
+    }
+
+    int device = -1;
+    switch (tensor.device.device_type) {
+        case dlpack::kDLCPU:
+        case dlpack::kDLCUDAHost:
+            break;
+        case dlpack::kDLCUDA:
+        case dlpack::kDLCUDAManaged:
+            device = tensor.device.device_id;
+            break;
+        default:
+            throw std::invalid_argument("Unsupported DLPack device type " + std::to_string(tensor.device.device_type) + ", require CPU or CUDA.");
+    }
+
+    auto* data = static_cast<uint8_t*>(tensor.data) + tensor.byte_offset;
+    for (int64_t i = 0; i < num; ++i) {
+        images.emplace_back(data + i * batch_stride, static_cast<int>(width), static_cast<int>(height), 3, static_cast<size_t>(row_stride));
+    }
+    return device;
+}
@@ -0,0 +1,317 @@
+/**
+ * @file stream.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 视频流迭代器：解码线程和推理线程经有界队列流水线执行，Python 循环只取结果，不需要 Python 线程
+ * @date 2025-07-16
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ */
+
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "infer/trtyolo.hpp"
+
+#ifdef TRTYOLO_WITH_OPENCV
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#endif
+
+namespace py = pybind11;
+
+/**
+ * @brief 有界阻塞队列，队列满时 push 等待，队列空时 pop 等待
+ *
+ * close 之后 push 立即返回 false，pop 取完剩余元素后返回 false。
+ *
+ * @tparam T 元素类型
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 等待至少一个元素，然后不再等待地取出最多 max_count 个
+     *
+     * @return bool 队列已关闭且为空时返回 false
+     */
+    bool popSome(std::vector<T>& items, size_t max_count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        while (!items_.empty() && items.size() < max_count) {
+            items.push_back(std::move(items_.front()));
+            items_.pop_front();
+        }
+        not_full_.notify_all();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    /**
+     * @brief 关闭队列并丢弃剩余元素，用于提前停止
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        items_.clear();
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    std::mutex              mutex_;           // < 保护队列
+    std::condition_variable not_full_;        // < 通知有空位或关闭
+    std::condition_variable not_empty_;       // < 通知有元素或关闭
+    std::deque<T>           items_;           // < 队列元素
+    size_t                  capacity_;        // < 队列容量
+    bool                    closed_ = false;  // < 是否已关闭
+};
+
+/**
+ * @brief Python 视频流迭代器的接口，屏蔽模型类型
+ */
+class VideoStream {
+public:
+    virtual ~VideoStream() = default;
+
+    /**
+     * @brief 返回下一帧及其结果的元组 (frame, result)，流结束时抛出 StopIteration。调用时需持有 GIL。
+     */
+    virtual py::tuple next() = 0;
+
+    /**
+     * @brief 停止解码和推理线程并释放视频源，可以重复调用
+     */
+    virtual void close() = 0;
+
+    virtual double fps() const    = 0;  // < 视频源报告的帧率，未知时为 0
+    virtual int    width() const  = 0;  // < 帧宽度
+    virtual int    height() const = 0;  // < 帧高度
+    virtual size_t frames() const = 0;  // < 已返回给 Python 的帧数
+};
+
+#ifdef TRTYOLO_WITH_OPENCV
+
+/**
+ * @brief 将 cv::Mat 转换为共享其内存的 NumPy 数组，数组持有 Mat 的引用计数
+ */
+inline py::array Mat2PyArray(const cv::Mat& mat) {
+    auto*                    owner = new cv::Mat(mat);
+    py::capsule              capsule(owner, [](void* ptr) { delete static_cast<cv::Mat*>(ptr); });
+    std::vector<py::ssize_t> shape   = {mat.rows, mat.cols, mat.channels()};
+    std::vector<py::ssize_t> strides = {static_cast<py::ssize_t>(mat.step[0]), static_cast<py::ssize_t>(mat.elemSize()), 1};
+    return py::array(py::dtype::of<uint8_t>(), shape, strides, owner->data, capsule);
+}
+
+/**
+ * @brief 基于 OpenCV 解码的视频流迭代器
+ *
+ * 流水线分为三级，各级之间是有界队列：
+ * 1. 解码线程：cv::VideoCapture 逐帧读取，放入帧队列，队列满时等待（背压，不丢帧）；
+ * 2. 推理线程：等待至少一帧，取出已就绪的帧（不超过模型最大批量）批量推理，放入结果队列；
+ * 3. Python 线程：next 释放 GIL 等待结果队列，取到后转换为 (frame, result)。
+ * 解码、暂存和推理在原生线程中重叠执行，都不持有 GIL。推理运行在模型的克隆上，原模型可以继续在其他线程中使用。
+ * 任一线程出错时停止流水线，异常在 Python 取完已有结果后抛出。
+ *
+ * @tparam ModelType 模型类型
+ */
+template <typename ModelType>
+class VideoStreamImpl : public VideoStream {
+public:
+    using ResultType = decltype(std::declval<ModelType>().predict(std::declval<const trtyolo::Image&>()));
+
+    /**
+     * @brief 打开视频源并启动解码和推理线程
+     *
+     * @param model 模型，推理在它的克隆上执行
+     * @param capture 已打开的视频源
+     * @param queue_size 帧队列和结果队列的容量
+     */
+    VideoStreamImpl(const ModelType& model, std::unique_ptr<cv::VideoCapture> capture, size_t queue_size)
+        : model_(model.clone()), capture_(std::move(capture)), decoded_(queue_size), results_(queue_size) {
+        fps_    = capture_->get(cv::CAP_PROP_FPS);
+        width_  = static_cast<int>(capture_->get(cv::CAP_PROP_FRAME_WIDTH));
+        height_ = static_cast<int>(capture_->get(cv::CAP_PROP_FRAME_HEIGHT));
+
+        decoder_    = std::thread([this] { decode(); });
+        inferencer_ = std::thread([this] { infer(); });
+    }
+
+    ~VideoStreamImpl() override { close(); }
+
+    py::tuple next() override {
+        Item item;
+        bool got;
+        {
+            py::gil_scoped_release release;
+            got = results_.pop(item);
+        }
+        if (!got) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (error_) {
+                auto error = std::exchange(error_, nullptr);
+                std::rethrow_exception(error);
+            }
+            throw py::stop_iteration();
+        }
+        ++frames_;
+        return py::make_tuple(Mat2PyArray(item.frame), py::cast(std::move(item.result)));
+    }
+
+    void close() override {
+        decoded_.clear();
+        results_.clear();
+        py::gil_scoped_release release;
+        if (decoder_.joinable()) decoder_.join();
+        if (inferencer_.joinable()) inferencer_.join();
+        capture_->release();
+    }
+
+    double fps() const override { return fps_; }
+    int    width() const override { return width_; }
+    int    height() const override { return height_; }
+    size_t frames() const override { return frames_; }
+
+private:
+    struct Item {
+        cv::Mat    frame;   // < 解码得到的 BGR 帧
+        ResultType result;  // < 推理结果
+    };
+
+    void setError() {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (!error_) error_ = std::current_exception();
+    }
+
+    void decode() {
+        try {
+            while (true) {
+                cv::Mat frame;  // 每帧新分配：帧会作为 NumPy 数组交给 Python，不能复用
+                if (!capture_->read(frame) || frame.empty()) break;
+                if (frame.type() != CV_8UC3) throw std::runtime_error("Video stream frames must be 8-bit 3-channel images.");
+                if (!decoded_.push(std::move(frame))) return;
+            }
+        } catch (...) {
+            setError();
+        }
+        decoded_.close();  // 推理线程处理完已解码的帧后结束
+    }
+
+    void infer() {
+        try {
+            size_t               max_batch = static_cast<size_t>(std::max(model_->batch(), 1));
+            std::vector<cv::Mat> frames;
+            while (decoded_.popSome(frames, max_batch)) {
+                std::vector<trtyolo::Image> images;
+                images.reserve(frames.size());
+                for (auto& frame : frames) images.emplace_back(frame.data, frame.cols, frame.rows, frame.step[0]);
+
+                auto batch = model_->predict(images);
+                for (size_t i = 0; i < frames.size(); ++i) {
+                    if (!results_.push(Item{std::move(frames[i]), std::move(batch[i])})) return;
+                }
+                frames.clear();
+            }
+        } catch (...) {
+            setError();
+            decoded_.clear();  // 解除解码线程的等待
+        }
+        results_.close();  // 保留已完成的结果，Python 取完后再结束或抛出异常
+    }
+
+    std::unique_ptr<ModelType>        model_;        // < 推理使用的模型克隆
+    std::unique_ptr<cv::VideoCapture> capture_;      // < 视频源
+    BoundedQueue<cv::Mat>             decoded_;      // < 已解码、待推理的帧
+    BoundedQueue<Item>                results_;      // < 已推理、待 Python 取走的帧和结果
+    std::mutex                        error_mutex_;  // < 保护 error_
+    std::exception_ptr                error_;        // < 解码或推理线程中的第一个异常
+    double                            fps_    = 0;   // < 视频源帧率
+    int                               width_  = 0;   // < 帧宽度
+    int                               height_ = 0;   // < 帧高度
+    size_t                            frames_ = 0;   // < 已返回的帧数
+    std::thread                       decoder_;      // < 解码线程
+    std::thread                       inferencer_;   // < 推理线程
+};
+
+/**
+ * @brief 打开视频文件、网络流或摄像头，创建视频流迭代器
+ *
+ * @tparam ModelType 模型类型
+ * @param model 模型
+ * @param source 视频文件路径、流地址（str）或摄像头索引（int）
+ * @param queue_size 帧队列和结果队列的容量
+ * @return std::unique_ptr<VideoStream> 视频流迭代器
+ * @throws std::invalid_argument 当模型要求 CUDA 输入或队列容量为 0 时抛出此异常
+ * @throws std::runtime_error 当视频源无法打开时抛出此异常
+ */
+template <typename ModelType>
+std::unique_ptr<VideoStream> OpenVideoStream(const ModelType& model, const py::object& source, size_t queue_size) {
+    if (model.inputDevice() >= 0) throw std::invalid_argument("Video streams decode to host memory and cannot be used with InferOption.enable_cuda_memory().");
+    if (queue_size == 0) throw std::invalid_argument("queue_size must be positive.");
+
+    auto capture = std::make_unique<cv::VideoCapture>();
+    bool opened;
+    if (py::isinstance<py::int_>(source)) {
+        int index = source.cast<int>();
+        py::gil_scoped_release release;  // 打开摄像头或网络流可能耗时较长
+        opened = capture->open(index);
+    } else {
+        std::string path = py::str(source);
+        py::gil_scoped_release release;
+        opened = capture->open(path);
+    }
+    if (!opened) throw std::runtime_error("Failed to open video source: " + py::str(source).cast<std::string>());
+
+    return std::make_unique<VideoStreamImpl<ModelType>>(model, std::move(capture), queue_size);
+}
+
+#else
+
+template <typename ModelType>
+std::unique_ptr<VideoStream> OpenVideoStream(const ModelType&, const py::object&, size_t) {
+    throw std::runtime_error("trtyolo was built without OpenCV; rebuild with -DBUILD_OPENCV_IO=ON to use video streams.");
+}
+
+#endif
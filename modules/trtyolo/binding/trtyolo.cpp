@@ -12,8 +12,16 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
+#include <sstream>
 
+#include "binding/async.hpp"
+#include "binding/convert.hpp"
+#include "binding/decode.hpp"
+#include "binding/dlpack.hpp"
+#include "binding/stream.hpp"
 #include "infer/trtyolo.hpp"
 
 namespace py = pybind11;
@@ -50,87 +58,24 @@ void bind_result(py::module& m, const std::string& result_name) {
                   std::is_same_v<ResultType, trtyolo::OBBRes> ||
                   std::is_same_v<ResultType, trtyolo::SegmentRes> ||
                   std::is_same_v<ResultType, trtyolo::PoseRes>) {
-        cls.def_property_readonly("xyxy", [](const ResultType& r) -> py::array {
-            auto* owner = new std::vector<int>;
-            owner->reserve(r.boxes.size() * 4);
-            for (const auto& b : r.boxes) {
-                const auto& arr = b.xyxy();
-                owner->insert(owner->end(), arr.begin(), arr.end());
-            }
-
-            return py::array(
-                py::buffer_info(
-                    owner->data(),
-                    sizeof(int),
-                    py::format_descriptor<int>::format(),
-                    2,
-                    std::vector<size_t>{r.boxes.size(), 4},
-                    std::vector<size_t>{sizeof(int) * 4, sizeof(int)}),
-                py::cast(owner)); },
-                                  "An array of shape (n, 4) containing the bounding boxes "
-                                  "coordinates in format [x1, y1, x2, y2].");
+        cls.def_property_readonly("xyxy", [](const py::object& self) { return Boxes2PyArray(self.cast<const ResultType&>(), self); },
+                                  "A float32 array of shape (n, 4) containing the bounding boxes "
+                                  "coordinates in format [x1, y1, x2, y2]. The array is a view of the result without copying "
+                                  "and keeps the result alive.");
 
         if constexpr (std::is_same_v<ResultType, trtyolo::OBBRes>) {
-            cls.def_property_readonly("xyxyxyxy", [](const ResultType& r) -> py::array {
-                auto* owner = new std::vector<int>;
-                owner->reserve(r.boxes.size() * 8);
-                for (const auto& b : r.boxes) {
-                    const std::array<int,8>& arr = b.xyxyxyxy();
-                    owner->insert(owner->end(), arr.begin(), arr.end());
-                }
-
-                return py::array(
-                    py::buffer_info(
-                        owner->data(),
-                        sizeof(int),
-                        py::format_descriptor<int>::format(),
-                        3,
-                        std::vector<size_t>{r.boxes.size(), 4, 2},
-                        std::vector<size_t>{sizeof(int) * 8, sizeof(int) * 2, sizeof(int)}),
-                    py::cast(owner)); },
-                                      "An array of shape (n, 4, 2) containing the bounding boxes "
+            cls.def_property_readonly("xyxyxyxy", &RotatedBoxes2PyArray,
+                                      "A float32 array of shape (n, 4, 2) containing the bounding boxes "
                                       "coordinates in format [[x1, y1], [x2, y2], [x3, y3], [x4, y4]].");
         }
     }
 
     if constexpr (std::is_same_v<ResultType, trtyolo::SegmentRes>) {
-        cls.def_property_readonly("masks", [](const ResultType& r) -> py::array {
-            if (r.masks.empty()) return py::array_t<float>();
-            size_t n = r.masks.size();
-            size_t h = r.masks[0].height;
-            size_t w = r.masks[0].width;
-
-            auto* owner = new std::vector<float>;
-            owner->reserve(n * h * w);
-            for (const auto& mask : r.masks) owner->insert(owner->end(), mask.data.begin(), mask.data.end());
-            return py::array(
-                py::buffer_info(
-                    owner->data(),
-                    sizeof(float),
-                    py::format_descriptor<float>::format(),
-                    3,
-                    {n, h, w},
-                    {sizeof(float) * h * w, sizeof(float) * w, sizeof(float)}),
-                py::cast(owner)); }, "An array of shape (n, H, W) containing the segmentation masks.");
+        cls.def_property_readonly("masks", &Masks2PyArray, "An array of shape (n, H, W) containing the segmentation masks.");
     }
 
     if constexpr (std::is_same_v<ResultType, trtyolo::PoseRes>) {
-        cls.def_property_readonly("kpts", [](const ResultType& r) -> py::array {
-            size_t n = r.kpts.size();
-            size_t m = r.kpts.empty() ? 0 : r.kpts[0].size();
-            size_t c = r.kpts.empty() || r.kpts[0].empty() ? 0 : r.kpts[0][0].conf ? 3 : 2;
-
-            py::array_t<float> array({n, m, c});
-            auto               rptr = array.mutable_unchecked<3>();
-
-            for (size_t i = 0; i < n; ++i) {
-                for (size_t j = 0; j < m; ++j) {
-                    rptr(i, j, 0) = r.kpts[i][j].x;
-                    rptr(i, j, 1) = r.kpts[i][j].y;
-                    if (c == 3) rptr(i, j, 2) = r.kpts[i][j].conf.value_or(0.0f);
-                }
-            }
-            return array; },
+        cls.def_property_readonly("kpts", &Keypoints2PyArray,
                                   "An array of shape (n, m, c) containing n detected objects, "
                                   "each composed of m equally-sized sets of keypoints and confidence scores of each keypoint. "
                                   "Where each point is [x, y] if c is 2, or [x, y, conf] if c is 3.");
@@ -161,23 +106,11 @@ void binding_result_module(py::module& m) {
         // 允许使用Python的len()函数获取结果数量
         .def("__len__", [](const trtyolo::BaseRes& r) { return r.num; }, "Return the number of detected objects via Python's len() function.")
         // 检测对象的类别ID数组
-        .def_property_readonly("class_id", [](const trtyolo::BaseRes& r) -> py::array { return py::array(
-                                                                                            py::buffer_info(
-                                                                                                const_cast<int*>(r.classes.data()),
-                                                                                                sizeof(int),
-                                                                                                py::format_descriptor<int>::format(),
-                                                                                                1,
-                                                                                                {r.classes.size()},
-                                                                                                {sizeof(int)})); }, "An array of shape (n,) containing the class IDs of the detections.")
+        .def_property_readonly("class_id", [](const py::object& self) { return Classes2PyArray(self.cast<const trtyolo::BaseRes&>(), self); },
+                               "An int32 array of shape (n,) containing the class IDs of the detections, a view of the result that keeps it alive.")
         // 检测对象的置信度分数数组
-        .def_property_readonly("confidence", [](const trtyolo::BaseRes& r) -> py::array { return py::array(
-                                                                                              py::buffer_info(
-                                                                                                  const_cast<float*>(r.scores.data()),
-                                                                                                  sizeof(float),
-                                                                                                  py::format_descriptor<float>::format(),
-                                                                                                  1,
-                                                                                                  {r.scores.size()},
-                                                                                                  {sizeof(float)})); }, "An array of shape (n,) containing the confidence scores of the detections.");
+        .def_property_readonly("confidence", [](const py::object& self) { return Scores2PyArray(self.cast<const trtyolo::BaseRes&>(), self); },
+                               "A float32 array of shape (n,) containing the confidence scores of the detections, a view of the result that keeps it alive.");
 
     // 绑定各种专门的结果类型
     bind_result<trtyolo::ClassifyRes>(m, "ClassifyRes");  // 分类结果
@@ -185,6 +118,18 @@ void binding_result_module(py::module& m) {
     bind_result<trtyolo::OBBRes>(m, "OBBRes");            // 旋转目标检测结果
     bind_result<trtyolo::SegmentRes>(m, "SegmentRes");    // 实例分割结果(带掩码)
     bind_result<trtyolo::PoseRes>(m, "PoseRes");          // 人体姿态估计结果(带关键点)
+
+    // 按列存储的批量结果，由 predict_batch 返回
+    py::class_<BatchRes>(m, "BatchRes", "Columnar results of a whole batch: the objects of all images are concatenated in image order.")
+        .def("__len__", [](const BatchRes& r) { return r.image_index.size(); }, "Return the total number of objects in the batch.")
+        .def_readonly("counts", &BatchRes::counts, "An int32 array of shape (N,) with the number of objects per image.")
+        .def_readonly("image_index", &BatchRes::image_index, "An int32 array of shape (M,) with the image index of each object.")
+        .def_readonly("class_id", &BatchRes::classes, "An int32 array of shape (M,) containing the class IDs.")
+        .def_readonly("confidence", &BatchRes::scores, "A float32 array of shape (M,) containing the confidence scores.")
+        .def_readonly("xyxy", &BatchRes::boxes, "A float32 array of shape (M, 4) with boxes in format [x1, y1, x2, y2], None for classification.")
+        .def_readonly("xyxyxyxy", &BatchRes::corners, "A float32 array of shape (M, 4, 2) with rotated box corners, only for oriented detection.")
+        .def_readonly("masks", &BatchRes::masks, "An array of shape (M, H, W) with the segmentation masks, only for segmentation.")
+        .def_readonly("kpts", &BatchRes::kpts, "An array of shape (M, K, C) with the keypoints, only for pose estimation.");
 }
 
 /**
@@ -205,9 +150,13 @@ void binding_option_module(py::module& m) {
     py::class_<trtyolo::InferOption>(m, "InferOption", "A class to configure advanced inference options for trtyolo models, controlling device selection, performance monitoring, and image preprocessing.")
         .def(py::init<>())
         .def("set_device_id", &trtyolo::InferOption::setDeviceId, "Set the device ID (GPU) for inference.")
-        // .def("enable_cuda_memory", &trtyolo::InferOption::enableCudaMem, "Inference data already in CUDA memory.")
+        .def("enable_cuda_memory", &trtyolo::InferOption::enableCudaMem,
+             "Inference data already in CUDA memory: predict then takes CUDA DLPack tensors (e.g. from PyTorch or CuPy) "
+             "on the configured device and rejects host inputs.")
         // .def("enable_managed_memory", &trtyolo::InferOption::enableManagedMemory, "Enable managed memory for inference.")
         .def("enable_profile", &trtyolo::InferOption::enablePerformanceReport, "Enable performance profile for inference.")
+        .def("set_profile_sampling", &trtyolo::InferOption::setProfileSampling, py::arg("every"),
+             "Time one request in every N on the GPU; event pairs are read back asynchronously so profiling never stalls the host.")
         .def("enable_swap_rb", &trtyolo::InferOption::enableSwapRB, "Enable RGB-to-BGR swap for image input.")
         .def("set_border_value", &trtyolo::InferOption::setBorderValue, "Set border value for image resizing (used for padding).")
         .def("set_normalize_params", &trtyolo::InferOption::setNormalizeParams, "Set normalization parameters for image preprocessing.")
@@ -215,24 +164,236 @@ void binding_option_module(py::module& m) {
 }
 
 /**
- * @brief 将NumPy数组转换为trtyolo::Image对象。
+ * @brief 为trtyolo引擎元数据创建Python绑定
+ *
+ * 该函数负责将trtyolo中的EngineInfo及相关结构体绑定到Python，
+ * 用户无需构建模型即可获取引擎的输入输出张量、批量范围和任务类型。
+ * 元数据会缓存到引擎旁的旁车文件中，后续读取无需反序列化引擎。
+ */
+void binding_info_module(py::module& m) {
+    m.doc() = "Info module of trtyolo, providing engine metadata (IO tensors, profile ranges, task type) cached in a sidecar file next to the engine.";
+
+    py::class_<trtyolo::ProfileRange>(m, "ProfileRange", "Shape range of a dynamic input tensor in one optimization profile.")
+        .def_readonly("min", &trtyolo::ProfileRange::min, "Minimum shape.")
+        .def_readonly("opt", &trtyolo::ProfileRange::opt, "Optimal shape.")
+        .def_readonly("max", &trtyolo::ProfileRange::max, "Maximum shape.");
+
+    py::class_<trtyolo::TensorDesc>(m, "TensorDesc", "Description of an engine IO tensor.")
+        .def_readonly("name", &trtyolo::TensorDesc::name, "Tensor name.")
+        .def_readonly("input", &trtyolo::TensorDesc::input, "Whether the tensor is an input.")
+        .def_readonly("dtype", &trtyolo::TensorDesc::dtype, "Data type, e.g. float32, float16, int32.")
+        .def_readonly("shape", &trtyolo::TensorDesc::shape, "Tensor shape, -1 for dynamic dimensions.")
+        .def_readonly("profiles", &trtyolo::TensorDesc::profiles, "Shape ranges per optimization profile (dynamic inputs only).");
+
+    py::class_<trtyolo::EngineInfo>(m, "EngineInfo", "Metadata of a TensorRT engine that can be read without deserializing the engine.")
+        .def_readonly("tensors", &trtyolo::EngineInfo::tensors, "IO tensor descriptions.")
+        .def_property_readonly("task", [](const trtyolo::EngineInfo& info) { return trtyolo::taskTypeToString(info.task); }, "Task type inferred from the outputs: classify, detect, obb, segment, pose or unknown.")
+        .def_readonly("dynamic", &trtyolo::EngineInfo::dynamic, "Whether the engine has dynamic input shapes.")
+        .def_readonly("min_batch", &trtyolo::EngineInfo::min_batch, "Minimum batch size.")
+        .def_readonly("max_batch", &trtyolo::EngineInfo::max_batch, "Maximum batch size.")
+        .def("save", &trtyolo::EngineInfo::save, py::arg("sidecar_file"), "Write the metadata to a sidecar file.")
+        .def_static("load", &trtyolo::EngineInfo::load, py::arg("sidecar_file"), "Read the metadata from a sidecar file.")
+        .def_static("sidecar_path", &trtyolo::EngineInfo::sidecarPath, py::arg("engine"), "Get the sidecar file path of an engine.");
+
+    m.def("inspect", &trtyolo::EngineInfo::inspect, py::arg("engine"), py::call_guard<py::gil_scoped_release>(),
+          "Get the metadata of an engine, reading the sidecar file when it is up to date, "
+          "otherwise deserializing the engine once and writing the sidecar file.");
+}
+
+/**
+ * @brief 绑定trtyolo库的推理阶段追踪功能到Python模块。
+ *
+ * @param m Python模块引用。
+ */
+void binding_trace_module(py::module& m) {
+    m.doc() = "Trace module of trtyolo, recording predict stages per thread and model clone and exporting them in Chrome trace format (chrome://tracing, Perfetto).";
+
+    m.def("start", &trtyolo::Tracer::start, py::arg("events_per_thread") = 65536,
+          "Start tracing and discard previous events. Each thread keeps at most `events_per_thread` events, overwriting the oldest.");
+    m.def("stop", &trtyolo::Tracer::stop, "Stop tracing, keeping the recorded events.");
+    m.def("enabled", &trtyolo::Tracer::enabled, "Whether tracing is enabled.");
+    m.def("clear", &trtyolo::Tracer::clear, "Discard the recorded events.");
+    m.def("json", &trtyolo::Tracer::json, "Export the recorded events as a Chrome trace JSON string.");
+    m.def("save", &trtyolo::Tracer::save, py::arg("path"), "Save the recorded events as a Chrome trace JSON file.");
+}
+
+/**
+ * @brief 绑定trtyolo库的进程级运行指标到Python模块。
+ *
+ * @param m Python模块引用。
+ */
+void binding_metrics_module(py::module& m) {
+    m.doc() = "Metrics module of trtyolo, exposing process-wide counters, gauges and histograms aggregated across all models and clones in Prometheus text format.";
+
+    m.def("prometheus", &trtyolo::Metrics::prometheus, "Export the current metrics in Prometheus text format.");
+    m.def("serve", &trtyolo::Metrics::serve, py::arg("port"), py::arg("address") = "127.0.0.1",
+          "Start a local HTTP endpoint serving the metrics on a background thread. Port 0 picks a free port; returns the bound port.");
+    m.def("shutdown", &trtyolo::Metrics::shutdown, py::call_guard<py::gil_scoped_release>(), "Stop the local HTTP endpoint.");
+    m.def("memory_footprint", &trtyolo::processMemoryFootprint, "Get the current and peak bytes of all buffers in the process per buffer type.");
+}
+
+/**
+ * @brief 绑定trtyolo库的推理捕获和离线重放功能到Python模块。
+ *
+ * @param m Python模块引用。
+ */
+void binding_capture_module(py::module& m) {
+    m.doc() = "Capture module of trtyolo, recording predict inputs and raw outputs to an append-only file and replaying post-processing offline.";
+
+    m.def("start", &trtyolo::Capture::start, py::arg("path"), py::arg("frames") = false,
+          "Start capturing every predict call to `path`, overwriting it. With `frames=False` only pixel hashes are stored.");
+    m.def("stop", &trtyolo::Capture::stop, py::call_guard<py::gil_scoped_release>(), "Stop capturing and close the file.");
+    m.def("enabled", &trtyolo::Capture::enabled, "Whether capturing is enabled.");
+    m.def("records", &trtyolo::Capture::records, "Number of records written since the last start.");
+
+    py::class_<trtyolo::CaptureFrame>(m, "CaptureFrame", "An input image of a captured predict call.")
+        .def_readonly("width", &trtyolo::CaptureFrame::width, "Image width.")
+        .def_readonly("height", &trtyolo::CaptureFrame::height, "Image height.")
+        .def_readonly("channels", &trtyolo::CaptureFrame::channels, "Image channels.")
+        .def_readonly("hash", &trtyolo::CaptureFrame::hash, "Hash of the pixels, 0 when the input was in device memory.")
+        .def_readonly("meta", &trtyolo::CaptureFrame::meta, "Letterbox metadata: valid width, valid height, offset x, offset y.")
+        .def_readonly("scale", &trtyolo::CaptureFrame::scale, "Letterbox scale.")
+        .def_property_readonly("image", [](const trtyolo::CaptureFrame& frame) -> py::object {
+            if (frame.data.empty()) return py::none();
+            return py::array_t<uint8_t>({frame.height, frame.width, frame.channels}, frame.data.data()); }, "The pixels as an (H, W, C) uint8 array, or None if only the hash was captured.");
+
+    py::class_<trtyolo::CaptureRecord>(m, "CaptureRecord", "A captured predict call.")
+        .def_readonly("timestamp_ns", &trtyolo::CaptureRecord::timestamp_ns, "Wall-clock time in nanoseconds since the Unix epoch.")
+        .def_readonly("model_id", &trtyolo::CaptureRecord::model_id, "Model instance id (each clone has its own), matching the trace module.")
+        .def_property_readonly("task", [](const trtyolo::CaptureRecord& record) { return trtyolo::taskTypeToString(record.task); }, "Task type of the model.")
+        .def_readonly("swap_rb", &trtyolo::CaptureRecord::swap_rb, "Whether R and B channels were swapped.")
+        .def_readonly("border_value", &trtyolo::CaptureRecord::border_value, "Letterbox border value.")
+        .def_readonly("alpha", &trtyolo::CaptureRecord::alpha, "Normalization scale per channel.")
+        .def_readonly("beta", &trtyolo::CaptureRecord::beta, "Normalization offset per channel.")
+        .def_readonly("frames", &trtyolo::CaptureRecord::frames, "The input images.");
+
+    py::class_<trtyolo::CaptureReader>(m, "CaptureReader", "Memory-mapped reader of a capture file; replays post-processing without a GPU or engine.")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def("__len__", &trtyolo::CaptureReader::size)
+        .def("task", [](const trtyolo::CaptureReader& reader, size_t index) { return trtyolo::taskTypeToString(reader.task(index)); }, py::arg("index"),
+             "Task type of a record.")
+        .def("record", &trtyolo::CaptureReader::record, py::arg("index"), "Read the metadata and input images of a record.")
+        .def("replay", [](const trtyolo::CaptureReader& reader, size_t index) -> py::object {
+            switch (reader.task(index)) {
+                case trtyolo::TaskType::Classify: return py::cast(reader.replayClassify(index));
+                case trtyolo::TaskType::Detect: return py::cast(reader.replayDetect(index));
+                case trtyolo::TaskType::OBB: return py::cast(reader.replayOBB(index));
+                case trtyolo::TaskType::Segment: return py::cast(reader.replaySegment(index));
+                case trtyolo::TaskType::Pose: return py::cast(reader.replayPose(index));
+                default: throw std::invalid_argument("CaptureReader: record has an unknown task type");
+            } }, py::arg("index"), "Re-run post-processing on the captured raw outputs and return one result per image.");
+}
+
+/**
+ * @brief 释放 GIL 执行函数并返回其结果
+ */
+template <typename Func>
+auto ReleaseGIL(Func&& func) {
+    py::gil_scoped_release release;
+    return func();
+}
+
+/**
+ * @brief 绑定trtyolo库的共享内存帧环到Python模块。
+ *
+ * @param m Python模块引用。
+ */
+void binding_ring_module(py::module& m) {
+    m.doc() = "Ring module of trtyolo, serving many producer processes from one model process through a POSIX shared-memory frame ring.";
+
+    py::class_<trtyolo::FrameRingOptions>(m, "FrameRingOptions", "Layout of a shared-memory frame ring.")
+        .def(py::init<>())
+        .def_readwrite("slots", &trtyolo::FrameRingOptions::slots, "Number of frame slots, i.e. frames in flight across all producers.")
+        .def_readwrite("max_width", &trtyolo::FrameRingOptions::max_width, "Maximum frame width.")
+        .def_readwrite("max_height", &trtyolo::FrameRingOptions::max_height, "Maximum frame height.")
+        .def_readwrite("result_bytes", &trtyolo::FrameRingOptions::result_bytes, "Result bytes per slot; segmentation masks need a large area.")
+        .def_readwrite("workers", &trtyolo::FrameRingOptions::workers, "Number of inference threads, each holding a clone of the model.");
+
+    py::class_<trtyolo::FrameRingServer>(m, "FrameRingServer",
+                                         "Hosts a model and batch-infers frames submitted by FrameRingClient instances in other processes. "
+                                         "All frames ready when an inference thread wakes are batched in submission order, up to the model batch size.")
+        .def(py::init<const std::string&, const std::string&, const std::vector<std::string>&, const trtyolo::InferOption&, const trtyolo::FrameRingOptions&>(),
+             py::arg("name"), py::arg("task"), py::arg("engines"), py::arg("option"), py::arg("options") = trtyolo::FrameRingOptions(),
+             py::call_guard<py::gil_scoped_release>(),
+             "Build the model and create the shared memory segment `name` (an existing one is replaced). "
+             "`task` is one of classify, detect, segment, pose, obb.")
+        .def("stop", &trtyolo::FrameRingServer::stop, py::call_guard<py::gil_scoped_release>(),
+             "Stop the inference threads and remove the shared memory segment.")
+        .def_property_readonly("frames", &trtyolo::FrameRingServer::frames, "Number of frames inferred.")
+        .def_property_readonly("batches", &trtyolo::FrameRingServer::batches, "Number of batches run; frames / batches is the mean batch size.");
+
+    py::class_<trtyolo::FrameRingClient>(m, "FrameRingClient", "Submits frames to a FrameRingServer and waits for the results; needs no GPU or engine.")
+        .def(py::init<const std::string&, int>(), py::arg("name"), py::arg("timeout_ms") = 10000,
+             "Attach to the shared memory segment `name` created by a FrameRingServer.")
+        .def_property_readonly("task", [](const trtyolo::FrameRingClient& client) { return trtyolo::taskTypeToString(client.task()); },
+                               "Task type of the server model.")
+        .def_property_readonly("max_width", &trtyolo::FrameRingClient::maxWidth, "Maximum frame width.")
+        .def_property_readonly("max_height", &trtyolo::FrameRingClient::maxHeight, "Maximum frame height.")
+        .def("predict", [](trtyolo::FrameRingClient& client, py::array& input) -> py::object {
+            auto image = PyArray2Image(input);
+            switch (client.task()) {
+                case trtyolo::TaskType::Classify: return py::cast(ReleaseGIL([&] { return client.predictClassify(image); }));
+                case trtyolo::TaskType::Detect: return py::cast(ReleaseGIL([&] { return client.predictDetect(image); }));
+                case trtyolo::TaskType::OBB: return py::cast(ReleaseGIL([&] { return client.predictOBB(image); }));
+                case trtyolo::TaskType::Segment: return py::cast(ReleaseGIL([&] { return client.predictSegment(image); }));
+                case trtyolo::TaskType::Pose: return py::cast(ReleaseGIL([&] { return client.predictPose(image); }));
+                default: throw std::invalid_argument("FrameRingClient: the server has an unknown task type");
+            } }, py::arg("image"),
+             "Copy a HWC-format numpy array into a free slot, wait for the server and return the result. "
+             "The GIL is released while waiting, so threads can keep several frames in flight.");
+}
+
+/**
+ * @brief 按模型的最大批量分块推理，并将所有结果拼接为按列存储的BatchRes
  *
- * 此函数会把一个形状为(height, width, channels)、数据类型为uint8的3D NumPy数组，
- * 转换为trtyolo::Image对象，该对象可用于后续的推理任务。
- * 函数会检查输入数组的维度和通道数，若输入数组不是3维，或者第三维通道数不为3，
- * 则抛出 std::invalid_argument 异常。
+ * 推理和后处理期间释放 GIL，只在最后拼接结果时创建少量 NumPy 数组。
  *
- * @param src 输入的NumPy数组，要求形状为(height, width, channels)，数据类型为uint8。
- * @return trtyolo::Image 转换后的可用于推理的图像对象。
- * @throws std::invalid_argument 当输入数组不是3维，或者第三维通道数不为3时抛出此异常。
+ * @tparam ModelType 模型类型
+ * @param model 模型
+ * @param images 输入图像，数量可以超过模型的最大批量
+ * @return BatchRes 拼接后的结果
  */
-trtyolo::Image PyArray2Image(const py::array_t<uint8_t>& src) {
-    py::buffer_info buf = src.request();
-    if (buf.ndim != 3 || buf.shape[2] != 3) {
-        throw std::invalid_argument("Require rank of array to be 3 with HWC format while converting it to trtyolo::Image.");
+template <typename ModelType>
+BatchRes PredictBatch(ModelType& model, const std::vector<trtyolo::Image>& images) {
+    decltype(model.predict(images)) results;
+    {
+        py::gil_scoped_release release;
+        size_t                 batch = static_cast<size_t>(model.batch());
+        results.reserve(images.size());
+        for (size_t start = 0; start < images.size(); start += batch) {
+            std::vector<trtyolo::Image> chunk(images.begin() + start, images.begin() + std::min(start + batch, images.size()));
+            auto                        part = model.predict(chunk);
+            std::move(part.begin(), part.end(), std::back_inserter(results));
+        }
     }
+    return Results2BatchRes(results);
+}
+
+/**
+ * @brief 按模型的最大批量分块推理，并将结果写入调用方预分配的数组
+ *
+ * 数组在持有 GIL 时检查，推理、后处理和写入期间释放 GIL，整个调用只创建返回的目标数量。
+ *
+ * @tparam ModelType 模型类型
+ * @param model 模型
+ * @param images 输入图像，数量可以超过模型的最大批量
+ * @param out 元组 (boxes, scores, classes)，见 PyTuple2OutArrays
+ * @return std::vector<int> 每张图像写入的目标数量
+ */
+template <typename ModelType>
+std::vector<int> PredictInto(ModelType& model, const std::vector<trtyolo::Image>& images, const py::tuple& out) {
+    constexpr bool   need_boxes = !std::is_same_v<ModelType, trtyolo::ClassifyModel>;
+    OutArrays        arrays     = PyTuple2OutArrays(out, images.size(), static_cast<size_t>(model.numOutputBoxes()), need_boxes);
+    std::vector<int> counts;
+    counts.reserve(images.size());
 
-    return trtyolo::Image(buf.ptr, buf.shape[1], buf.shape[0], buf.shape[2], buf.strides[0]);
+    py::gil_scoped_release release;
+    size_t                 batch = static_cast<size_t>(model.batch());
+    for (size_t start = 0; start < images.size(); start += batch) {
+        std::vector<trtyolo::Image> chunk(images.begin() + start, images.begin() + std::min(start + batch, images.size()));
+        WriteResults(model.predict(chunk), arrays, start, counts);
+    }
+    return counts;
 }
 
 /**
@@ -248,26 +409,184 @@ trtyolo::Image PyArray2Image(const py::array_t<uint8_t>& src) {
  */
 template <typename ModelType>
 void bind_model(py::module& m, const std::string& model_name) {
-    py::class_<ModelType, std::unique_ptr<ModelType>>(m, model_name.c_str(),
+    py::class_<ModelType, std::shared_ptr<ModelType>>(m, model_name.c_str(),
                                                       "A trtyolo model class for performing computer vision inference tasks with TensorRT acceleration.")
         .def(py::init<const std::string&, const trtyolo::InferOption&>(),
              "Initialize the model with a TensorRT engine file path and inference configuration options.")
-        .def("clone", &ModelType::clone,
+        .def(py::init<const std::vector<std::string>&, const trtyolo::InferOption&>(),
+             "Initialize the model with a family of TensorRT engines built from the same network with different batch sizes; "
+             "each call runs on the engine that wastes the fewest padded batch slots.")
+        .def("clone", [](const ModelType& self) { return std::shared_ptr<ModelType>(self.clone()); },
              "Create a clone of the current model instance with the same configuration (shared engine, create a new context).")
         .def(
-            "predict", [](ModelType& self, py::array& input) {
-                return self.predict(PyArray2Image(input));
+            "predict", [](ModelType& self, py::array& input) -> py::object {
+                CheckInputDevice(self.inputDevice(), -1);
+                if (input.ndim() == 4) {
+                    auto images = PyArray2Images(input);
+                    decltype(self.predict(images)) results;
+                    {
+                        py::gil_scoped_release release;
+                        results = self.predict(images);
+                    }
+                    return py::cast(std::move(results));
+                }
+                auto image = PyArray2Image(input);
+                decltype(self.predict(image)) result;
+                {
+                    py::gil_scoped_release release;  // 推理和后处理不访问 Python 对象，input 在调用期间保持存活
+                    result = self.predict(image);
+                }
+                return py::cast(std::move(result));
             },
-            "Run inference on a single image represented as a HWC-format numpy array (height, width, channels).")
+            "Run inference on a single image represented as a HWC-format numpy array (height, width, channels), "
+            "or on a batch given as one uint8 array of shape (N, height, width, 3), returning a list of results. "
+            "Batch images are mapped in place without per-image conversion; a contiguous batch is staged with a single copy. "
+            "The GIL is released during inference and post-processing, so threads each holding a clone run in parallel.")
         .def("predict", [](ModelType& self, std::vector<py::array>& inputs) {
+                CheckInputDevice(self.inputDevice(), -1);
+                std::vector<trtyolo::Image> images;
+                images.reserve(inputs.size());
+                for (auto& arr : inputs) images.push_back(PyArray2Image(arr));
+                py::gil_scoped_release release;
+                return self.predict(images); }, "Run batch inference on a list of images, each represented as a HWC-format numpy array. "
+                                                "The GIL is released during inference and post-processing.")
+        .def(
+            "predict", [](ModelType& self, py::array& input, const py::tuple& out) -> py::object {
+                CheckInputDevice(self.inputDevice(), -1);
+                if (input.ndim() == 4) return py::cast(PredictInto(self, PyArray2Images(input), out));
+                return py::int_(PredictInto(self, {PyArray2Image(input)}, out).front());
+            },
+            py::arg("input"), py::arg("out"),
+            "Run inference on a HWC image or a uint8 batch of shape (N, H, W, 3) of any length and write the objects into the "
+            "preallocated arrays out = (boxes, scores, classes): float32 (R, 4), float32 (R,) and int32 (R,), C-contiguous, "
+            "with R >= num_output_boxes * number of images. Image i is written from row i * num_output_boxes. Returns the number "
+            "of objects (an int for a single image, a list for a batch); classification models ignore boxes.")
+        .def("predict", [](ModelType& self, std::vector<py::array>& inputs, const py::tuple& out) {
+                CheckInputDevice(self.inputDevice(), -1);
+                std::vector<trtyolo::Image> images;
+                images.reserve(inputs.size());
+                for (auto& arr : inputs) images.push_back(PyArray2Image(arr));
+                return PredictInto(self, images, out); }, py::arg("inputs"), py::arg("out"),
+             "Run inference on a list of HWC images of any length and write the objects into the preallocated arrays out, "
+             "returning the number of objects per image.")
+        .def(
+            "predict", [](ModelType& self, const py::object& input) -> py::object {
+                auto inputs = DLPack2Images(input);
+                CheckInputDevice(self.inputDevice(), inputs.device);
+                decltype(self.predict(inputs.images)) results;
+                {
+                    py::gil_scoped_release release;
+                    results = self.predict(inputs.images);
+                }
+                if (inputs.batch) return py::cast(std::move(results));
+                return py::cast(std::move(results.front()));
+            },
+            "Run inference on a DLPack tensor (any object implementing __dlpack__, such as a PyTorch or CuPy tensor, or a "
+            "'dltensor' capsule) of shape (H, W, 3) or (N, H, W, 3), or on a list of (H, W, 3) tensors, without copying "
+            "through NumPy. Tensors must be uint8 with packed pixels. CPU tensors work with any model; CUDA tensors require "
+            "InferOption.enable_cuda_memory() and are read in place on the GPU.")
+        .def(
+            "predict_async", [](const py::object& self, py::array& input) {
+                CheckInputDevice(self.cast<const ModelType&>().inputDevice(), -1);
+                if (input.ndim() == 4) {
+                    auto images = PyArray2Images(input);
+                    return PredictAsync<ModelType>(self, std::move(images), input, true);
+                }
+                return PredictAsync<ModelType>(self, {PyArray2Image(input)}, input, false);
+            },
+            "Run inference like predict on a background thread and return an asyncio.Future for the result, "
+            "completed through loop.call_soon_threadsafe. Must be awaited inside a running event loop. "
+            "Requests on the same model object run in order; use clones to run them in parallel.")
+        .def("predict_async", [](const py::object& self, std::vector<py::array>& inputs) {
+                CheckInputDevice(self.cast<const ModelType&>().inputDevice(), -1);
+                std::vector<trtyolo::Image> images;
+                images.reserve(inputs.size());
+                for (auto& arr : inputs) images.push_back(PyArray2Image(arr));
+                return PredictAsync<ModelType>(self, std::move(images), py::cast(inputs), true); }, "Run batch inference on a list of HWC-format numpy arrays on a background thread and return an asyncio.Future for the list of results.")
+        .def("predict_async", [](const py::object& self, const py::object& input) {
+                auto inputs = DLPack2Images(input);
+                CheckInputDevice(self.cast<const ModelType&>().inputDevice(), inputs.device);
+                return PredictAsync<ModelType>(self, std::move(inputs.images), inputs.owner, inputs.batch); }, "Run inference on a DLPack tensor or a list of them, like predict, on a background thread and return an asyncio.Future.")
+        .def("predict_batch", [](ModelType& self, py::array& inputs) {
+                CheckInputDevice(self.inputDevice(), -1);
+                return PredictBatch(self, PyArray2Images(inputs)); },
+             "Run inference on a uint8 array of shape (N, height, width, 3) of any length, split into chunks of the model batch size, "
+             "and return a single columnar BatchRes instead of one result object per image.")
+        .def("predict_batch", [](ModelType& self, std::vector<py::array>& inputs) {
+                CheckInputDevice(self.inputDevice(), -1);
                 std::vector<trtyolo::Image> images;
                 images.reserve(inputs.size());
                 for (auto& arr : inputs) images.push_back(PyArray2Image(arr));
-                return self.predict(images); }, "Run batch inference on a list of images, each represented as a HWC-format numpy array.")
+                return PredictBatch(self, images); }, "Run inference on a list of HWC-format numpy arrays of any length and return a single columnar BatchRes.")
+        .def("predict_batch", [](ModelType& self, const std::vector<std::string>& paths, size_t threads) {
+                CheckInputDevice(self.inputDevice(), -1);
+                decltype(PredictPaths(self, paths, threads).first) results;
+                {
+                    py::gil_scoped_release release;
+                    results = PredictPaths(self, paths, threads).first;
+                }
+                return Results2BatchRes(results); }, py::arg("paths"), py::arg("threads") = 0,
+             "Decode a list of image paths on a pool of native threads, pipelined with inference, and return a single columnar BatchRes. "
+             "Requires a build with OpenCV.")
+        .def("predict_batch", [](ModelType& self, const py::object& input) {
+                auto inputs = DLPack2Images(input);
+                CheckInputDevice(self.inputDevice(), inputs.device);
+                return PredictBatch(self, inputs.images); }, "Run inference on a DLPack tensor of shape (N, H, W, 3) or a list of (H, W, 3) tensors of any length and return a single columnar BatchRes.")
+        .def("stream", &OpenVideoStream<ModelType>, py::arg("source"), py::arg("queue_size") = 8,
+             "Open a video file, stream URL (str) or camera index (int) and return an iterator of (frame, result) tuples. "
+             "Frames are decoded by OpenCV on a native thread and inferred in batches of the frames already decoded on a clone "
+             "of the model, overlapping with the Python loop; both stages are bounded by queue_size. Requires a build with OpenCV.")
+        .def("predict_paths", [](ModelType& self, const std::vector<std::string>& paths, size_t threads) {
+                CheckInputDevice(self.inputDevice(), -1);
+                py::gil_scoped_release release;
+                return PredictPaths(self, paths, threads); }, py::arg("paths"), py::arg("threads") = 0,
+             "Decode a list of image paths on a pool of native threads (0 uses all hardware threads) and run batch inference, "
+             "returning (results, shapes) where shapes holds the (height, width) of each image. Up to two batches are decoded "
+             "ahead of the batch being inferred, and decoded images are freed once inferred. Requires a build with OpenCV.")
+        .def("reload", py::overload_cast<const std::string&>(&ModelType::reload), py::call_guard<py::gil_scoped_release>(),
+             "Hot-swap the TensorRT engine. The new engine is loaded without holding the GIL while other threads keep "
+             "predicting on the old one; calls already in flight finish on the old engine before it is released.")
+        .def("reload", py::overload_cast<const std::vector<std::string>&>(&ModelType::reload), py::call_guard<py::gil_scoped_release>(),
+             "Hot-swap the model to a new family of TensorRT engines built with different batch sizes.")
+        .def("reload_from", [](ModelType& self, const ModelType& model) { self.reloadFrom(model); }, py::call_guard<py::gil_scoped_release>(),
+             "Switch to the engine currently used by another model instance (shared engine, create a new context).")
         .def("profile", [](ModelType& self) {
             auto report = self.performanceReport();
             return std::make_tuple(py::str(std::get<0>(report)), py::str(std::get<1>(report)), py::str(std::get<2>(report))); }, "Get the performance profile of the model as a tuple of (preprocess_time, inference_time, postprocess_time).")
-        .def_property_readonly("batch", &ModelType::batch, "Get the maximum batch size supported by the model for batch inference.");
+        .def("reset_profile", &ModelType::resetPerformanceReport, "Reset the profiling statistics (shared with clones).")
+        .def("profile_breakdown", [](const ModelType& self) { return PerformanceBreakdown2Dict(self.performanceBreakdown()); },
+             "Get per-stage latency statistics as a dict with keys throughput, staging, h2d, letterbox, inference, d2h, "
+             "postprocess, cpu_total and gpu_total; each stage maps to a dict of count, min, max, mean, median, p90, p95 and p99 in ms.")
+        .def_property_readonly("batch_occupancy", &ModelType::batchOccupancy, "Get requested images versus executed batch slots (shared with clones).")
+        .def("reset_batch_occupancy", &ModelType::resetBatchOccupancy, "Reset the batch occupancy counters (shared with clones).")
+        .def_property_readonly("input_device", &ModelType::inputDevice, "Get the CUDA device inputs are read from, or -1 when inputs are host memory.")
+        .def_property_readonly("num_output_boxes", &ModelType::numOutputBoxes,
+                               "Get the maximum number of objects per image (k of top-k for classification), the row stride of predict(..., out=...).")
+        .def_property_readonly("batch", &ModelType::batch, "Get the maximum batch size supported by the model for batch inference.")
+        .def_property_readonly("memory_usage", &ModelType::memoryUsage, "Get the device and pinned host memory held by the model's tensor and staging buffers.")
+        .def_property_readonly("memory_footprint", &ModelType::memoryFootprint, "Get the current and peak bytes of the model's buffers per buffer type.");
+}
+
+/**
+ * @brief 将注册表中的模型转换为对应任务类型的Python模型对象
+ *
+ * @param registry 模型注册表
+ * @param name 模型名称
+ * @return py::object 对应任务类型的模型对象
+ */
+py::object RegistryModel2PyObject(trtyolo::ModelRegistry& registry, const std::string& name) {
+    std::string                         task = registry.task(name);
+    std::shared_ptr<trtyolo::BaseModel> model;
+    {
+        py::gil_scoped_release release;  // 构建模型可能耗时较长
+        model = registry.get(name);
+    }
+
+    if (task == "classify") return py::cast(std::static_pointer_cast<trtyolo::ClassifyModel>(model));
+    if (task == "detect") return py::cast(std::static_pointer_cast<trtyolo::DetectModel>(model));
+    if (task == "segment") return py::cast(std::static_pointer_cast<trtyolo::SegmentModel>(model));
+    if (task == "pose") return py::cast(std::static_pointer_cast<trtyolo::PoseModel>(model));
+    return py::cast(std::static_pointer_cast<trtyolo::OBBModel>(model));
 }
 
 /**
@@ -285,20 +604,96 @@ void binding_model_module(py::module& m) {
         "Model module of trtyolo, providing TensorRT-accelerated inference for computer vision tasks, "
         "including ClassifyModel, DetectModel, OBBModel, SegmentModel, and PoseModel.";
 
+    py::class_<trtyolo::MemoryUsage>(m, "MemoryUsage", "Device and pinned host memory held by a model or registry.")
+        .def_readonly("device_bytes", &trtyolo::MemoryUsage::device_bytes, "Bytes of device memory (managed memory included).")
+        .def_readonly("pinned_bytes", &trtyolo::MemoryUsage::pinned_bytes, "Bytes of pinned host memory.")
+        .def("__repr__", [](const trtyolo::MemoryUsage& usage) {
+            std::ostringstream oss;
+            oss << usage;
+            return oss.str(); });
+
+    py::class_<trtyolo::BatchOccupancy>(m, "BatchOccupancy", "Requested images versus executed batch slots; static engines always execute the maximum batch.")
+        .def_readonly("requests", &trtyolo::BatchOccupancy::requests, "Number of predict calls.")
+        .def_readonly("images", &trtyolo::BatchOccupancy::images, "Number of images requested.")
+        .def_readonly("slots", &trtyolo::BatchOccupancy::slots, "Number of batch slots executed.")
+        .def_property_readonly("fill_ratio", &trtyolo::BatchOccupancy::fillRatio, "images / slots.")
+        .def_property_readonly("padding", &trtyolo::BatchOccupancy::padding, "Executed slots that held no image.")
+        .def("__repr__", [](const trtyolo::BatchOccupancy& occupancy) {
+            std::ostringstream oss;
+            oss << occupancy;
+            return oss.str(); });
+
+    py::class_<trtyolo::BufferBytes>(m, "BufferBytes", "Current and peak bytes of one buffer type.")
+        .def_readonly("current", &trtyolo::BufferBytes::current, "Bytes currently allocated.")
+        .def_readonly("peak", &trtyolo::BufferBytes::peak, "Peak bytes allocated.")
+        .def("__repr__", [](const trtyolo::BufferBytes& bytes) {
+            std::ostringstream oss;
+            oss << bytes;
+            return oss.str(); });
+
+    py::class_<trtyolo::MemoryFootprint>(m, "MemoryFootprint", "Current and peak buffer bytes per buffer type; pinned host memory is discrete + mapped.")
+        .def_readonly("device", &trtyolo::MemoryFootprint::device, "Device-only buffers (input tensors, outputs unused by the task).")
+        .def_readonly("discrete", &trtyolo::MemoryFootprint::discrete, "Discrete buffers, each holding the same bytes on the device and in pinned host memory.")
+        .def_readonly("unified", &trtyolo::MemoryFootprint::unified, "Managed (unified) memory buffers.")
+        .def_readonly("mapped", &trtyolo::MemoryFootprint::mapped, "Mapped pinned host memory buffers.")
+        .def_readonly("total", &trtyolo::MemoryFootprint::total, "All buffers; the peak is the peak of the sum.")
+        .def("__repr__", [](const trtyolo::MemoryFootprint& footprint) {
+            std::ostringstream oss;
+            oss << footprint;
+            return oss.str(); });
+
+    py::class_<VideoStream>(m, "VideoStream", "An iterator of (frame, result) tuples over a video, pipelined on native decode and inference threads.")
+        .def("__iter__", [](py::object self) { return self; })
+        .def("__next__", &VideoStream::next, "Wait for the next BGR frame and its result without holding the GIL.")
+        .def("close", &VideoStream::close, "Stop the decode and inference threads and release the video source.")
+        .def("__enter__", [](py::object self) { return self; })
+        .def("__exit__", [](VideoStream& self, const py::args&) { self.close(); })
+        .def_property_readonly("fps", &VideoStream::fps, "Frame rate reported by the video source, 0 when unknown.")
+        .def_property_readonly("width", &VideoStream::width, "Frame width.")
+        .def_property_readonly("height", &VideoStream::height, "Frame height.")
+        .def_property_readonly("frames", &VideoStream::frames, "Number of frames returned so far.");
+
+#ifdef TRTYOLO_WITH_OPENCV
+    m.attr("opencv_io") = true;
+#else
+    m.attr("opencv_io") = false;
+#endif
+
     bind_model<trtyolo::ClassifyModel>(m, "ClassifyModel");
     bind_model<trtyolo::DetectModel>(m, "DetectModel");
     bind_model<trtyolo::OBBModel>(m, "OBBModel");
     bind_model<trtyolo::SegmentModel>(m, "SegmentModel");
     bind_model<trtyolo::PoseModel>(m, "PoseModel");
+
+    py::class_<trtyolo::ModelRegistry>(m, "ModelRegistry",
+                                       "A registry that builds models lazily on first use and evicts the least-recently-used ones "
+                                       "when their device or pinned host memory exceeds the configured budget.")
+        .def(py::init<size_t, size_t>(), py::arg("device_budget"), py::arg("pinned_budget") = static_cast<size_t>(-1),
+             "Initialize the registry with a device memory budget and an optional pinned host memory budget, in bytes.")
+        .def("add", &trtyolo::ModelRegistry::add, py::arg("name"), py::arg("task"), py::arg("engines"), py::arg("option"),
+             "Register a model by name without building it. `task` is one of classify, detect, segment, pose, obb.")
+        .def("load_manifest", &trtyolo::ModelRegistry::loadManifest, py::arg("manifest"), py::arg("option"),
+             "Register models from a manifest file with one `<name> <task> <engine>[,<engine>...]` entry per line.")
+        .def("get", &RegistryModel2PyObject, py::arg("name"),
+             "Get a model by name, building it on first use and marking it as most recently used.")
+        .def("task", &trtyolo::ModelRegistry::task, py::arg("name"), "Get the task type of a registered model.")
+        .def("resident", &trtyolo::ModelRegistry::resident, py::arg("name"), "Check whether a model is currently built and held by the registry.")
+        .def("evict", &trtyolo::ModelRegistry::evict, py::arg("name"), "Drop the registry's reference to a model.")
+        .def_property_readonly("memory_usage", &trtyolo::ModelRegistry::memoryUsage, "Get the total memory held by resident models.");
 }
 
 /**
  * @brief trtyolo Python绑定主模块。
  *
  * 此模块借助Pybind11创建TensorRT-YOLO的Python绑定接口，
- * 包含三个子模块：
+ * 包含八个子模块：
  * - result：封装推理结果类，可将结果转换为NumPy数组以便在Python中使用；
  * - option：提供推理选项配置类，可设置设备、内存、图像预处理等参数；
+ * - info：提供引擎元数据，无需构建模型即可获取输入输出张量和任务类型；
+ * - trace：记录推理各阶段的耗时，导出为 Chrome 追踪格式；
+ * - metrics：汇总进程内所有模型的运行指标，导出为 Prometheus 文本格式；
+ * - capture：记录每次推理的输入和原始输出，离线重放后处理；
+ * - ring：共享内存帧环，一个进程托管模型，为多个生产者进程批量推理；
  * - model：绑定各类模型，支持单张或批量图像的推理任务。
  * 用户可通过该模块在Python环境中轻松处理推理结果、配置推理选项，
  * 并执行分类、检测、目标旋转框检测、实例分割和关键点检测等任务。
@@ -312,6 +707,21 @@ PYBIND11_MODULE(py_trtyolo, m) {
     py::module option_module = m.def_submodule("option");
     binding_option_module(option_module);
 
+    py::module info_module = m.def_submodule("info");
+    binding_info_module(info_module);
+
+    py::module trace_module = m.def_submodule("trace");
+    binding_trace_module(trace_module);
+
+    py::module metrics_module = m.def_submodule("metrics");
+    binding_metrics_module(metrics_module);
+
+    py::module capture_module = m.def_submodule("capture");
+    binding_capture_module(capture_module);
+
+    py::module ring_module = m.def_submodule("ring");
+    binding_ring_module(ring_module);
+
     py::module model_module = m.def_submodule("model");
     binding_model_module(model_module);
 }
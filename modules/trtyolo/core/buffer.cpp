@@ -10,13 +10,54 @@
 
 #include "buffer.hpp"
 #include "utils/common.hpp"
+#include "utils/metrics.hpp"
 
 namespace trtyolo {
 
+void MemoryLedger::Counter::add(int64_t delta) noexcept {
+    int64_t current = this->current.fetch_add(delta, std::memory_order_relaxed) + delta;
+    int64_t peak    = this->peak.load(std::memory_order_relaxed);
+    while (current > peak && !this->peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+MemoryLedger& MemoryLedger::global() {
+    static MemoryLedger ledger;
+    return ledger;
+}
+
+void MemoryLedger::track(BufferType type, int64_t delta) noexcept {
+    types_[static_cast<size_t>(type)].add(delta);
+    total_.add(delta);
+}
+
+size_t MemoryLedger::current(BufferType type) const noexcept {
+    return static_cast<size_t>(types_[static_cast<size_t>(type)].current.load(std::memory_order_relaxed));
+}
+
+size_t MemoryLedger::peak(BufferType type) const noexcept {
+    return static_cast<size_t>(types_[static_cast<size_t>(type)].peak.load(std::memory_order_relaxed));
+}
+
+size_t MemoryLedger::currentTotal() const noexcept {
+    return static_cast<size_t>(total_.current.load(std::memory_order_relaxed));
+}
+
+size_t MemoryLedger::peakTotal() const noexcept {
+    return static_cast<size_t>(total_.peak.load(std::memory_order_relaxed));
+}
+
+void BaseBuffer::track(int64_t delta) noexcept {
+    if (delta == 0) return;
+    MemoryLedger::global().track(type(), delta);
+    if (ledger_) ledger_->track(type(), delta);
+}
+
 DeviceBuffer::DeviceBuffer(DeviceBuffer&& other) noexcept
     : size_(other.size_), device_(other.device_) {
     other.device_ = nullptr;
     other.size_   = 0;
+    ledger_       = other.ledger_;  // < 已分配的字节数仍记在原账本上
 }
 
 DeviceBuffer& DeviceBuffer::operator=(DeviceBuffer&& other) noexcept {
@@ -26,21 +67,25 @@ DeviceBuffer& DeviceBuffer::operator=(DeviceBuffer&& other) noexcept {
         device_       = other.device_;
         other.device_ = nullptr;
         other.size_   = 0;
+        ledger_       = other.ledger_;
     }
     return *this;
 }
 
 void DeviceBuffer::allocate(size_t size) {
+    recordAllocation(size <= size_);
     if (size > size_) {
         free();
         CHECK(cudaMalloc(&device_, size));  // < 分配设备内存
         size_ = size;
+        track(static_cast<int64_t>(size_));
     }
 }
 
 void DeviceBuffer::free() {
     if (device_) CHECK(cudaFree(device_));  // < 释放设备内存
     device_ = nullptr;
+    track(-static_cast<int64_t>(size_));
     size_   = 0;
 }
 
@@ -65,6 +110,7 @@ DiscreteBuffer::DiscreteBuffer(DiscreteBuffer&& other) noexcept
     other.host_   = nullptr;
     other.device_ = nullptr;
     other.size_   = 0;
+    ledger_       = other.ledger_;  // < 已分配的字节数仍记在原账本上
 }
 
 DiscreteBuffer& DiscreteBuffer::operator=(DiscreteBuffer&& other) noexcept {
@@ -76,16 +122,19 @@ DiscreteBuffer& DiscreteBuffer::operator=(DiscreteBuffer&& other) noexcept {
         other.host_   = nullptr;
         other.device_ = nullptr;
         other.size_   = 0;
+        ledger_       = other.ledger_;
     }
     return *this;
 }
 
 void DiscreteBuffer::allocate(size_t size) {
+    recordAllocation(size <= size_);
     if (size > size_) {
         free();
         CHECK(cudaMallocHost(&host_, size));  // < 分配主机内存
         CHECK(cudaMalloc(&device_, size));    // < 分配设备内存
         size_ = size;
+        track(static_cast<int64_t>(size_));
     }
 }
 
@@ -98,6 +147,7 @@ void DiscreteBuffer::free() {
         CHECK(cudaFree(device_));    // < 释放设备内存
         device_ = nullptr;           // < 将指针置为 nullptr，避免双重释放
     }
+    track(-static_cast<int64_t>(size_));
     size_ = 0;
 }
 
@@ -134,6 +184,7 @@ UnifiedBuffer::UnifiedBuffer(UnifiedBuffer&& other) noexcept
     other.host_   = nullptr;
     other.device_ = nullptr;
     other.size_   = 0;
+    ledger_       = other.ledger_;  // < 已分配的字节数仍记在原账本上
 }
 
 UnifiedBuffer& UnifiedBuffer::operator=(UnifiedBuffer&& other) noexcept {
@@ -145,16 +196,19 @@ UnifiedBuffer& UnifiedBuffer::operator=(UnifiedBuffer&& other) noexcept {
         other.host_   = nullptr;
         other.device_ = nullptr;
         other.size_   = 0;
+        ledger_       = other.ledger_;
     }
     return *this;
 }
 
 void UnifiedBuffer::allocate(size_t size) {
+    recordAllocation(size <= size_);
     if (size > size_) {
         free();
         CHECK(cudaMallocManaged(&host_, size));  // < 分配统一内存
         device_ = host_;                         // < 设备内存和主机内存共享同一指针
         size_   = size;
+        track(static_cast<int64_t>(size_));
     }
 }
 
@@ -162,6 +216,7 @@ void UnifiedBuffer::free() {
     if (host_) CHECK(cudaFree(host_));  // < 释放统一内存
     host_   = nullptr;
     device_ = nullptr;
+    track(-static_cast<int64_t>(size_));
     size_   = 0;
 }
 
@@ -186,6 +241,7 @@ MappedBuffer::MappedBuffer(MappedBuffer&& other) noexcept
     other.host_   = nullptr;
     other.device_ = nullptr;
     other.size_   = 0;
+    ledger_       = other.ledger_;  // < 已分配的字节数仍记在原账本上
 }
 
 MappedBuffer& MappedBuffer::operator=(MappedBuffer&& other) noexcept {
@@ -197,16 +253,19 @@ MappedBuffer& MappedBuffer::operator=(MappedBuffer&& other) noexcept {
         other.host_   = nullptr;
         other.device_ = nullptr;
         other.size_   = 0;
+        ledger_       = other.ledger_;
     }
     return *this;
 }
 
 void MappedBuffer::allocate(size_t size) {
+    recordAllocation(size <= size_);
     if (size > size_) {
         free();
         CHECK(cudaHostAlloc(&host_, size, cudaHostAllocMapped));  // < 分配映射内存
         CHECK(cudaHostGetDevicePointer(&device_, host_, 0));      // < 获取设备指针
         size_ = size;
+        track(static_cast<int64_t>(size_));
     }
 }
 
@@ -214,6 +273,7 @@ void MappedBuffer::free() {
     if (host_) CHECK(cudaFreeHost(host_));  // < 释放映射内存
     host_   = nullptr;
     device_ = nullptr;
+    track(-static_cast<int64_t>(size_));
     size_   = 0;
 }
 
@@ -233,19 +293,26 @@ void MappedBuffer::hostToDevice(cudaStream_t stream) {}
 
 void MappedBuffer::deviceToHost(cudaStream_t stream) {}
 
-std::unique_ptr<BaseBuffer> BufferFactory::createBuffer(BufferType type) {
+std::unique_ptr<BaseBuffer> BufferFactory::createBuffer(BufferType type, std::shared_ptr<MemoryLedger> ledger) {
+    std::unique_ptr<BaseBuffer> buffer;
     switch (type) {
         case BufferType::Device:
-            return std::make_unique<DeviceBuffer>();             // < 创建设备内存
+            buffer = std::make_unique<DeviceBuffer>();           // < 创建设备内存
+            break;
         case BufferType::Discrete:
-            return std::make_unique<DiscreteBuffer>();           // < 创建分离内存
+            buffer = std::make_unique<DiscreteBuffer>();         // < 创建分离内存
+            break;
         case BufferType::Unified:
-            return std::make_unique<UnifiedBuffer>();            // < 创建统一内存
+            buffer = std::make_unique<UnifiedBuffer>();          // < 创建统一内存
+            break;
         case BufferType::Mapped:
-            return std::make_unique<MappedBuffer>();             // < 创建映射内存
+            buffer = std::make_unique<MappedBuffer>();           // < 创建映射内存
+            break;
         default:
             throw std::invalid_argument("Unknown buffer type");  // < 未知的缓冲区类型
     }
+    buffer->setLedger(std::move(ledger));
+    return buffer;
 }
 
 }  // namespace trtyolo
@@ -12,12 +12,56 @@
 
 #include <NvInferRuntime.h>
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <numeric>
 #include <string>
 
 namespace trtyolo {
 
+/**
+ * @brief Buffer 类型枚举，用于选择不同类型的 Buffer
+ *
+ */
+enum class BufferType {
+    Device,    // < 设备内存
+    Discrete,  // < 分离内存（主机和设备都有内存）
+    Unified,   // < 统一内存（设备和主机共享内存）
+    Mapped     // < 映射内存（用于NVIDIA集成设备）
+};
+
+/**
+ * @brief 内存账本，按 Buffer 类型统计当前和峰值字节数
+ *
+ * 每个 Buffer 的分配和释放都会计入进程级账本，设置了所属账本时同时计入所属账本（例如每个后端一个账本）。
+ * 字节数为 Buffer 的分配大小：分离内存在设备和锁页主机上各占用该字节数，映射内存只占用锁页主机内存。
+ * 所有方法都是线程安全的。
+ */
+class MemoryLedger {
+public:
+    static constexpr size_t kTypeCount = 4;  // < Buffer 类型数量
+
+    static MemoryLedger& global();  // < 获取进程级账本
+
+    void   track(BufferType type, int64_t delta) noexcept;  // < 记录一次分配（delta > 0）或释放（delta < 0）
+    size_t current(BufferType type) const noexcept;         // < 获取该类型当前占用的字节数
+    size_t peak(BufferType type) const noexcept;            // < 获取该类型占用的峰值字节数
+    size_t currentTotal() const noexcept;                   // < 获取所有类型当前占用的字节数
+    size_t peakTotal() const noexcept;                      // < 获取所有类型合计占用的峰值字节数
+
+private:
+    struct Counter {
+        std::atomic<int64_t> current{0};  // < 当前字节数
+        std::atomic<int64_t> peak{0};     // < 峰值字节数
+
+        void add(int64_t delta) noexcept;
+    };
+
+    std::array<Counter, kTypeCount> types_;  // < 各类型的统计
+    Counter                         total_;  // < 所有类型合计的统计
+};
+
 /**
  * @brief 抽象基类 Buffer，用于管理内存操作
  *
@@ -26,6 +70,20 @@ class BaseBuffer {
 public:
     virtual ~BaseBuffer() = default;
 
+    /**
+     * @brief 获取 Buffer 类型
+     *
+     * @return BufferType Buffer 类型
+     */
+    virtual BufferType type() const = 0;
+
+    /**
+     * @brief 设置所属账本，之后的分配和释放同时计入该账本
+     *
+     * @param ledger 所属账本，为空时只计入进程级账本
+     */
+    void setLedger(std::shared_ptr<MemoryLedger> ledger) { ledger_ = std::move(ledger); }
+
     /**
      * @brief 分配内存
      *
@@ -73,6 +131,16 @@ public:
      * @param stream CUDA流
      */
     virtual void deviceToHost(cudaStream_t stream = nullptr) = 0;
+
+protected:
+    /**
+     * @brief 将分配（delta > 0）或释放（delta < 0）的字节数计入进程级账本和所属账本
+     *
+     * @param delta 字节数变化
+     */
+    void track(int64_t delta) noexcept;
+
+    std::shared_ptr<MemoryLedger> ledger_;  // < 所属账本
 };
 
 /**
@@ -88,13 +156,14 @@ public:
     DeviceBuffer& operator=(DeviceBuffer&& other) noexcept;
     ~DeviceBuffer() { free(); }
 
-    void   allocate(size_t size) override;
-    void   free() override;
-    void*  device() override;
-    void*  host() override;
-    size_t size() const override;
-    void   hostToDevice(cudaStream_t stream = nullptr) override;
-    void   deviceToHost(cudaStream_t stream = nullptr) override;
+    BufferType type() const override { return BufferType::Device; }
+    void       allocate(size_t size) override;
+    void       free() override;
+    void*      device() override;
+    void*      host() override;
+    size_t     size() const override;
+    void       hostToDevice(cudaStream_t stream = nullptr) override;
+    void       deviceToHost(cudaStream_t stream = nullptr) override;
 
 private:
     void*  device_;  // < 设备内存指针
@@ -114,13 +183,14 @@ public:
     DiscreteBuffer& operator=(DiscreteBuffer&& other) noexcept;
     ~DiscreteBuffer() { free(); }
 
-    void   allocate(size_t size) override;
-    void   free() override;
-    void*  device() override;
-    void*  host() override;
-    size_t size() const override;
-    void   hostToDevice(cudaStream_t stream = nullptr) override;
-    void   deviceToHost(cudaStream_t stream = nullptr) override;
+    BufferType type() const override { return BufferType::Discrete; }
+    void       allocate(size_t size) override;
+    void       free() override;
+    void*      device() override;
+    void*      host() override;
+    size_t     size() const override;
+    void       hostToDevice(cudaStream_t stream = nullptr) override;
+    void       deviceToHost(cudaStream_t stream = nullptr) override;
 
 private:
     void*  host_;    // < 主机内存指针
@@ -141,13 +211,14 @@ public:
     UnifiedBuffer& operator=(UnifiedBuffer&& other) noexcept;
     ~UnifiedBuffer() { free(); }
 
-    void   allocate(size_t size) override;
-    void   free() override;
-    void*  device() override;
-    void*  host() override;
-    size_t size() const override;
-    void   hostToDevice(cudaStream_t stream = nullptr) override;
-    void   deviceToHost(cudaStream_t stream = nullptr) override;
+    BufferType type() const override { return BufferType::Unified; }
+    void       allocate(size_t size) override;
+    void       free() override;
+    void*      device() override;
+    void*      host() override;
+    size_t     size() const override;
+    void       hostToDevice(cudaStream_t stream = nullptr) override;
+    void       deviceToHost(cudaStream_t stream = nullptr) override;
 
 private:
     void*  host_;    // < 主机内存指针
@@ -168,13 +239,14 @@ public:
     MappedBuffer& operator=(MappedBuffer&& other) noexcept;
     ~MappedBuffer() { free(); }
 
-    void   allocate(size_t size) override;
-    void   free() override;
-    void*  device() override;
-    void*  host() override;
-    size_t size() const override;
-    void   hostToDevice(cudaStream_t stream = nullptr) override;
-    void   deviceToHost(cudaStream_t stream = nullptr) override;
+    BufferType type() const override { return BufferType::Mapped; }
+    void       allocate(size_t size) override;
+    void       free() override;
+    void*      device() override;
+    void*      host() override;
+    size_t     size() const override;
+    void       hostToDevice(cudaStream_t stream = nullptr) override;
+    void       deviceToHost(cudaStream_t stream = nullptr) override;
 
 private:
     void*  host_;    // < 主机内存指针
@@ -182,17 +254,6 @@ private:
     size_t size_;    // < 内存大小
 };
 
-/**
- * @brief Buffer 类型枚举，用于选择不同类型的 Buffer
- *
- */
-enum class BufferType {
-    Device,    // < 设备内存
-    Discrete,  // < 分离内存（主机和设备都有内存）
-    Unified,   // < 统一内存（设备和主机共享内存）
-    Mapped     // < 映射内存（用于NVIDIA集成设备）
-};
-
 /**
  * @brief Buffer 工厂类，根据类型创建不同的 Buffer
  *
@@ -203,9 +264,10 @@ public:
      * @brief 创建指定类型的 Buffer
      *
      * @param type 要创建的 Buffer 类型
+     * @param ledger 所属账本，为空时只计入进程级账本
      * @return 指定类型的 Buffer 智能指针
      */
-    static std::unique_ptr<BaseBuffer> createBuffer(BufferType type);
+    static std::unique_ptr<BaseBuffer> createBuffer(BufferType type, std::shared_ptr<MemoryLedger> ledger = nullptr);
 };
 
 /**
@@ -230,10 +292,13 @@ public:
      * @param shape 张量形状
      * @param dtype 张量数据类型
      * @param input 是否为输入张量
+     * @param buffer_type 张量内存的 Buffer 类型
+     * @param ledger 张量内存所属的账本
      */
-    TensorInfo(const std::string name, const nvinfer1::Dims& shape, const nvinfer1::DataType dtype, const bool input, BufferType buffer_type)
+    TensorInfo(const std::string name, const nvinfer1::Dims& shape, const nvinfer1::DataType dtype, const bool input, BufferType buffer_type,
+               std::shared_ptr<MemoryLedger> ledger = nullptr)
         : name(name), shape(shape), dtype_(dtype), input(input) {
-        buffer = BufferFactory::createBuffer(buffer_type);
+        buffer = BufferFactory::createBuffer(buffer_type, std::move(ledger));
         update();
     }
 
@@ -246,6 +311,12 @@ public:
         buffer->allocate(bytes_);
     }
 
+    /**
+     * @brief 获取张量当前形状对应的字节数
+     *
+     */
+    size_t bytes() const { return bytes_; }
+
 private:
     /**
      * @brief 将数据类型转换为字节数
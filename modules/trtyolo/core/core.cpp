@@ -8,6 +8,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "core.hpp"
 #include "utils/common.hpp"
 
@@ -127,6 +129,10 @@ nvinfer1::Dims TRTManager::getProfileShape(char const* tensorName, int32_t profi
     return engine_->getProfileShape(tensorName, profileIndex, select);
 }
 
+int32_t TRTManager::getNbOptimizationProfiles() const noexcept {
+    return engine_->getNbOptimizationProfiles();
+}
+
 int32_t TRTManager::getNbIOTensors() const noexcept {
     return engine_->getNbIOTensors();
 }
@@ -167,15 +173,27 @@ void CudaGraph::launch(cudaStream_t stream) {
 }
 
 void CudaGraph::initializeNodes(size_t num) {
-    // 如果节点数量为0，自动获取图中的节点数量
-    if (num == 0) {
-        CHECK(cudaGraphGetNodes(graph_, nullptr, &num));
+    // 获取图中的所有节点
+    size_t total = 0;
+    CHECK(cudaGraphGetNodes(graph_, nullptr, &total));
+    auto all_nodes = std::make_unique<cudaGraphNode_t[]>(total);
+    if (total > 0) CHECK(cudaGraphGetNodes(graph_, all_nodes.get(), &total));
+
+    // 跳过事件记录节点（性能分析插入的阶段计时事件），保证内核和 memcpy 节点的索引不受影响
+    size_t count = 0;
+    for (size_t i = 0; i < total; ++i) {
+        cudaGraphNodeType nodeType;
+        CHECK(cudaGraphNodeGetType(all_nodes[i], &nodeType));
+        if (nodeType != cudaGraphNodeTypeEventRecord) all_nodes[count++] = all_nodes[i];
     }
 
+    // 如果节点数量为0，使用图中全部的非事件节点
+    if (num == 0 || num > count) num = count;
+
     if (num > 0) {
         // 为节点分配内存
         nodes_ = std::make_unique<cudaGraphNode_t[]>(num);
-        CHECK(cudaGraphGetNodes(graph_, nodes_.get(), &num));
+        std::copy(all_nodes.get(), all_nodes.get() + num, nodes_.get());
     } else {
         // 如果图中没有节点，抛出异常
         throw std::runtime_error("Failed to initialize nodes: graph has no nodes.");
@@ -143,6 +143,12 @@ public:
      */
     nvinfer1::Dims getProfileShape(char const* tensorName, int32_t profileIndex, nvinfer1::OptProfileSelector select) const noexcept;
 
+    /**
+     * @brief 获取优化配置文件的数量。
+     * @return int32_t 优化配置文件的数量。
+     */
+    int32_t getNbOptimizationProfiles() const noexcept;
+
     /**
      * @brief 获取输入输出张量的数量。
      * @return int32_t 输入输出张量的数量。
@@ -216,6 +222,7 @@ public:
      * @brief 初始化图中的节点
      *
      * 获取并初始化 CUDA 图中的节点。如果 `num` 为 0，则自动获取节点数。
+     * 事件记录节点（用于阶段计时）不计入索引。
      *
      * @param num 要初始化的节点数量。
      * @throws std::runtime_error 如果图中没有节点。
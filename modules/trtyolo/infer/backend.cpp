@@ -12,10 +12,37 @@
 #include <cstring>
 
 #include "backend.hpp"
+#include "utils/trace.hpp"
 
 namespace trtyolo {
 
-TrtBackend::TrtBackend(const std::string& trt_engine_file, const InferConfig& infer_config) : infer_config(infer_config) {
+namespace {
+
+/**
+ * @brief 将输入图像依次拷贝到连续的暂存缓冲区
+ *
+ * 源地址首尾相接的相邻图像（例如同一个连续的 (N, H, W, C) 数组中的图像）合并为一次拷贝，
+ * 整个批量位于同一块连续内存时只需要一次 memcpy。
+ *
+ * @param inputs 输入图像
+ * @param sizes 每张图像需要拷贝的字节数
+ * @param dst 暂存缓冲区
+ */
+void stageInputs(const std::vector<Image>& inputs, const std::vector<int>& sizes, uint8_t* dst) {
+    size_t idx = 0;
+    while (idx < inputs.size()) {
+        auto*  src   = static_cast<const uint8_t*>(inputs[idx].ptr);
+        size_t bytes = sizes[idx];
+        for (++idx; idx < inputs.size() && inputs[idx].ptr == src + bytes; ++idx) bytes += sizes[idx];
+        std::memcpy(dst, src, bytes);
+        dst += bytes;
+    }
+}
+
+}  // namespace
+
+TrtBackend::TrtBackend(const std::string& trt_engine_file, const InferConfig& infer_config, TaskType task)
+    : infer_config(infer_config), task(task) {
     cudaSetDevice(infer_config.device_id);  // < 设置设备
     CHECK(cudaStreamCreate(&stream));       // < 创建 stream
 
@@ -45,6 +72,7 @@ TrtBackend::TrtBackend(const std::string& trt_engine_file, const InferConfig& in
 std::unique_ptr<TrtBackend> TrtBackend::clone() {
     auto clone_backend          = std::make_unique<TrtBackend>();
     clone_backend->infer_config = infer_config;
+    clone_backend->task         = task;
 
     cudaSetDevice(infer_config.device_id);            // < 设置设备
     CHECK(cudaStreamCreate(&clone_backend->stream));  // < 创建 stream
@@ -70,6 +98,9 @@ TrtBackend::~TrtBackend() {
     std::vector<TensorInfo>().swap(tensor_infos);
     std::vector<Transform>().swap(transforms);
     if (!dynamic) cuda_graph_.destroy();
+    for (auto& event : stage_events_) {
+        if (event) CHECK(cudaEventDestroy(event));
+    }
     CHECK(cudaStreamDestroy(stream));
 }
 
@@ -77,11 +108,27 @@ void TrtBackend::getTensorInfo() {
     std::vector<TensorInfo>().swap(tensor_infos);
     buffer_type_     = infer_config.enable_managed_memory ? BufferType::Unified : (zero_copy_ ? BufferType::Mapped : BufferType::Discrete);
     auto num_tensors = manager_->getNbIOTensors();
+
+    // 按名称将输出张量绑定到任务的输出角色
+    std::vector<std::string> names(num_tensors);
+    std::vector<bool>        inputs(num_tensors);
+    for (auto i = 0; i < num_tensors; ++i) {
+        names[i]  = std::string(manager_->getIOTensorName(i));
+        inputs[i] = (manager_->getTensorIOMode(names[i].c_str()) == nvinfer1::TensorIOMode::kINPUT);
+    }
+    outputs_ = bindOutputs(task, names, inputs);
+
+    // 任务不使用的输出张量（如 NMS 的索引输出）只分配设备内存，不拷贝回主机；未知任务保留所有输出
+    std::vector<bool> used(num_tensors, task == TaskType::Unknown);
+    for (int index : outputs_) {
+        if (index >= 0) used[index] = true;
+    }
+
     for (auto i = 0; i < num_tensors; ++i) {
-        std::string name  = std::string(manager_->getIOTensorName(i));
-        auto        shape = manager_->getTensorShape(name.c_str());
-        auto        dtype = manager_->getTensorDataType(name.c_str());
-        bool        input = (manager_->getTensorIOMode(name.c_str()) == nvinfer1::TensorIOMode::kINPUT);
+        const std::string& name  = names[i];
+        auto               shape = manager_->getTensorShape(name.c_str());
+        auto               dtype = manager_->getTensorDataType(name.c_str());
+        bool               input = inputs[i];
 
         if (input) {
             dynamic = std::any_of(shape.d, shape.d + shape.nbDims, [](int val) { return val == -1; });
@@ -95,14 +142,21 @@ void TrtBackend::getTensorInfo() {
         } else if (!input && dynamic) {
             shape.d[0] = max_shape.x;
         }
-        tensor_infos.emplace_back(name, shape, dtype, input, input ? BufferType::Device : buffer_type_);
+        tensor_infos.emplace_back(name, shape, dtype, input, (input || !used[i]) ? BufferType::Device : buffer_type_, memory_ledger_);
     }
 }
 
 void TrtBackend::initialize() {
     // 清空并释放transforms和image_buffers_中的资源
     std::vector<Transform>().swap(transforms);
-    inputs_buffer_ = BufferFactory::createBuffer(buffer_type_);
+    inputs_buffer_ = BufferFactory::createBuffer(buffer_type_, memory_ledger_);
+
+    // 启用性能报告时创建阶段边界事件
+    if (infer_config.enable_performance_report) {
+        for (auto& event : stage_events_) {
+            if (!event) CHECK(cudaEventCreate(&event));
+        }
+    }
 
     infer_size_ = max_shape.y * max_shape.w * max_shape.z;
 
@@ -180,31 +234,38 @@ void TrtBackend::captureCudaGraph() {
 
     // Step 2: Begin CUDA Graph Capture
     cuda_graph_.beginCapture(stream);
+    markStage(0, true);
 
     // Step 3: Perform memory transfer and LetterBox based on configuration
     if (infer_config.cuda_mem) {
+        markStage(1, true);
+
         int input_width  = infer_config.input_shape ? infer_config.input_shape->y : max_shape.w;
         int input_height = infer_config.input_shape ? infer_config.input_shape->x : max_shape.z;
         letterbox(false, input_width, input_height);
     } else {
         inputs_buffer_->hostToDevice(stream);
+        markStage(1, true);
 
         int input_width  = infer_config.input_shape ? infer_config.input_shape->y : max_shape.w;
         int input_height = infer_config.input_shape ? infer_config.input_shape->x : max_shape.z;
         letterbox(infer_config.input_shape.has_value(), input_width, input_height);
     }
+    markStage(2, true);
 
     // Step 4: Enqueue inference
     if (!manager_->enqueueV3(stream)) {
         throw std::runtime_error("captureCudaGraph: EnqueueV3 failed when graph creation.");
     }
+    markStage(3, true);
 
-    // Step 5: Copy output tensors to host if required
+    // Step 5: Copy output tensors to host if required (unused outputs are device-only and add no node)
     for (auto& tensor_info : tensor_infos) {
         if (!tensor_info.input) {
             tensor_info.buffer->deviceToHost(stream);
         }
     }
+    markStage(4, true);
 
     // Step 6: End CUDA Graph Capture
     cuda_graph_.endCapture(stream);
@@ -225,6 +286,8 @@ void TrtBackend::staticInfer(const std::vector<Image>& inputs) {
         throw std::invalid_argument("Number of inputs out of range");
     }
 
+    auto staging_start = TraceRecorder::now();
+
     if (infer_config.input_shape.has_value()) {
         if (infer_config.cuda_mem) {
             for (int idx = 0; idx < num; ++idx) {
@@ -246,9 +309,7 @@ void TrtBackend::staticInfer(const std::vector<Image>& inputs) {
                 cuda_graph_.updateKernelNodeParams(idx, kernelParams);
             }
         } else {
-            for (auto idx = 0; idx < num; ++idx) {
-                std::memcpy(static_cast<uint8_t*>(inputs_buffer_->host()) + idx * input_size_, inputs[idx].ptr, input_size_);
-            }
+            stageInputs(inputs, std::vector<int>(num, input_size_), static_cast<uint8_t*>(inputs_buffer_->host()));
         }
     } else {
         if (!infer_config.cuda_mem) {
@@ -263,12 +324,7 @@ void TrtBackend::staticInfer(const std::vector<Image>& inputs) {
 
             // 在主机内存中分配空间并拷贝数据
             inputs_buffer_->allocate(total_size);
-            uint8_t* input_ptr = static_cast<uint8_t*>(inputs_buffer_->host());
-
-            for (int idx = 0; idx < num; ++idx) {
-                std::memcpy(input_ptr, inputs[idx].ptr, input_sizes[idx]);
-                input_ptr += input_sizes[idx];
-            }
+            stageInputs(inputs, input_sizes, static_cast<uint8_t*>(inputs_buffer_->host()));
 
             // 更新 Memcpy 节点
             if (buffer_type_ == BufferType::Discrete) {
@@ -305,7 +361,10 @@ void TrtBackend::staticInfer(const std::vector<Image>& inputs) {
         }
     }
 
+    finishStaging(staging_start);
+
     // Launch the CUDA graph
+    TraceScope trace("gpu");
     cuda_graph_.launch(stream);
 }
 
@@ -327,14 +386,20 @@ void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
         }
     }
 
+    auto staging_start = TraceRecorder::now();
+    staging_ms_        = 0.f;
+
     if (infer_config.input_shape.has_value()) {
         // 2. 处理静态输入形状
         if (!infer_config.cuda_mem) {
-            for (int idx = 0; idx < num; ++idx) {
-                std::memcpy(static_cast<uint8_t*>(inputs_buffer_->host()) + idx * input_size_, inputs[idx].ptr, input_size_);
-            }
+            stageInputs(inputs, std::vector<int>(num, input_size_), static_cast<uint8_t*>(inputs_buffer_->host()));
+            finishStaging(staging_start);
+            markStage(0);
             inputs_buffer_->hostToDevice(stream);
+        } else {
+            markStage(0);
         }
+        markStage(1);
 
         for (int idx = 0; idx < num; ++idx) {
             cudaLetterbox(
@@ -364,16 +429,15 @@ void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
         if (!infer_config.cuda_mem) {
             // 在主机内存中分配空间并拷贝数据
             inputs_buffer_->allocate(total_size);
-            uint8_t* input_host = static_cast<uint8_t*>(inputs_buffer_->host());
 
             // 拷贝输入数据到主机内存
-            for (int idx = 0; idx < num; ++idx) {
-                std::memcpy(input_host, inputs[idx].ptr, input_sizes[idx]);
-                input_host += input_sizes[idx];
-            }
+            stageInputs(inputs, input_sizes, static_cast<uint8_t*>(inputs_buffer_->host()));
+            finishStaging(staging_start);
 
             // 拷贝到设备内存
+            markStage(0);
             inputs_buffer_->hostToDevice(stream);
+            markStage(1);
 
             // 在设备内存中进行 LetterBox 操作
             uint8_t* input_device = static_cast<uint8_t*>(inputs_buffer_->device());
@@ -393,6 +457,8 @@ void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
             }
         } else {
             // 直接在设备内存上进行 LetterBox 操作
+            markStage(0);
+            markStage(1);
             for (int idx = 0; idx < num; ++idx) {
                 cudaLetterbox(
                     inputs[idx].ptr,
@@ -410,9 +476,12 @@ void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
     }
 
     // 推理
+    TraceScope trace("gpu");
+    markStage(2);
     if (!manager_->enqueueV3(stream)) {
         throw std::runtime_error("Infer Error.");
     }
+    markStage(3);
 
     // 数据拷贝从设备到主机
     for (auto& tensor_info : tensor_infos) {
@@ -420,11 +489,73 @@ void TrtBackend::dynamicInfer(const std::vector<Image>& inputs) {
             tensor_info.buffer->deviceToHost(stream);
         }
     }
+    markStage(4);
 
     // 同步流，确保所有 CUDA 操作完成
     CHECK(cudaStreamSynchronize(stream));
 }
 
+void TrtBackend::finishStaging(int64_t start_ns) {
+    auto end_ns = TraceRecorder::now();
+    staging_ms_ = static_cast<float>(end_ns - start_ns) / 1e6f;
+    TraceRecorder::instance().record("staging", start_ns, end_ns);
+}
+
+void TrtBackend::markStage(size_t index, bool capture) {
+    if (!stage_events_[index]) return;
+    // 捕获时以外部事件记录，使事件成为 CUDA 图中的节点，每次启动图时都会记录
+    if (capture) {
+        CHECK(cudaEventRecordWithFlags(stage_events_[index], stream, cudaEventRecordExternal));
+    } else {
+        CHECK(cudaEventRecord(stage_events_[index], stream));
+    }
+}
+
+StageTimes TrtBackend::stageTimes() const {
+    StageTimes times;
+    if (!stage_events_.front()) return times;
+
+    auto elapsed = [&](size_t begin) {
+        float ms{0.0F};
+        CHECK(cudaEventElapsedTime(&ms, stage_events_[begin], stage_events_[begin + 1]));
+        return ms;
+    };
+
+    times.staging   = staging_ms_;
+    times.h2d       = elapsed(0);
+    times.letterbox = elapsed(1);
+    times.inference = elapsed(2);
+    times.d2h       = elapsed(3);
+    return times;
+}
+
+TensorInfo& TrtBackend::output(OutputRole role) {
+    int index = outputs_[static_cast<size_t>(role)];
+    if (index < 0) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("TrtBackend: output role is not bound for task " + taskTypeToString(task)));
+    }
+    return tensor_infos[index];
+}
+
+OutputViews TrtBackend::outputViews() const {
+    OutputViews views;
+    for (size_t role = 0; role < outputs_.size(); ++role) {
+        int index = outputs_[role];
+        if (index < 0) continue;
+
+        const auto& tensor_info = tensor_infos[index];
+        auto&       view        = views.views[role];
+        view.data               = tensor_info.buffer->host();
+        for (int d = 0; d < std::min(tensor_info.shape.nbDims, 4); ++d) view.shape[d] = tensor_info.shape.d[d];
+        view.item_bytes = tensor_info.shape.d[0] > 0 ? tensor_info.bytes() / tensor_info.shape.d[0] : 0;
+    }
+    return views;
+}
+
+const Transform& TrtBackend::transform(size_t idx) const {
+    return infer_config.input_shape.has_value() ? transforms.front() : transforms[idx];
+}
+
 void TrtBackend::infer(const std::vector<Image>& inputs) {
     cudaSetDevice(infer_config.device_id);  // 推理前切换设备
 
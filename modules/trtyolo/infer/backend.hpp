@@ -12,6 +12,7 @@
 
 #include <NvInferRuntime.h>
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -19,11 +20,24 @@
 #include "core/buffer.hpp"
 #include "core/core.hpp"
 #include "letterbox.hpp"
+#include "postprocess.hpp"
+#include "schema.hpp"
 #include "trtyolo.hpp"
 #include "utils/common.hpp"
 
 namespace trtyolo {
 
+/**
+ * @brief 单次推理中各阶段的耗时（毫秒），仅在启用性能报告时记录。
+ */
+struct StageTimes {
+    float staging   = 0.f;  // < 输入拷贝到主机暂存缓冲区（CPU）
+    float h2d       = 0.f;  // < 主机到设备拷贝（GPU）
+    float letterbox = 0.f;  // < LetterBox 预处理（GPU）
+    float inference = 0.f;  // < 引擎推理（GPU）
+    float d2h       = 0.f;  // < 设备到主机拷贝（GPU）
+};
+
 /**
  * @brief TensorRT 后端类，用于执行推理操作。
  */
@@ -34,8 +48,9 @@ public:
      *
      * @param trt_engine_file TensorRT 引擎文件路径。
      * @param infer_config 推理配置指针。
+     * @param task 任务类型，用于按名称绑定输出张量；任务不使用的输出张量不会拷贝回主机。
      */
-    TrtBackend(const std::string& trt_engine_file, const InferConfig& infer_config);
+    TrtBackend(const std::string& trt_engine_file, const InferConfig& infer_config, TaskType task = TaskType::Unknown);
 
     /**
      * @brief 默认构造函数。
@@ -61,6 +76,45 @@ public:
      */
     void infer(const std::vector<Image>& inputs);
 
+    /**
+     * @brief 获取最近一次推理各阶段的耗时。
+     *
+     * 阶段边界由 CUDA 事件标记（静态模型时事件被捕获进 CUDA 图），推理结束时流已同步，读取不会额外阻塞。
+     *
+     * @return StageTimes 各阶段耗时，未启用性能报告时全部为 0。
+     */
+    StageTimes stageTimes() const;
+
+    /**
+     * @brief 获取任务输出角色对应的张量。
+     *
+     * @param role 输出角色。
+     * @return TensorInfo& 绑定到该角色的张量信息。
+     */
+    TensorInfo& output(OutputRole role);
+
+    /**
+     * @brief 获取所有输出角色在主机上的张量视图，供后处理和捕获使用。
+     *
+     * @return OutputViews 张量视图，未绑定的角色为空视图。
+     */
+    OutputViews outputViews() const;
+
+    /**
+     * @brief 获取批量中第 idx 张图像的仿射变换（固定输入尺寸时所有图像共用同一个变换）。
+     *
+     * @param idx 图像在批量中的下标。
+     * @return const Transform& 仿射变换。
+     */
+    const Transform& transform(size_t idx) const;
+
+    /**
+     * @brief 获取后端的内存账本，按 Buffer 类型统计张量缓冲区和输入暂存缓冲区的当前和峰值字节数。
+     *
+     * @return const MemoryLedger& 内存账本。
+     */
+    const MemoryLedger& memoryLedger() const { return *memory_ledger_; }
+
     cudaStream_t            stream;        // < CUDA 流
     InferConfig             infer_config;  // < 推理选项
     std::vector<TensorInfo> tensor_infos;  // < 张量信息向量
@@ -68,6 +122,7 @@ public:
     int4                    min_shape;     // < 最小形状
     int4                    max_shape;     // < 最大形状
     bool                    dynamic;       // < 是否为动态形状
+    TaskType                task;          // < 任务类型
 
 private:
     void getTensorInfo();
@@ -75,16 +130,22 @@ private:
     void captureCudaGraph();
     void dynamicInfer(const std::vector<Image>& inputs);
     void staticInfer(const std::vector<Image>& inputs);
-
-    std::unique_ptr<TRTManager> manager_;        // < TensorRT 管理器对象的智能指针
-    CudaGraph                   cuda_graph_;     // < CUDA 图
-    std::unique_ptr<BaseBuffer> inputs_buffer_;  // < 输入缓冲区智能指针
-    BufferType                  buffer_type_;    // < 缓冲区类型
-
-    bool zero_copy_;                             // < 是否为零拷贝
-
-    int input_size_;                             // < 输入大小
-    int infer_size_;                             // < 推理大小
+    void markStage(size_t index, bool capture = false);
+    void finishStaging(int64_t start_ns);
+
+    std::unique_ptr<TRTManager>   manager_;          // < TensorRT 管理器对象的智能指针
+    CudaGraph                     cuda_graph_;       // < CUDA 图
+    std::unique_ptr<BaseBuffer>   inputs_buffer_;    // < 输入缓冲区智能指针
+    BufferType                    buffer_type_;      // < 缓冲区类型
+    std::shared_ptr<MemoryLedger> memory_ledger_{std::make_shared<MemoryLedger>()};  // < 本后端所有缓冲区的内存账本
+    OutputBinding                 outputs_;          // < 输出角色到 tensor_infos 下标的映射
+    std::array<cudaEvent_t, 5>    stage_events_{};   // < 阶段边界事件：H2D 前、LetterBox 前、推理前、D2H 前、D2H 后
+    float                         staging_ms_{0.f};  // < 最近一次主机暂存拷贝耗时
+
+    bool zero_copy_;                                 // < 是否为零拷贝
+
+    int input_size_;                                 // < 输入大小
+    int infer_size_;                                 // < 推理大小
 };
 
 }  // namespace trtyolo
\ No newline at end of file
@@ -0,0 +1,480 @@
+/**
+ * @file capture.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 推理捕获的写入、内存映射读取和离线重放
+ * @date 2025-07-08
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include "capture.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector_functions.hpp>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "backend.hpp"
+#include "postprocess.hpp"
+#include "utils/common.hpp"
+
+namespace trtyolo {
+
+namespace {
+
+size_t alignUp(size_t value) {
+    return (value + kCaptureAlignment - 1) / kCaptureAlignment * kCaptureAlignment;
+}
+
+uint64_t mix(uint64_t hash, uint64_t word) {
+    hash ^= word;
+    hash *= 0xff51afd7ed558ccdULL;
+    return hash ^ (hash >> 32);
+}
+
+template <typename T>
+T* at(std::vector<char>& buffer, size_t offset) {
+    return reinterpret_cast<T*>(buffer.data() + offset);
+}
+
+}  // namespace
+
+uint64_t captureHash(const void* data, int width, int height, int channels, size_t pitch) {
+    const auto* bytes     = static_cast<const uint8_t*>(data);
+    size_t      row_bytes = static_cast<size_t>(width) * channels;
+
+    uint64_t hash = mix(0x9e3779b97f4a7c15ULL, (static_cast<uint64_t>(width) << 32) | static_cast<uint32_t>(height));
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = bytes + y * pitch;
+        size_t         x   = 0;
+        for (; x + 8 <= row_bytes; x += 8) {
+            uint64_t word;
+            std::memcpy(&word, row + x, 8);
+            hash = mix(hash, word);
+        }
+        if (x < row_bytes) {
+            uint64_t word = 0;
+            std::memcpy(&word, row + x, row_bytes - x);
+            hash = mix(hash, word);
+        }
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash ? hash : 1;  // 0 保留给未计算哈希的图像
+}
+
+CaptureWriter& CaptureWriter::instance() {
+    static CaptureWriter writer;
+    return writer;
+}
+
+void CaptureWriter::start(const std::string& file, bool frames) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_.store(false, std::memory_order_release);
+    if (out_.is_open()) out_.close();
+
+    out_.open(file, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) {
+        throw std::runtime_error("Failed to open file: " + file + " to write.");
+    }
+
+    CaptureFileHeader header{};
+    std::memcpy(header.magic, kCaptureMagic, sizeof(header.magic));
+    header.version   = kCaptureVersion;
+    header.alignment = kCaptureAlignment;
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_.flush();
+    if (!out_) {
+        out_.close();
+        throw std::runtime_error("Failed to write file: " + file + ".");
+    }
+
+    records_.store(0, std::memory_order_relaxed);
+    frames_.store(frames, std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void CaptureWriter::stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_.store(false, std::memory_order_release);
+    if (out_.is_open()) out_.close();
+}
+
+void CaptureWriter::write(uint32_t model_id, const TrtBackend& backend, const std::vector<Image>& images) {
+    const auto& schema  = outputSchema(backend.task);
+    auto        outputs = backend.outputViews();
+    bool        frames  = frames_.load(std::memory_order_relaxed) && !backend.infer_config.cuda_mem;
+    size_t      num     = images.size();
+
+    // 计算记录布局：记录头、条目表，然后是按 64 字节对齐的数据块
+    size_t images_offset  = sizeof(CaptureRecordHeader);
+    size_t tensors_offset = images_offset + num * sizeof(CaptureImageEntry);
+    size_t offset         = alignUp(tensors_offset + schema.size() * sizeof(CaptureTensorEntry));
+
+    std::vector<size_t> image_offsets(num, 0);
+    if (frames) {
+        for (size_t i = 0; i < num; ++i) {
+            image_offsets[i]  = offset;
+            offset           += alignUp(static_cast<size_t>(images[i].width) * images[i].height * images[i].channels);
+        }
+    }
+
+    std::vector<size_t> tensor_offsets(schema.size(), 0);
+    for (size_t i = 0; i < schema.size(); ++i) {
+        tensor_offsets[i]  = offset;
+        offset            += alignUp(outputs[schema[i]].item_bytes * num);
+    }
+
+    // 每个线程复用自己的组装缓冲区，避免每次调用重新分配
+    thread_local std::vector<char> buffer;
+    buffer.assign(offset, 0);
+
+    auto* header         = at<CaptureRecordHeader>(buffer, 0);
+    header->magic        = kCaptureRecordMagic;
+    header->task         = static_cast<uint32_t>(backend.task);
+    header->record_bytes = offset;
+    header->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    header->model_id     = model_id;
+    header->num_images   = static_cast<uint32_t>(num);
+    header->num_outputs  = static_cast<uint32_t>(schema.size());
+    header->flags        = frames ? kCaptureFrames : 0;
+
+    const auto& config   = backend.infer_config.config;
+    header->swap_rb      = config.swap_rb ? 1 : 0;
+    header->border_value = config.border_value;
+    header->alpha[0]     = config.alpha.x;
+    header->alpha[1]     = config.alpha.y;
+    header->alpha[2]     = config.alpha.z;
+    header->beta[0]      = config.beta.x;
+    header->beta[1]      = config.beta.y;
+    header->beta[2]      = config.beta.z;
+
+    for (size_t i = 0; i < num; ++i) {
+        const auto& image     = images[i];
+        const auto& transform = backend.transform(i);
+        auto*       entry     = at<CaptureImageEntry>(buffer, images_offset + i * sizeof(CaptureImageEntry));
+
+        entry->width    = image.width;
+        entry->height   = image.height;
+        entry->channels = image.channels;
+        entry->meta[0]  = transform.meta.x;
+        entry->meta[1]  = transform.meta.y;
+        entry->meta[2]  = transform.meta.z;
+        entry->meta[3]  = transform.meta.w;
+        entry->scale    = transform.scale;
+
+        // 输入位于设备内存时无法在主机上读取像素，只记录尺寸和变换
+        if (backend.infer_config.cuda_mem) continue;
+        entry->hash = captureHash(image.ptr, image.width, image.height, image.channels, image.pitch);
+
+        if (frames) {
+            size_t row_bytes   = static_cast<size_t>(image.width) * image.channels;
+            entry->data_offset = image_offsets[i];
+            entry->data_bytes  = row_bytes * image.height;
+            for (int y = 0; y < image.height; ++y) {
+                std::memcpy(buffer.data() + image_offsets[i] + y * row_bytes, static_cast<const uint8_t*>(image.ptr) + y * image.pitch, row_bytes);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < schema.size(); ++i) {
+        const auto& view  = outputs[schema[i]];
+        auto*       entry = at<CaptureTensorEntry>(buffer, tensors_offset + i * sizeof(CaptureTensorEntry));
+
+        entry->role = static_cast<int32_t>(schema[i]);
+        std::copy(view.shape.begin(), view.shape.end(), entry->shape);
+        entry->shape[0]    = static_cast<int64_t>(num);
+        entry->item_bytes  = view.item_bytes;
+        entry->data_offset = tensor_offsets[i];
+        entry->data_bytes  = view.item_bytes * num;
+        if (view.data) std::memcpy(buffer.data() + tensor_offsets[i], view.data, entry->data_bytes);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_.is_open()) return;  // 组装期间已停止捕获
+
+    out_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out_.flush();
+    if (!out_) {
+        // 写入失败（如磁盘已满）时停止捕获，不影响推理
+        std::cerr << "Capture: failed to write record, capture stopped." << std::endl;
+        enabled_.store(false, std::memory_order_release);
+        out_.close();
+        return;
+    }
+    records_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Capture::start(const std::string& file, bool frames) {
+    CaptureWriter::instance().start(file, frames);
+}
+
+void Capture::stop() {
+    CaptureWriter::instance().stop();
+}
+
+bool Capture::enabled() {
+    return CaptureWriter::instance().enabled();
+}
+
+size_t Capture::records() {
+    return CaptureWriter::instance().records();
+}
+
+class CaptureReader::Impl {
+public:
+    explicit Impl(const std::string& file) {
+#ifdef _WIN32
+        std::ifstream fin(file, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!fin.is_open()) {
+            throw std::runtime_error("Failed to open file: " + file + " to read.");
+        }
+        storage_.resize(static_cast<size_t>(fin.tellg()));
+        fin.seekg(0);
+        fin.read(reinterpret_cast<char*>(storage_.data()), static_cast<std::streamsize>(storage_.size()));
+        data_ = storage_.data();
+        size_ = storage_.size();
+#else
+        int fd = open(file.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open file: " + file + " to read.");
+        }
+        struct stat st{};
+        fstat(fd, &st);
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Failed to map file: " + file + ".");
+            }
+            data_ = static_cast<const uint8_t*>(mapped);
+        }
+        close(fd);
+#endif
+
+        const auto* header = reinterpret_cast<const CaptureFileHeader*>(data_);
+        if (size_ < sizeof(CaptureFileHeader) || std::memcmp(header->magic, kCaptureMagic, sizeof(kCaptureMagic)) != 0 ||
+            header->version != kCaptureVersion) {
+            release();
+            throw std::runtime_error("CaptureReader: " + file + " is not a capture file.");
+        }
+        index();
+    }
+
+    ~Impl() { release(); }
+
+    Impl(const Impl&)            = delete;
+    Impl& operator=(const Impl&) = delete;
+
+    size_t size() const { return records_.size(); }
+
+    const CaptureRecordHeader& header(size_t index) const {
+        if (index >= records_.size()) {
+            throw std::out_of_range("CaptureReader: record index " + std::to_string(index) + " out of range");
+        }
+        return *reinterpret_cast<const CaptureRecordHeader*>(data_ + records_[index]);
+    }
+
+    const CaptureImageEntry* images(size_t index) const {
+        return reinterpret_cast<const CaptureImageEntry*>(reinterpret_cast<const uint8_t*>(&header(index)) + sizeof(CaptureRecordHeader));
+    }
+
+    const CaptureTensorEntry* tensors(size_t index) const {
+        return reinterpret_cast<const CaptureTensorEntry*>(images(index) + header(index).num_images);
+    }
+
+    const uint8_t* base(size_t index) const { return data_ + records_[index]; }
+
+    template <typename ResultType, typename Func>
+    std::vector<ResultType> replay(size_t index, TaskType task, Func func) const {
+        const auto& record = header(index);
+        if (record.task != static_cast<uint32_t>(task)) {
+            throw std::invalid_argument("CaptureReader: record " + std::to_string(index) + " was captured from a " +
+                                        taskTypeToString(static_cast<TaskType>(record.task)) + " model, not " + taskTypeToString(task));
+        }
+
+        OutputViews outputs;
+        const auto* tensors = this->tensors(index);
+        for (uint32_t i = 0; i < record.num_outputs; ++i) {
+            auto& view      = outputs[static_cast<OutputRole>(tensors[i].role)];
+            view.data       = base(index) + tensors[i].data_offset;
+            view.item_bytes = tensors[i].item_bytes;
+            std::copy(tensors[i].shape, tensors[i].shape + 4, view.shape.begin());
+        }
+
+        std::vector<ResultType> results(record.num_images);
+        const auto*             images = this->images(index);
+        for (uint32_t idx = 0; idx < record.num_images; ++idx) {
+            Transform transform{};
+            transform.meta  = make_int4(images[idx].meta[0], images[idx].meta[1], images[idx].meta[2], images[idx].meta[3]);
+            transform.scale = images[idx].scale;
+            results[idx]    = func(outputs, transform, static_cast<int>(idx));
+        }
+        return results;
+    }
+
+private:
+    /**
+     * @brief 建立记录索引，遇到不完整或损坏的记录时停止（视为进程异常退出留下的尾部）
+     */
+    void index() {
+        size_t offset = sizeof(CaptureFileHeader);
+        while (offset + sizeof(CaptureRecordHeader) <= size_) {
+            const auto* record = reinterpret_cast<const CaptureRecordHeader*>(data_ + offset);
+            if (record->magic != kCaptureRecordMagic || record->record_bytes % kCaptureAlignment != 0 ||
+                record->record_bytes > size_ - offset || !valid(*record)) {
+                break;
+            }
+            records_.push_back(offset);
+            offset += record->record_bytes;
+        }
+    }
+
+    static bool valid(const CaptureRecordHeader& record) {
+        size_t tables = sizeof(CaptureRecordHeader) + static_cast<size_t>(record.num_images) * sizeof(CaptureImageEntry) +
+                        static_cast<size_t>(record.num_outputs) * sizeof(CaptureTensorEntry);
+        if (tables > record.record_bytes) return false;
+
+        auto inside = [&](uint64_t offset, uint64_t bytes) { return offset <= record.record_bytes && bytes <= record.record_bytes - offset; };
+
+        const auto* images = reinterpret_cast<const CaptureImageEntry*>(&record + 1);
+        for (uint32_t i = 0; i < record.num_images; ++i) {
+            const auto& image = images[i];
+            if (!inside(image.data_offset, image.data_bytes)) return false;
+            if (image.data_bytes != 0) {
+                if (image.width <= 0 || image.height <= 0 || image.channels <= 0) return false;
+                if (image.data_bytes != static_cast<uint64_t>(image.width) * image.height * image.channels) return false;
+            }
+        }
+
+        // 每张图像的目标数量上限：带目标维度的张量（Num 和 Topk 除外）第 1 维的最小值
+        const auto*               tensors     = reinterpret_cast<const CaptureTensorEntry*>(images + record.num_images);
+        const CaptureTensorEntry* num_tensor  = nullptr;
+        int64_t                   max_objects = std::numeric_limits<int64_t>::max();
+        for (uint32_t i = 0; i < record.num_outputs; ++i) {
+            const auto& tensor = tensors[i];
+            if (tensor.role < 0 || tensor.role >= static_cast<int32_t>(OutputRole::Count)) return false;
+            if (tensor.shape[0] != static_cast<int64_t>(record.num_images)) return false;
+
+            // 后处理按形状寻址，每张图像的字节数必须等于形状描述的元素数量乘以元素大小（元素均为 4 字节）
+            uint64_t elements = 1;
+            for (int d = 1; d < 4; ++d) {
+                if (tensor.shape[d] < 0) return false;
+                if (tensor.shape[d] > 0) elements *= static_cast<uint64_t>(tensor.shape[d]);
+            }
+            if (tensor.item_bytes != elements * 4) return false;
+            if (tensor.data_bytes != tensor.item_bytes * record.num_images || !inside(tensor.data_offset, tensor.data_bytes)) return false;
+
+            auto role = static_cast<OutputRole>(tensor.role);
+            if (role == OutputRole::Num) {
+                num_tensor = &tensor;
+            } else if (role != OutputRole::Topk) {
+                max_objects = std::min(max_objects, tensor.shape[1]);
+            }
+        }
+
+        // 目标数量决定后处理读取的范围，越界的数量会读到其他图像或记录之外的数据
+        if (num_tensor) {
+            const auto* data = reinterpret_cast<const uint8_t*>(&record) + num_tensor->data_offset;
+            for (uint32_t i = 0; i < record.num_images; ++i) {
+                int32_t count;
+                std::memcpy(&count, data + i * num_tensor->item_bytes, sizeof(count));
+                if (count < 0 || count > max_objects) return false;
+            }
+        }
+        return true;
+    }
+
+    void release() {
+#ifndef _WIN32
+        if (data_ && size_ > 0) munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const uint8_t*      data_ = nullptr;  // < 文件内容
+    size_t              size_ = 0;        // < 文件字节数
+    std::vector<size_t> records_;         // < 每条完整记录的起始偏移量
+#ifdef _WIN32
+    std::vector<uint8_t> storage_;        // < 文件内容（Windows 上读入内存）
+#endif
+};
+
+CaptureReader::CaptureReader(const std::string& file) : impl_(std::make_unique<Impl>(file)) {}
+CaptureReader::~CaptureReader()                                        = default;
+CaptureReader::CaptureReader(CaptureReader&& other) noexcept            = default;
+CaptureReader& CaptureReader::operator=(CaptureReader&& other) noexcept = default;
+
+size_t CaptureReader::size() const {
+    return impl_->size();
+}
+
+TaskType CaptureReader::task(size_t index) const {
+    return static_cast<TaskType>(impl_->header(index).task);
+}
+
+CaptureRecord CaptureReader::record(size_t index) const {
+    const auto& header = impl_->header(index);
+
+    CaptureRecord record;
+    record.timestamp_ns = header.timestamp_ns;
+    record.model_id     = header.model_id;
+    record.task         = static_cast<TaskType>(header.task);
+    record.swap_rb      = header.swap_rb != 0;
+    record.border_value = header.border_value;
+    std::copy(header.alpha, header.alpha + 3, record.alpha.begin());
+    std::copy(header.beta, header.beta + 3, record.beta.begin());
+
+    const auto* images = impl_->images(index);
+    record.frames.resize(header.num_images);
+    for (uint32_t i = 0; i < header.num_images; ++i) {
+        auto& frame    = record.frames[i];
+        frame.width    = images[i].width;
+        frame.height   = images[i].height;
+        frame.channels = images[i].channels;
+        frame.hash     = images[i].hash;
+        frame.scale    = images[i].scale;
+        std::copy(images[i].meta, images[i].meta + 4, frame.meta.begin());
+
+        const uint8_t* data = impl_->base(index) + images[i].data_offset;
+        if (images[i].data_bytes > 0) frame.data.assign(data, data + images[i].data_bytes);
+    }
+    return record;
+}
+
+std::vector<ClassifyRes> CaptureReader::replayClassify(size_t index) const {
+    return impl_->replay<ClassifyRes>(index, TaskType::Classify, postProcessClassify);
+}
+
+std::vector<DetectRes> CaptureReader::replayDetect(size_t index) const {
+    return impl_->replay<DetectRes>(index, TaskType::Detect, postProcessDetect);
+}
+
+std::vector<OBBRes> CaptureReader::replayOBB(size_t index) const {
+    return impl_->replay<OBBRes>(index, TaskType::OBB, postProcessOBB);
+}
+
+std::vector<SegmentRes> CaptureReader::replaySegment(size_t index) const {
+    return impl_->replay<SegmentRes>(index, TaskType::Segment, postProcessSegment);
+}
+
+std::vector<PoseRes> CaptureReader::replayPose(size_t index) const {
+    return impl_->replay<PoseRes>(index, TaskType::Pose, postProcessPose);
+}
+
+}  // namespace trtyolo
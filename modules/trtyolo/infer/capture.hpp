@@ -0,0 +1,156 @@
+/**
+ * @file capture.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 推理捕获的文件格式和写入器：记录每次 predict 的输入和原始输出，用于离线复现
+ * @date 2025-07-08
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "trtyolo.hpp"
+
+namespace trtyolo {
+
+class TrtBackend;
+
+/**
+ * 捕获文件格式（小端序，所有结构体都是 POD，可以直接从内存映射中读取）：
+ *
+ *   CaptureFileHeader                               文件头，64 字节
+ *   记录 0, 记录 1, ...                              每条记录的起始位置和长度都按 64 字节对齐
+ *
+ * 每条记录：
+ *
+ *   CaptureRecordHeader                             记录头
+ *   CaptureImageEntry  × num_images                 每张图像的仿射变换、像素哈希和像素数据的位置
+ *   CaptureTensorEntry × num_outputs                每个输出张量的角色、形状和数据的位置
+ *   像素数据和张量数据                                 各自按 64 字节对齐，偏移量相对于记录起始位置
+ */
+constexpr char     kCaptureMagic[8]    = {'T', 'R', 'T', 'Y', 'C', 'A', 'P', '1'};
+constexpr uint32_t kCaptureVersion     = 1;
+constexpr uint32_t kCaptureRecordMagic = 0x52435254;  // < "TRCR"
+constexpr size_t   kCaptureAlignment   = 64;
+constexpr uint32_t kCaptureFrames      = 1u << 0;     // < 记录标志：包含图像像素
+
+/**
+ * @brief 捕获文件头
+ */
+struct CaptureFileHeader {
+    char     magic[8];       // < 文件标识 kCaptureMagic
+    uint32_t version;        // < 格式版本
+    uint32_t alignment;      // < 记录对齐字节数
+    uint8_t  reserved[48];   // < 保留
+};
+
+/**
+ * @brief 记录头，对应一次 predict 调用
+ */
+struct CaptureRecordHeader {
+    uint32_t magic;          // < 记录标识 kCaptureRecordMagic
+    uint32_t task;           // < 任务类型（TaskType）
+    uint64_t record_bytes;   // < 记录总字节数（包括记录头，64 字节对齐）
+    int64_t  timestamp_ns;   // < 记录时间（系统时钟，Unix 纪元起的纳秒数）
+    uint32_t model_id;       // < 模型实例编号
+    uint32_t num_images;     // < 图像数量
+    uint32_t num_outputs;    // < 输出张量数量
+    uint32_t flags;          // < 记录标志
+    uint32_t swap_rb;        // < 预处理是否交换 R 和 B 通道
+    float    border_value;   // < 预处理的填充值
+    float    alpha[3];       // < 预处理的归一化系数
+    float    beta[3];        // < 预处理的偏移量
+};
+
+/**
+ * @brief 图像条目
+ */
+struct CaptureImageEntry {
+    int32_t  width;          // < 图像宽度
+    int32_t  height;         // < 图像高度
+    int32_t  channels;       // < 图像通道数
+    int32_t  reserved;       // < 保留
+    uint64_t hash;           // < 像素哈希，输入位于设备内存时为 0
+    int32_t  meta[4];        // < 仿射变换元数据：有效宽度、有效高度、偏移量 X、偏移量 Y
+    float    scale;          // < 仿射变换的缩放比例
+    uint32_t reserved2;      // < 保留
+    uint64_t data_offset;    // < 紧密排列的像素数据偏移量，未记录时为 0
+    uint64_t data_bytes;     // < 像素数据字节数，未记录时为 0
+};
+
+/**
+ * @brief 输出张量条目，只保存批量中实际请求的图像
+ */
+struct CaptureTensorEntry {
+    int32_t  role;           // < 输出角色（OutputRole）
+    int32_t  reserved;       // < 保留
+    int64_t  shape[4];       // < 张量形状，第 0 维为图像数量
+    uint64_t item_bytes;     // < 每张图像占用的字节数
+    uint64_t data_offset;    // < 张量数据偏移量
+    uint64_t data_bytes;     // < 张量数据字节数
+};
+
+static_assert(sizeof(CaptureFileHeader) == kCaptureAlignment, "CaptureFileHeader must be 64 bytes");
+static_assert(sizeof(CaptureImageEntry) == 64 && sizeof(CaptureTensorEntry) == 64, "capture entries must be 64 bytes");
+static_assert(std::is_trivially_copyable_v<CaptureRecordHeader>, "capture structures must be POD");
+
+/**
+ * @brief 计算图像像素的 64 位哈希，忽略行尾填充
+ *
+ * 按 8 字节读取并乘法混合，比逐字节哈希快一个数量级，只用于判断两帧是否相同，不具备抗碰撞性。
+ *
+ * @param data 像素数据（主机内存）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param channels 图像通道数
+ * @param pitch 行步长（字节）
+ * @return uint64_t 哈希值，保证不为 0
+ */
+uint64_t captureHash(const void* data, int width, int height, int channels, size_t pitch);
+
+/**
+ * @brief 进程级捕获写入器
+ *
+ * 每条记录先在调用线程的本地缓冲区中完整组装，再在锁内一次性追加到文件，
+ * 不同模型和克隆的记录不会交错。
+ */
+class CaptureWriter {
+public:
+    static CaptureWriter& instance();
+
+    bool   enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+    size_t records() const noexcept { return records_.load(std::memory_order_relaxed); }
+
+    void start(const std::string& file, bool frames);  // < 开始捕获，覆盖已有文件
+    void stop();                                       // < 停止捕获并关闭文件
+
+    /**
+     * @brief 写入一条记录，应在推理完成、后处理之前调用
+     *
+     * @param model_id 模型实例编号
+     * @param backend 刚完成推理的后端
+     * @param images 本次调用的输入图像
+     */
+    void write(uint32_t model_id, const TrtBackend& backend, const std::vector<Image>& images);
+
+private:
+    CaptureWriter() = default;
+
+    std::mutex          mutex_;            // < 保护文件写入、启动和停止
+    std::ofstream       out_;              // < 捕获文件
+    std::atomic<bool>   enabled_{false};   // < 是否正在捕获
+    std::atomic<bool>   frames_{false};    // < 是否保存图像像素
+    std::atomic<size_t> records_{0};       // < 已写入的记录数量
+};
+
+}  // namespace trtyolo
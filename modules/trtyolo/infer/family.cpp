@@ -0,0 +1,93 @@
+/**
+ * @file family.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 同一网络多个批量构建的引擎族实现
+ * @date 2025-06-20
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "family.hpp"
+
+namespace trtyolo {
+
+BackendFamily::BackendFamily(const std::vector<std::string>& trt_engine_files, const InferConfig& infer_config, TaskType task) {
+    if (trt_engine_files.empty()) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("BackendFamily: requires at least one engine file"));
+    }
+
+    backends_.reserve(trt_engine_files.size());
+    for (const auto& trt_engine_file : trt_engine_files) {
+        backends_.emplace_back(std::make_unique<TrtBackend>(trt_engine_file, infer_config, task));
+    }
+
+    // 引擎族中的成员必须是同一网络：输入尺寸和张量数量一致
+    const auto& front = backends_.front();
+    for (const auto& backend : backends_) {
+        if (backend->tensor_infos.size() != front->tensor_infos.size() ||
+            backend->max_shape.y != front->max_shape.y ||
+            backend->max_shape.z != front->max_shape.z ||
+            backend->max_shape.w != front->max_shape.w) {
+            throw std::invalid_argument(MAKE_ERROR_MESSAGE("BackendFamily: all engines must be builds of the same network"));
+        }
+    }
+
+    // 按最大批量升序排列，填充槽位相同时优先选择批量较小的后端
+    std::stable_sort(backends_.begin(), backends_.end(), [](const auto& a, const auto& b) {
+        return a->max_shape.x < b->max_shape.x;
+    });
+}
+
+std::unique_ptr<BackendFamily> BackendFamily::clone() const {
+    auto clone_family = std::make_unique<BackendFamily>();
+    clone_family->backends_.reserve(backends_.size());
+    for (const auto& backend : backends_) {
+        clone_family->backends_.emplace_back(backend->clone());
+    }
+    return clone_family;
+}
+
+TrtBackend& BackendFamily::select(size_t num) {
+    TrtBackend* selected = nullptr;
+    size_t      min_slot = std::numeric_limits<size_t>::max();
+
+    for (const auto& backend : backends_) {
+        size_t lower = backend->dynamic ? backend->min_shape.x : 1;
+        size_t upper = backend->max_shape.x;
+        if (num < lower || num > upper) continue;
+
+        // 动态引擎按实际数量执行，静态引擎总是执行 max_shape.x 个槽位
+        size_t slots = backend->dynamic ? num : upper;
+        if (slots < min_slot) {
+            min_slot = slots;
+            selected = backend.get();
+        }
+    }
+
+    if (!selected) {
+        throw std::invalid_argument("Number of inputs out of range");
+    }
+    return *selected;
+}
+
+int BackendFamily::batch() const {
+    return backends_.back()->max_shape.x;
+}
+
+const InferConfig& BackendFamily::inferConfig() const {
+    return backends_.front()->infer_config;
+}
+
+TaskType BackendFamily::task() const {
+    return backends_.front()->task;
+}
+
+const std::vector<std::unique_ptr<TrtBackend>>& BackendFamily::members() const {
+    return backends_;
+}
+
+}  // namespace trtyolo
@@ -0,0 +1,92 @@
+/**
+ * @file family.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 同一网络多个批量构建的引擎族定义，按批量占用率选择后端
+ * @date 2025-06-20
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "backend.hpp"
+
+namespace trtyolo {
+
+/**
+ * @brief 引擎族类，管理同一网络以不同批量大小构建的多个 TensorRT 后端。
+ *
+ * 静态引擎无论实际输入多少张图像都会执行 `max_shape.x` 个批次槽位，
+ * 引擎族在每次调用时选择填充槽位最少的后端，以减少低负载时的无效计算。
+ */
+class BackendFamily {
+public:
+    /**
+     * @brief 构造函数，加载引擎族中的所有引擎。
+     *
+     * @param trt_engine_files TensorRT 引擎文件路径列表（同一网络的不同批量构建）。
+     * @param infer_config 推理配置。
+     * @param task 任务类型，用于按名称绑定输出张量。
+     * @throws std::invalid_argument 如果引擎列表为空或引擎之间的输入输出不一致。
+     */
+    BackendFamily(const std::vector<std::string>& trt_engine_files, const InferConfig& infer_config, TaskType task = TaskType::Unknown);
+
+    /**
+     * @brief 默认构造函数，仅在 clone 方法中使用。
+     */
+    BackendFamily() = default;
+
+    /**
+     * @brief 克隆引擎族，所有成员共享各自的引擎并创建新的上下文。
+     *
+     * @return 克隆后的 BackendFamily 对象的智能指针。
+     */
+    std::unique_ptr<BackendFamily> clone() const;
+
+    /**
+     * @brief 根据输入数量选择填充槽位最少的后端。
+     *
+     * @param num 输入图像数量。
+     * @return TrtBackend& 选中的后端。
+     * @throws std::invalid_argument 如果没有后端能够接受该数量的输入。
+     */
+    TrtBackend& select(size_t num);
+
+    /**
+     * @brief 获取引擎族支持的最大批量大小。
+     *
+     * @return int 最大批量大小。
+     */
+    int batch() const;
+
+    /**
+     * @brief 获取推理配置（所有成员共享同一配置）。
+     *
+     * @return const InferConfig& 推理配置。
+     */
+    const InferConfig& inferConfig() const;
+
+    /**
+     * @brief 获取任务类型（所有成员共享同一任务）。
+     *
+     * @return TaskType 任务类型。
+     */
+    TaskType task() const;
+
+    /**
+     * @brief 获取引擎族的所有成员。
+     *
+     * @return const std::vector<std::unique_ptr<TrtBackend>>& 按最大批量升序排列的后端列表。
+     */
+    const std::vector<std::unique_ptr<TrtBackend>>& members() const;
+
+private:
+    std::vector<std::unique_ptr<TrtBackend>> backends_;  // < 按最大批量升序排列的后端
+};
+
+}  // namespace trtyolo
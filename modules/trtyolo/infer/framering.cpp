@@ -0,0 +1,880 @@
+/**
+ * @file framering.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 共享内存帧环：多个生产者进程提交帧，服务端进程批量推理并通过共享内存写回结果
+ * @date 2025-07-15
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "trtyolo.hpp"
+
+namespace trtyolo {
+
+namespace {
+
+constexpr char     kRingMagic[8]   = {'T', 'R', 'T', 'Y', 'R', 'I', 'N', 'G'};
+constexpr uint32_t kRingVersion    = 3;
+constexpr size_t   kRingPageSize   = 4096;  // 头部和槽位按页对齐
+constexpr size_t   kRingLineSize   = 64;    // 槽位内的像素区按缓存行对齐
+constexpr int      kRingIdleWaitMs = 100;   // 推理线程空闲时的等待间隔，超时后检查停止标志并回收槽位
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "Atomics in shared memory must be lock-free to be shared between processes");
+
+/**
+ * @brief 槽位状态
+ *
+ * 正常流程为 Free → Writing → Ready → Processing → Done → Free；生产者等待超时时，
+ * Ready 直接回到 Free，Processing 变为 Abandoned，由推理线程在完成后释放。
+ */
+enum SlotState : uint32_t {
+    kFree,        // < 空闲
+    kWriting,     // < 生产者正在写入像素
+    kReady,       // < 等待推理
+    kProcessing,  // < 推理中
+    kDone,        // < 结果已写回，等待生产者读取
+    kAbandoned,   // < 生产者已放弃等待，推理完成后直接释放
+};
+
+// 槽位状态和占用者进程 ID 合并为一个 64 位字，两者总是由同一次原子操作发布
+uint64_t packSlot(SlotState state, int32_t pid) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32 | state;
+}
+
+SlotState slotState(uint64_t word) {
+    return static_cast<SlotState>(word & 0xffffffffu);
+}
+
+int32_t slotPid(uint64_t word) {
+    return static_cast<int32_t>(word >> 32);
+}
+
+// ---------------------------------------------------------------------------
+// 平台相关操作：进程间信号量、共享内存映射和进程存活检查
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+using RingSemaphore = int;  // Windows 上不支持，创建和连接时直接抛出异常
+#else
+using RingSemaphore = sem_t;
+#endif
+
+void initSemaphore(RingSemaphore* sem) {
+#ifndef _WIN32
+    if (sem_init(sem, 1, 0) != 0) throw std::runtime_error("FrameRing: failed to initialize a process-shared semaphore.");
+#endif
+}
+
+void postSemaphore(RingSemaphore* sem) {
+#ifndef _WIN32
+    sem_post(sem);
+#endif
+}
+
+bool tryWaitSemaphore(RingSemaphore* sem) {
+#ifndef _WIN32
+    return sem_trywait(sem) == 0;
+#else
+    return false;
+#endif
+}
+
+// 等待信号量直到截止时间（系统时钟），超时返回 false
+bool waitSemaphore(RingSemaphore* sem, std::chrono::system_clock::time_point deadline) {
+#ifndef _WIN32
+    auto            since_epoch = deadline.time_since_epoch();
+    auto            seconds     = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    struct timespec ts{};
+    ts.tv_sec  = static_cast<time_t>(seconds.count());
+    ts.tv_nsec = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count());
+    while (sem_timedwait(sem, &ts) != 0) {
+        if (errno == EINTR) continue;
+        if (errno == ETIMEDOUT) return false;
+        throw std::runtime_error("FrameRing: failed to wait on a process-shared semaphore.");
+    }
+#endif
+    return true;
+}
+
+int currentProcessId() {
+#ifndef _WIN32
+    return static_cast<int>(getpid());
+#else
+    return 0;
+#endif
+}
+
+bool processExited(int pid) {
+#ifndef _WIN32
+    return pid > 0 && kill(pid, 0) != 0 && errno == ESRCH;
+#else
+    return false;
+#endif
+}
+
+// POSIX 共享内存名称须以 / 开头
+std::string shmName(const std::string& name) {
+    if (name.empty()) throw std::invalid_argument("FrameRing: shared memory name must not be empty.");
+    return name.front() == '/' ? name : "/" + name;
+}
+
+/**
+ * @brief 共享内存段的映射，析构时解除映射
+ */
+class SharedMapping {
+public:
+    SharedMapping() = default;
+
+    // 创建新的共享内存段，同名的段已存在时失败
+    static SharedMapping create(const std::string& name, size_t size) {
+#ifdef _WIN32
+        throw std::runtime_error("FrameRing: POSIX shared memory is not supported on Windows.");
+#else
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+        if (fd < 0 && errno == EEXIST) {
+            throw std::runtime_error("FrameRing: shared memory " + name + " already exists and is used by a running server.");
+        }
+        if (fd < 0) throw std::runtime_error("FrameRing: failed to create shared memory " + name + ": " + std::strerror(errno));
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("FrameRing: failed to resize shared memory " + name + " to " + std::to_string(size) + " bytes.");
+        }
+        return map(fd, name, size, true);
+#endif
+    }
+
+    // 连接已存在的共享内存段
+    static SharedMapping open(const std::string& name) {
+#ifdef _WIN32
+        throw std::runtime_error("FrameRing: POSIX shared memory is not supported on Windows.");
+#else
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) throw std::runtime_error("FrameRing: failed to open shared memory " + name + ": " + std::strerror(errno));
+        struct stat st{};
+        fstat(fd, &st);
+        return map(fd, name, static_cast<size_t>(st.st_size), false);
+#endif
+    }
+
+    ~SharedMapping() { release(); }
+
+    SharedMapping(SharedMapping&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    SharedMapping& operator=(SharedMapping&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    uint8_t* data() const { return data_; }
+    size_t   size() const { return size_; }
+
+private:
+#ifndef _WIN32
+    static SharedMapping map(int fd, const std::string& name, size_t size, bool created) {
+        void* mapped = size > 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            if (created) shm_unlink(name.c_str());
+            throw std::runtime_error("FrameRing: failed to map shared memory " + name + ".");
+        }
+        SharedMapping mapping;
+        mapping.data_ = static_cast<uint8_t*>(mapped);
+        mapping.size_ = size;
+        return mapping;
+    }
+#endif
+
+    void release() {
+#ifndef _WIN32
+        if (data_) munmap(data_, size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    uint8_t* data_ = nullptr;  // < 映射地址
+    size_t   size_ = 0;        // < 映射字节数
+};
+
+// ---------------------------------------------------------------------------
+// 共享内存布局：头部 + slots 个槽位，每个槽位为槽位头 + 像素区 + 结果区
+// ---------------------------------------------------------------------------
+
+struct RingHeader {
+    char                  magic[8];      // < 文件标识 "TRTYRING"
+    uint32_t              version;       // < 布局版本
+    uint32_t              task;          // < 任务类型（TaskType）
+    uint32_t              slots;         // < 槽位数量
+    int32_t               max_width;     // < 单帧最大宽度
+    int32_t               max_height;    // < 单帧最大高度
+    uint64_t              frame_bytes;   // < 每个槽位的像素区字节数
+    uint64_t              result_bytes;  // < 每个槽位的结果区字节数
+    uint64_t              slot_bytes;    // < 槽位步长
+    std::atomic<uint64_t> sequence;      // < 下一个提交序号，推理线程按序号从小到大取帧
+    std::atomic<uint32_t> running;       // < 服务端是否在运行
+    int32_t               owner;         // < 服务端进程 ID，用于识别崩溃后遗留的段
+    RingSemaphore         ready;         // < 每个就绪的帧 post 一次，唤醒推理线程
+};
+
+struct alignas(kRingLineSize) RingSlot {
+    std::atomic<uint64_t> state;        // < 低 32 位为槽位状态（SlotState），高 32 位为占用槽位的生产者进程 ID，空闲时为 0
+    uint64_t              sequence;     // < 提交序号
+    int32_t               width;        // < 帧宽度
+    int32_t               height;       // < 帧高度（像素紧密排列，行距为 width * 3）
+    int32_t               failed;       // < 推理是否失败，失败时结果区为错误信息
+    uint32_t              result_size;  // < 结果区的有效字节数
+    RingSemaphore         done;         // < 结果写回后 post，唤醒生产者
+};
+
+/**
+ * @brief 对共享内存段的类型化访问
+ */
+class RingView {
+public:
+    RingView() = default;
+    explicit RingView(uint8_t* base) : base_(base) {}
+
+    static size_t headerBytes() { return alignUp(sizeof(RingHeader), kRingPageSize); }
+    static size_t slotHeaderBytes() { return alignUp(sizeof(RingSlot), kRingLineSize); }
+
+    RingHeader* header() const { return reinterpret_cast<RingHeader*>(base_); }
+    RingSlot*   slot(size_t idx) const { return reinterpret_cast<RingSlot*>(slotBase(idx)); }
+    uint8_t*    frame(size_t idx) const { return slotBase(idx) + slotHeaderBytes(); }
+    uint8_t*    result(size_t idx) const { return frame(idx) + header()->frame_bytes; }
+
+private:
+    uint8_t* slotBase(size_t idx) const { return base_ + headerBytes() + idx * header()->slot_bytes; }
+
+    uint8_t* base_ = nullptr;  // < 共享内存段的起始地址
+};
+
+// ---------------------------------------------------------------------------
+// 结果序列化：num、classes、scores，之后依任务类型为边界框、掩码和关键点
+// ---------------------------------------------------------------------------
+
+class ResultWriter {
+public:
+    ResultWriter(uint8_t* data, size_t capacity) : data_(data), capacity_(capacity) {}
+
+    template <typename T>
+    void write(const T* values, size_t count) {
+        size_t bytes = sizeof(T) * count;
+        if (bytes > capacity_ - size_) {
+            throw std::length_error("result exceeds FrameRingOptions::result_bytes (" + std::to_string(capacity_) + " bytes)");
+        }
+        if (bytes > 0) std::memcpy(data_ + size_, values, bytes);
+        size_ += bytes;
+    }
+
+    template <typename T>
+    void write(T value) {
+        write(&value, 1);
+    }
+
+    // 丢弃已写入的内容，改为写入错误信息
+    void fail(const std::string& message) {
+        failed_ = true;
+        size_   = std::min(message.size(), capacity_);
+        std::memcpy(data_, message.data(), size_);
+    }
+
+    size_t size() const { return size_; }
+    bool   failed() const { return failed_; }
+
+private:
+    uint8_t* data_;            // < 结果区
+    size_t   capacity_;        // < 结果区字节数
+    size_t   size_   = 0;      // < 已写入的字节数
+    bool     failed_ = false;  // < 是否失败
+};
+
+class ResultReader {
+public:
+    ResultReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    void read(T* values, size_t count) {
+        size_t bytes = sizeof(T) * count;
+        if (bytes > size_ - offset_) throw std::runtime_error("FrameRingClient: truncated result in shared memory.");
+        if (bytes > 0) std::memcpy(values, data_ + offset_, bytes);
+        offset_ += bytes;
+    }
+
+    template <typename T>
+    T read() {
+        T value;
+        read(&value, 1);
+        return value;
+    }
+
+private:
+    const uint8_t* data_;        // < 结果区
+    size_t         size_;        // < 有效字节数
+    size_t         offset_ = 0;  // < 已读取的字节数
+};
+
+void writeBase(ResultWriter& writer, const BaseRes& res) {
+    writer.write<int32_t>(res.num);
+    writer.write(res.classes.data(), static_cast<size_t>(res.num));
+    writer.write(res.scores.data(), static_cast<size_t>(res.num));
+}
+
+void readBase(ResultReader& reader, BaseRes& res) {
+    res.num = reader.read<int32_t>();
+    if (res.num < 0) throw std::runtime_error("FrameRingClient: corrupted result in shared memory.");
+    res.classes.resize(res.num);
+    res.scores.resize(res.num);
+    reader.read(res.classes.data(), res.classes.size());
+    reader.read(res.scores.data(), res.scores.size());
+}
+
+void writeBoxes(ResultWriter& writer, const std::vector<Box>& boxes) {
+    for (const auto& box : boxes) {
+        float values[4] = {box.left, box.top, box.right, box.bottom};
+        writer.write(values, 4);
+    }
+}
+
+void writeBoxes(ResultWriter& writer, const std::vector<RotatedBox>& boxes) {
+    for (const auto& box : boxes) {
+        float values[5] = {box.left, box.top, box.right, box.bottom, box.theta};
+        writer.write(values, 5);
+    }
+}
+
+void readBoxes(ResultReader& reader, int num, std::vector<Box>& boxes) {
+    boxes.reserve(num);
+    for (int i = 0; i < num; ++i) {
+        float values[4];
+        reader.read(values, 4);
+        boxes.emplace_back(values[0], values[1], values[2], values[3]);
+    }
+}
+
+void readBoxes(ResultReader& reader, int num, std::vector<RotatedBox>& boxes) {
+    boxes.reserve(num);
+    for (int i = 0; i < num; ++i) {
+        float values[5];
+        reader.read(values, 5);
+        boxes.emplace_back(values[0], values[1], values[2], values[3], values[4]);
+    }
+}
+
+void writeResult(ResultWriter& writer, const ClassifyRes& res) {
+    writeBase(writer, res);
+}
+
+template <typename ResultType>
+void writeResult(ResultWriter& writer, const ResultType& res) {
+    writeBase(writer, res);
+    writeBoxes(writer, res.boxes);
+
+    if constexpr (std::is_same_v<ResultType, SegmentRes>) {
+        for (const auto& mask : res.masks) {
+            writer.write<int32_t>(mask.width);
+            writer.write<int32_t>(mask.height);
+            writer.write(mask.data.data(), mask.data.size());
+        }
+    }
+
+    if constexpr (std::is_same_v<ResultType, PoseRes>) {
+        for (const auto& points : res.kpts) {
+            int32_t channels = !points.empty() && points.front().conf ? 3 : 2;
+            writer.write<int32_t>(static_cast<int32_t>(points.size()));
+            writer.write<int32_t>(channels);
+            for (const auto& kpt : points) {
+                float values[3] = {kpt.x, kpt.y, kpt.conf.value_or(0.0f)};
+                writer.write(values, channels);
+            }
+        }
+    }
+}
+
+template <typename ResultType>
+ResultType readResult(ResultReader& reader) {
+    ResultType res;
+    readBase(reader, res);
+    if constexpr (std::is_same_v<ResultType, ClassifyRes>) return res;
+    else {
+        readBoxes(reader, res.num, res.boxes);
+
+        if constexpr (std::is_same_v<ResultType, SegmentRes>) {
+            res.masks.reserve(res.num);
+            for (int i = 0; i < res.num; ++i) {
+                int width  = reader.read<int32_t>();
+                int height = reader.read<int32_t>();
+                res.masks.emplace_back(width, height);
+                reader.read(res.masks.back().data.data(), res.masks.back().data.size());
+            }
+        }
+
+        if constexpr (std::is_same_v<ResultType, PoseRes>) {
+            res.kpts.resize(res.num);
+            for (auto& points : res.kpts) {
+                int count    = reader.read<int32_t>();
+                int channels = reader.read<int32_t>();
+                if (count < 0 || (channels != 2 && channels != 3)) {
+                    throw std::runtime_error("FrameRingClient: corrupted result in shared memory.");
+                }
+                points.reserve(count);
+                for (int j = 0; j < count; ++j) {
+                    float values[3];
+                    reader.read(values, channels);
+                    points.emplace_back(values[0], values[1], channels == 3 ? std::optional<float>(values[2]) : std::nullopt);
+                }
+            }
+        }
+        return res;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 推理线程：每个线程持有一个模型实例，按任务类型执行推理并序列化结果
+// ---------------------------------------------------------------------------
+
+struct RingWorker {
+    std::function<void(const std::vector<Image>&, std::vector<ResultWriter>&)> run;    // < 推理并写回每张图像的结果
+    size_t                                                                     batch;  // < 模型的最大批量
+};
+
+template <typename ModelType>
+std::vector<RingWorker> makeWorkers(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option, int count) {
+    auto                    model = std::make_shared<ModelType>(trt_engine_files, infer_option);
+    std::vector<RingWorker> workers;
+    for (int i = 0; i < count; ++i) {
+        std::shared_ptr<ModelType> instance = i == 0 ? model : std::shared_ptr<ModelType>(model->clone());
+        auto                       run      = [instance](const std::vector<Image>& images, std::vector<ResultWriter>& writers) {
+            auto results = instance->predict(images);
+            for (size_t idx = 0; idx < results.size(); ++idx) {
+                try {
+                    writeResult(writers[idx], results[idx]);
+                } catch (const std::exception& e) {
+                    writers[idx].fail(e.what());  // 只影响结果超出结果区的图像
+                }
+            }
+        };
+        workers.push_back(RingWorker{std::move(run), static_cast<size_t>(instance->batch())});
+    }
+    return workers;
+}
+
+/**
+ * @brief 释放槽位：状态置为空闲的同时清除占用者
+ */
+void freeSlot(RingSlot* slot) {
+    slot->state.store(packSlot(kFree, 0), std::memory_order_release);
+}
+
+/**
+ * @brief 删除同名的遗留共享内存段
+ *
+ * 只删除已停止（running 为 0）或服务端进程已退出的帧环；段不存在、不是帧环或服务端仍在运行时保持不变，
+ * 随后的创建会因同名段已存在而失败，不会抢占正在运行的服务端。
+ */
+void removeStaleRing(const std::string& name) {
+    SharedMapping mapping;
+    try {
+        mapping = SharedMapping::open(name);
+    } catch (const std::runtime_error&) {
+        return;
+    }
+    if (mapping.size() < RingView::headerBytes()) return;
+
+    const auto* header = reinterpret_cast<const RingHeader*>(mapping.data());
+    if (std::memcmp(header->magic, kRingMagic, sizeof(kRingMagic)) != 0 || header->version != kRingVersion) return;
+    if (header->running.load(std::memory_order_acquire) == 0 || processExited(header->owner)) {
+#ifndef _WIN32
+        shm_unlink(name.c_str());
+#endif
+    }
+}
+
+TaskType parseTask(const std::string& task) {
+    if (task == "classify") return TaskType::Classify;
+    if (task == "detect") return TaskType::Detect;
+    if (task == "obb") return TaskType::OBB;
+    if (task == "segment") return TaskType::Segment;
+    if (task == "pose") return TaskType::Pose;
+    throw std::invalid_argument("FrameRingServer: unknown task '" + task + "'");
+}
+
+}  // namespace
+
+class FrameRingServer::Impl {
+public:
+    Impl(const std::string& name, const std::string& task, const std::vector<std::string>& trt_engine_files,
+         const InferOption& infer_option, const FrameRingOptions& options)
+        : name_(shmName(name)) {
+        if (options.slots <= 0 || options.max_width <= 0 || options.max_height <= 0 || options.workers <= 0 || options.result_bytes == 0) {
+            throw std::invalid_argument("FrameRingServer: slots, max_width, max_height, workers and result_bytes must be positive.");
+        }
+
+        // 先构建模型，失败时不会留下共享内存段
+        TaskType task_type = parseTask(task);
+        switch (task_type) {
+            case TaskType::Classify: workers_ = makeWorkers<ClassifyModel>(trt_engine_files, infer_option, options.workers); break;
+            case TaskType::Detect: workers_ = makeWorkers<DetectModel>(trt_engine_files, infer_option, options.workers); break;
+            case TaskType::OBB: workers_ = makeWorkers<OBBModel>(trt_engine_files, infer_option, options.workers); break;
+            case TaskType::Segment: workers_ = makeWorkers<SegmentModel>(trt_engine_files, infer_option, options.workers); break;
+            default: workers_ = makeWorkers<PoseModel>(trt_engine_files, infer_option, options.workers); break;
+        }
+
+        size_t frame_bytes = alignUp(static_cast<size_t>(options.max_width) * options.max_height * 3, kRingLineSize);
+        size_t slot_bytes  = alignUp(RingView::slotHeaderBytes() + frame_bytes + options.result_bytes, kRingPageSize);
+        removeStaleRing(name_);
+        mapping_           = SharedMapping::create(name_, RingView::headerBytes() + slot_bytes * options.slots);
+        ring_              = RingView(mapping_.data());
+
+        auto* header = new (mapping_.data()) RingHeader();
+        std::memcpy(header->magic, kRingMagic, sizeof(kRingMagic));
+        header->version      = kRingVersion;
+        header->task         = static_cast<uint32_t>(task_type);
+        header->slots        = static_cast<uint32_t>(options.slots);
+        header->max_width    = options.max_width;
+        header->max_height   = options.max_height;
+        header->frame_bytes  = frame_bytes;
+        header->result_bytes = options.result_bytes;
+        header->slot_bytes   = slot_bytes;
+        header->owner        = currentProcessId();
+        header->sequence.store(0, std::memory_order_relaxed);
+        initSemaphore(&header->ready);
+        for (int idx = 0; idx < options.slots; ++idx) {
+            auto* slot = new (ring_.slot(idx)) RingSlot();
+            slot->state.store(packSlot(kFree, 0), std::memory_order_relaxed);
+            initSemaphore(&slot->done);
+        }
+        header->running.store(1, std::memory_order_release);
+
+        for (auto& worker : workers_) threads_.emplace_back([this, &worker] { run(worker); });
+    }
+
+    ~Impl() { stop(); }
+
+    void stop() {
+        if (stopped_.exchange(true)) return;
+        ring_.header()->running.store(0, std::memory_order_release);
+        for (size_t idx = 0; idx < threads_.size(); ++idx) postSemaphore(&ring_.header()->ready);
+        for (auto& thread : threads_) thread.join();
+#ifndef _WIN32
+        shm_unlink(name_.c_str());  // 已连接的客户端仍持有映射，看到 running 为 0 后报错
+#endif
+    }
+
+    uint64_t frames() const { return frames_.load(std::memory_order_relaxed); }
+    uint64_t batches() const { return batches_.load(std::memory_order_relaxed); }
+
+private:
+    void run(RingWorker& worker) {
+        RingHeader*                              header = ring_.header();
+        std::vector<std::pair<uint64_t, size_t>> ready;
+        std::vector<size_t>                      taken;
+        std::vector<Image>                       images;
+        std::vector<ResultWriter>                writers;
+
+        while (!stopped_.load(std::memory_order_acquire)) {
+            if (!waitSemaphore(&header->ready, std::chrono::system_clock::now() + std::chrono::milliseconds(kRingIdleWaitMs))) {
+                reclaim();
+                continue;
+            }
+
+            take(worker.batch, ready, taken);
+            // 每个就绪的帧对应一次 post，多取的帧消耗掉对应的计数；计数不足时只会多一次空的唤醒
+            for (size_t idx = 1; idx < taken.size(); ++idx) tryWaitSemaphore(&header->ready);
+            if (taken.empty()) continue;
+
+            // 帧尺寸由生产者写入，读取一次后校验，超出像素区的帧直接失败，不参与推理
+            images.clear();
+            writers.clear();
+            size_t accepted = 0;
+            for (size_t idx : taken) {
+                RingSlot* slot   = ring_.slot(idx);
+                int32_t   width  = slot->width;
+                int32_t   height = slot->height;
+                if (width <= 0 || height <= 0 || width > header->max_width || height > header->max_height) {
+                    ResultWriter writer(ring_.result(idx), header->result_bytes);
+                    writer.fail("frame size " + std::to_string(width) + "x" + std::to_string(height) + " does not fit in " +
+                                std::to_string(header->max_width) + "x" + std::to_string(header->max_height) + ".");
+                    finish(idx, writer);
+                    continue;
+                }
+                taken[accepted++] = idx;
+                images.emplace_back(ring_.frame(idx), width, height, 3, static_cast<size_t>(width) * 3);
+                writers.emplace_back(ring_.result(idx), header->result_bytes);
+            }
+            taken.resize(accepted);
+            if (taken.empty()) continue;
+
+            try {
+                worker.run(images, writers);
+            } catch (const std::exception& e) {
+                for (auto& writer : writers) writer.fail(e.what());
+            }
+
+            for (size_t idx = 0; idx < taken.size(); ++idx) finish(taken[idx], writers[idx]);
+            frames_.fetch_add(taken.size(), std::memory_order_relaxed);
+            batches_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // 按提交顺序取出不超过 batch 个就绪的帧
+    void take(size_t batch, std::vector<std::pair<uint64_t, size_t>>& ready, std::vector<size_t>& taken) {
+        ready.clear();
+        taken.clear();
+        for (size_t idx = 0; idx < ring_.header()->slots; ++idx) {
+            RingSlot* slot = ring_.slot(idx);
+            if (slotState(slot->state.load(std::memory_order_acquire)) == kReady) ready.emplace_back(slot->sequence, idx);
+        }
+        std::sort(ready.begin(), ready.end());
+
+        for (const auto& [sequence, idx] : ready) {
+            if (taken.size() == batch) break;
+            RingSlot* slot = ring_.slot(idx);
+            uint64_t  word = slot->state.load(std::memory_order_relaxed);
+            if (slotState(word) == kReady &&
+                slot->state.compare_exchange_strong(word, packSlot(kProcessing, slotPid(word)), std::memory_order_acquire)) {
+                taken.push_back(idx);
+            }
+        }
+    }
+
+    // 写回结果并唤醒生产者；生产者已放弃等待时直接释放槽位
+    void finish(size_t idx, const ResultWriter& writer) {
+        RingSlot* slot    = ring_.slot(idx);
+        slot->failed      = writer.failed();
+        slot->result_size = static_cast<uint32_t>(writer.size());
+
+        uint64_t word = slot->state.load(std::memory_order_relaxed);
+        if (slotState(word) == kProcessing &&
+            slot->state.compare_exchange_strong(word, packSlot(kDone, slotPid(word)), std::memory_order_release)) {
+            postSemaphore(&slot->done);
+        } else {
+            freeSlot(slot);
+        }
+    }
+
+    // 回收已退出的生产者进程占用的槽位
+    // 占用槽位时状态和 pid 一并写入，kWriting、kDone 状态的槽位总带有当前占用者的 pid；比较整个字，读取后换过占用者时不会误回收
+    void reclaim() {
+        for (size_t idx = 0; idx < ring_.header()->slots; ++idx) {
+            RingSlot* slot  = ring_.slot(idx);
+            uint64_t  word  = slot->state.load(std::memory_order_acquire);
+            SlotState state = slotState(word);
+            if ((state == kWriting || state == kDone) && processExited(slotPid(word))) {
+                slot->state.compare_exchange_strong(word, packSlot(kFree, 0), std::memory_order_acq_rel);
+            }
+        }
+    }
+
+    std::string              name_;               // < 共享内存段名称
+    SharedMapping            mapping_;            // < 共享内存段的映射
+    RingView                 ring_;               // < 共享内存布局
+    std::vector<RingWorker>  workers_;            // < 每个推理线程的模型
+    std::vector<std::thread> threads_;            // < 推理线程
+    std::atomic<bool>        stopped_{false};     // < 是否已停止
+    std::atomic<uint64_t>    frames_{0};          // < 已完成推理的帧数量
+    std::atomic<uint64_t>    batches_{0};         // < 已执行的批量数量
+};
+
+FrameRingServer::FrameRingServer(const std::string& name, const std::string& task, const std::vector<std::string>& trt_engine_files,
+                                 const InferOption& infer_option, const FrameRingOptions& options)
+    : impl_(std::make_unique<Impl>(name, task, trt_engine_files, infer_option, options)) {}
+
+FrameRingServer::~FrameRingServer() = default;
+
+void FrameRingServer::stop() {
+    impl_->stop();
+}
+
+uint64_t FrameRingServer::frames() const {
+    return impl_->frames();
+}
+
+uint64_t FrameRingServer::batches() const {
+    return impl_->batches();
+}
+
+class FrameRingClient::Impl {
+public:
+    Impl(const std::string& name, int timeout_ms) : mapping_(SharedMapping::open(shmName(name))), ring_(mapping_.data()), timeout_(timeout_ms) {
+        const RingHeader* header = ring_.header();
+        if (mapping_.size() < RingView::headerBytes() || std::memcmp(header->magic, kRingMagic, sizeof(kRingMagic)) != 0 ||
+            header->version != kRingVersion || mapping_.size() < RingView::headerBytes() + header->slot_bytes * header->slots) {
+            throw std::runtime_error("FrameRingClient: " + name + " is not a frame ring.");
+        }
+    }
+
+    TaskType task() const { return static_cast<TaskType>(ring_.header()->task); }
+    int      maxWidth() const { return ring_.header()->max_width; }
+    int      maxHeight() const { return ring_.header()->max_height; }
+
+    template <typename ResultType>
+    ResultType predict(const Image& image, TaskType expected) {
+        RingHeader* header = ring_.header();
+        if (task() != expected) {
+            throw std::invalid_argument("FrameRingClient: the server runs a " + taskTypeToString(task()) + " model.");
+        }
+        if (image.channels != 3 || image.width > header->max_width || image.height > header->max_height) {
+            throw std::invalid_argument("FrameRingClient: image must have 3 channels and fit in " + std::to_string(header->max_width) + "x" +
+                                        std::to_string(header->max_height) + ".");
+        }
+        if (!header->running.load(std::memory_order_acquire)) throw std::runtime_error("FrameRingClient: the server has stopped.");
+
+        auto      steady_deadline = std::chrono::steady_clock::now() + timeout_;
+        auto      system_deadline = std::chrono::system_clock::now() + timeout_;
+        int32_t   pid             = currentProcessId();
+        size_t    idx             = claim(pid, steady_deadline);
+        RingSlot* slot            = ring_.slot(idx);
+
+        // 写入像素，行距不同时逐行拷贝
+        while (tryWaitSemaphore(&slot->done)) {}  // 清除上一次使用遗留的计数
+        size_t row_bytes = static_cast<size_t>(image.width) * 3;
+        auto*  src       = static_cast<const uint8_t*>(image.ptr);
+        if (image.pitch == row_bytes) {
+            std::memcpy(ring_.frame(idx), src, row_bytes * image.height);
+        } else {
+            for (int y = 0; y < image.height; ++y) std::memcpy(ring_.frame(idx) + y * row_bytes, src + y * image.pitch, row_bytes);
+        }
+        slot->width    = image.width;
+        slot->height   = image.height;
+        slot->sequence = header->sequence.fetch_add(1, std::memory_order_relaxed);
+
+        // 只有仍处于 kWriting 时才能发布；失败说明槽位已被回收，可能已属于其他生产者，不能再访问
+        uint64_t writing = packSlot(kWriting, pid);
+        if (!slot->state.compare_exchange_strong(writing, packSlot(kReady, pid), std::memory_order_acq_rel)) {
+            throw std::runtime_error("FrameRingClient: the slot was reclaimed by the server while writing the frame.");
+        }
+        postSemaphore(&header->ready);
+
+        if (!waitSemaphore(&slot->done, system_deadline)) abandon(slot, pid);
+
+        ResultType  result;
+        std::string error;
+        bool        failed = slot->failed;
+        if (failed) {
+            error.assign(reinterpret_cast<const char*>(ring_.result(idx)), slot->result_size);
+        } else {
+            try {
+                ResultReader reader(ring_.result(idx), slot->result_size);
+                result = readResult<ResultType>(reader);
+            } catch (...) {
+                freeSlot(slot);
+                throw;
+            }
+        }
+        freeSlot(slot);
+
+        if (failed) throw std::runtime_error("FrameRingServer: " + error);
+        return result;
+    }
+
+private:
+    // 占用一个空闲槽位，状态和 pid 一并写入，没有空闲槽位时等待到截止时间
+    size_t claim(int32_t pid, std::chrono::steady_clock::time_point deadline) {
+        RingHeader* header = ring_.header();
+        while (true) {
+            size_t start = static_cast<size_t>(header->sequence.load(std::memory_order_relaxed) % header->slots);
+            for (size_t offset = 0; offset < header->slots; ++offset) {
+                size_t   idx      = (start + offset) % header->slots;
+                uint64_t expected = packSlot(kFree, 0);
+                if (ring_.slot(idx)->state.compare_exchange_strong(expected, packSlot(kWriting, pid), std::memory_order_acq_rel)) return idx;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                throw std::runtime_error("FrameRingClient: no free slot within the timeout, all slots are in flight.");
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    // 等待超时：帧尚未被取走时直接释放槽位，推理中时交给推理线程释放；结果恰好已写回（kDone）时照常读取
+    void abandon(RingSlot* slot, int32_t pid) {
+        uint64_t expected = packSlot(kReady, pid);
+        if (!slot->state.compare_exchange_strong(expected, packSlot(kFree, 0), std::memory_order_acq_rel)) {
+            expected = packSlot(kProcessing, pid);
+            if (!slot->state.compare_exchange_strong(expected, packSlot(kAbandoned, 0), std::memory_order_acq_rel)) return;
+        }
+        const char* reason = ring_.header()->running.load(std::memory_order_acquire) ? "timed out waiting for the result."
+                                                                                       : "the server has stopped.";
+        throw std::runtime_error(std::string("FrameRingClient: ") + reason);
+    }
+
+    SharedMapping             mapping_;  // < 共享内存段的映射
+    RingView                  ring_;     // < 共享内存布局
+    std::chrono::milliseconds timeout_;  // < 等待空闲槽位和结果的超时时间
+};
+
+FrameRingClient::FrameRingClient(const std::string& name, int timeout_ms) : impl_(std::make_unique<Impl>(name, timeout_ms)) {}
+FrameRingClient::~FrameRingClient()                                          = default;
+FrameRingClient::FrameRingClient(FrameRingClient&& other) noexcept            = default;
+FrameRingClient& FrameRingClient::operator=(FrameRingClient&& other) noexcept = default;
+
+TaskType FrameRingClient::task() const {
+    return impl_->task();
+}
+
+int FrameRingClient::maxWidth() const {
+    return impl_->maxWidth();
+}
+
+int FrameRingClient::maxHeight() const {
+    return impl_->maxHeight();
+}
+
+ClassifyRes FrameRingClient::predictClassify(const Image& image) {
+    return impl_->predict<ClassifyRes>(image, TaskType::Classify);
+}
+
+DetectRes FrameRingClient::predictDetect(const Image& image) {
+    return impl_->predict<DetectRes>(image, TaskType::Detect);
+}
+
+OBBRes FrameRingClient::predictOBB(const Image& image) {
+    return impl_->predict<OBBRes>(image, TaskType::OBB);
+}
+
+SegmentRes FrameRingClient::predictSegment(const Image& image) {
+    return impl_->predict<SegmentRes>(image, TaskType::Segment);
+}
+
+PoseRes FrameRingClient::predictPose(const Image& image) {
+    return impl_->predict<PoseRes>(image, TaskType::Pose);
+}
+
+}  // namespace trtyolo
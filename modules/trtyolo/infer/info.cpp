@@ -0,0 +1,300 @@
+/**
+ * @file info.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 引擎元数据的提取、旁车文件读写和任务类型推断
+ * @date 2025-06-24
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "core/core.hpp"
+#include "trtyolo.hpp"
+#include "utils/common.hpp"
+
+namespace trtyolo {
+
+namespace {
+
+constexpr const char* kSidecarMagic   = "trtyolo-engine-info";  // < 旁车文件标识
+constexpr int         kSidecarVersion = 1;                      // < 旁车文件格式版本
+
+std::string dtypeToString(nvinfer1::DataType dtype) {
+    switch (dtype) {
+        case nvinfer1::DataType::kFLOAT:
+            return "float32";
+        case nvinfer1::DataType::kHALF:
+            return "float16";
+        case nvinfer1::DataType::kINT32:
+            return "int32";
+        case nvinfer1::DataType::kINT8:
+            return "int8";
+        case nvinfer1::DataType::kUINT8:
+            return "uint8";
+        case nvinfer1::DataType::kBOOL:
+            return "bool";
+        case nvinfer1::DataType::kFP8:
+            return "fp8";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+std::vector<int64_t> dimsToVector(const nvinfer1::Dims& dims) {
+    return std::vector<int64_t>(dims.d, dims.d + std::max(dims.nbDims, 0));
+}
+
+std::string shapeToString(const std::vector<int64_t>& shape) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if (i) oss << ',';
+        oss << shape[i];
+    }
+    return shape.empty() ? "-" : oss.str();
+}
+
+std::vector<int64_t> shapeFromString(const std::string& str) {
+    std::vector<int64_t> shape;
+    if (str == "-") return shape;
+    std::istringstream iss(str);
+    for (std::string dim; std::getline(iss, dim, ',');) shape.push_back(std::stoll(dim));
+    return shape;
+}
+
+TaskType taskTypeFromString(const std::string& str) {
+    for (auto task : {TaskType::Classify, TaskType::Detect, TaskType::OBB, TaskType::Segment, TaskType::Pose}) {
+        if (taskTypeToString(task) == str) return task;
+    }
+    return TaskType::Unknown;
+}
+
+bool contains(const std::string& name, const char* keyword) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    return lower.find(keyword) != std::string::npos;
+}
+
+/**
+ * @brief 由输出张量推断任务类型，优先依据张量名称，其次依据张量形状
+ *
+ * - 分类：单个输出 [B, K, 2]（topk）
+ * - 检测：num / boxes[B, N, 4] / scores / classes
+ * - 旋转检测：boxes 最后一维为 5
+ * - 分割：额外的四维掩码输出 [B, N, H, W]
+ * - 姿态：额外的四维关键点输出 [B, N, K, 2|3]
+ */
+TaskType inferTaskType(const std::vector<TensorDesc>& tensors) {
+    std::vector<const TensorDesc*> outputs;
+    for (const auto& tensor : tensors) {
+        if (!tensor.input) outputs.push_back(&tensor);
+    }
+
+    if (outputs.size() == 1 && outputs.front()->shape.size() == 3) return TaskType::Classify;
+    if (outputs.size() < 4) return TaskType::Unknown;
+
+    for (const auto* output : outputs) {
+        if (contains(output->name, "mask")) return TaskType::Segment;
+        if (contains(output->name, "kpt") || contains(output->name, "keypoint")) return TaskType::Pose;
+    }
+
+    const TensorDesc* boxes = nullptr;
+    const TensorDesc* extra = nullptr;
+    for (const auto* output : outputs) {
+        if (!boxes && output->shape.size() == 3 && (output->shape.back() == 4 || output->shape.back() == 5)) boxes = output;
+        if (!extra && output->shape.size() == 4 && output->dtype == "float32") extra = output;
+    }
+
+    if (!boxes) return TaskType::Unknown;
+    if (boxes->shape.back() == 5) return TaskType::OBB;
+    if (extra) return extra->shape.back() <= 3 ? TaskType::Pose : TaskType::Segment;
+    return TaskType::Detect;
+}
+
+/**
+ * @brief 获取引擎文件的大小和修改时间，用于校验旁车文件是否过期
+ */
+std::pair<uint64_t, int64_t> fileStamp(const std::string& file) {
+    namespace fs = std::filesystem;
+
+    auto size  = static_cast<uint64_t>(fs::file_size(file));
+    auto mtime = static_cast<int64_t>(fs::last_write_time(file).time_since_epoch().count());
+    return {size, mtime};
+}
+
+}  // namespace
+
+std::string taskTypeToString(TaskType task) {
+    switch (task) {
+        case TaskType::Classify:
+            return "classify";
+        case TaskType::Detect:
+            return "detect";
+        case TaskType::OBB:
+            return "obb";
+        case TaskType::Segment:
+            return "segment";
+        case TaskType::Pose:
+            return "pose";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+EngineInfo EngineInfo::fromEngine(const std::string& trt_engine_file) {
+    std::string engine_buffer;
+    ReadBinaryFromFile(trt_engine_file, &engine_buffer);
+
+    TRTManager manager;
+    manager.initialize(engine_buffer.data(), engine_buffer.size());
+
+    EngineInfo info;
+    std::tie(info.engine_size, info.engine_mtime) = fileStamp(trt_engine_file);
+
+    int num_profiles = manager.getNbOptimizationProfiles();
+    for (int i = 0, n = manager.getNbIOTensors(); i < n; ++i) {
+        TensorDesc tensor;
+        tensor.name  = manager.getIOTensorName(i);
+        tensor.input = manager.getTensorIOMode(tensor.name.c_str()) == nvinfer1::TensorIOMode::kINPUT;
+        tensor.dtype = dtypeToString(manager.getTensorDataType(tensor.name.c_str()));
+        tensor.shape = dimsToVector(manager.getTensorShape(tensor.name.c_str()));
+
+        if (tensor.input) {
+            bool dynamic = std::any_of(tensor.shape.begin(), tensor.shape.end(), [](int64_t val) { return val == -1; });
+            if (dynamic) {
+                for (int p = 0; p < num_profiles; ++p) {
+                    tensor.profiles.push_back(ProfileRange{
+                        dimsToVector(manager.getProfileShape(tensor.name.c_str(), p, nvinfer1::OptProfileSelector::kMIN)),
+                        dimsToVector(manager.getProfileShape(tensor.name.c_str(), p, nvinfer1::OptProfileSelector::kOPT)),
+                        dimsToVector(manager.getProfileShape(tensor.name.c_str(), p, nvinfer1::OptProfileSelector::kMAX))});
+                }
+            }
+
+            // 与 TrtBackend 一致：以第一个输入张量和配置文件 0 确定批量范围
+            if (info.max_batch == 0 && !tensor.shape.empty()) {
+                info.dynamic   = dynamic;
+                info.min_batch = dynamic ? static_cast<int>(tensor.profiles.front().min.front()) : static_cast<int>(tensor.shape.front());
+                info.max_batch = dynamic ? static_cast<int>(tensor.profiles.front().max.front()) : static_cast<int>(tensor.shape.front());
+            }
+        }
+        info.tensors.emplace_back(std::move(tensor));
+    }
+
+    info.task = inferTaskType(info.tensors);
+    return info;
+}
+
+EngineInfo EngineInfo::load(const std::string& sidecar_file) {
+    std::ifstream fin(sidecar_file);
+    if (!fin.is_open()) {
+        throw std::runtime_error("Failed to open file: " + sidecar_file + " to read.");
+    }
+
+    auto invalid = [&](const std::string& reason) {
+        return std::runtime_error("EngineInfo: invalid sidecar file " + sidecar_file + ": " + reason);
+    };
+
+    std::string magic;
+    int         version = 0;
+    if (!(fin >> magic >> version) || magic != kSidecarMagic || version != kSidecarVersion) {
+        throw invalid("unsupported header");
+    }
+
+    EngineInfo info;
+    for (std::string key; fin >> key;) {
+        if (key == "engine_size") {
+            fin >> info.engine_size;
+        } else if (key == "engine_mtime") {
+            fin >> info.engine_mtime;
+        } else if (key == "task") {
+            std::string task;
+            fin >> task;
+            info.task = taskTypeFromString(task);
+        } else if (key == "batch") {
+            fin >> info.dynamic >> info.min_batch >> info.max_batch;
+        } else if (key == "tensor") {
+            // tensor <input|output> <dtype> <shape> <name>，名称放在行尾以允许包含空格
+            TensorDesc  tensor;
+            std::string mode, shape;
+            fin >> mode >> tensor.dtype >> shape;
+            std::getline(fin >> std::ws, tensor.name);
+            tensor.input = (mode == "input");
+            tensor.shape = shapeFromString(shape);
+            info.tensors.emplace_back(std::move(tensor));
+        } else if (key == "profile") {
+            // profile <min> <opt> <max>，属于最近一个 tensor
+            if (info.tensors.empty()) throw invalid("profile before tensor");
+            std::string min, opt, max;
+            fin >> min >> opt >> max;
+            info.tensors.back().profiles.push_back(ProfileRange{shapeFromString(min), shapeFromString(opt), shapeFromString(max)});
+        } else {
+            throw invalid("unknown key '" + key + "'");
+        }
+        if (!fin) throw invalid("truncated entry '" + key + "'");
+    }
+    return info;
+}
+
+void EngineInfo::save(const std::string& sidecar_file) const {
+    // 先写入临时文件再重命名，避免并发读取到不完整的旁车文件
+    std::string   tmp_file = sidecar_file + ".tmp";
+    std::ofstream fout(tmp_file, std::ios::out | std::ios::trunc);
+    if (!fout.is_open()) {
+        throw std::runtime_error("Failed to open file: " + tmp_file + " to write.");
+    }
+
+    fout << kSidecarMagic << ' ' << kSidecarVersion << '\n';
+    fout << "engine_size " << engine_size << '\n';
+    fout << "engine_mtime " << engine_mtime << '\n';
+    fout << "task " << taskTypeToString(task) << '\n';
+    fout << "batch " << dynamic << ' ' << min_batch << ' ' << max_batch << '\n';
+    for (const auto& tensor : tensors) {
+        fout << "tensor " << (tensor.input ? "input" : "output") << ' ' << tensor.dtype << ' ' << shapeToString(tensor.shape) << ' ' << tensor.name << '\n';
+        for (const auto& profile : tensor.profiles) {
+            fout << "profile " << shapeToString(profile.min) << ' ' << shapeToString(profile.opt) << ' ' << shapeToString(profile.max) << '\n';
+        }
+    }
+    fout.close();
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_file, sidecar_file, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_file, ec);
+        throw std::runtime_error("Failed to write file: " + sidecar_file + ".");
+    }
+}
+
+std::string EngineInfo::sidecarPath(const std::string& trt_engine_file) {
+    return trt_engine_file + ".info";
+}
+
+EngineInfo EngineInfo::inspect(const std::string& trt_engine_file) {
+    auto sidecar_file  = sidecarPath(trt_engine_file);
+    auto [size, mtime] = fileStamp(trt_engine_file);
+
+    if (std::filesystem::exists(sidecar_file)) {
+        try {
+            auto info = load(sidecar_file);
+            if (info.engine_size == size && info.engine_mtime == mtime) return info;
+        } catch (const std::exception&) {
+            // 旁车文件损坏时重新生成
+        }
+    }
+
+    auto info = fromEngine(trt_engine_file);
+    try {
+        info.save(sidecar_file);
+    } catch (const std::exception&) {
+        // 引擎所在目录只读时仍返回元数据，只是无法缓存
+    }
+    return info;
+}
+
+}  // namespace trtyolo
@@ -116,24 +116,6 @@ __global__ void gpuMutliLetterbox(const void* __restrict__ src, const int src_co
               element_x, element_y);
 }
 
-void Transform::update(int src_width, int src_height, int dst_width, int dst_height) {
-    if (src_width == last_src_width_ && src_height == last_src_height_) return;
-    last_src_width_  = src_width;
-    last_src_height_ = src_height;
-
-    scale        = std::min(static_cast<float>(dst_width) / src_width, static_cast<float>(dst_height) / src_height);
-    int valid_w  = static_cast<int>(roundf(scale * src_width));
-    int valid_h  = static_cast<int>(roundf(scale * src_height));
-    int offset_x = (dst_width - valid_w) / 2;
-    int offset_y = (dst_height - valid_h) / 2;
-    meta         = make_int4(valid_w, valid_h, offset_x, offset_y);
-}
-
-void Transform::apply(float x, float y, float* transformed_x, float* transformed_y) const {
-    *transformed_x = (x - meta.z) / scale;
-    *transformed_y = (y - meta.w) / scale;
-}
-
 void cudaLetterbox(const void* src, const int src_cols, const int src_rows, const size_t src_pitch,
                    void* dst, const int dst_cols, const int dst_rows,
                    const int4 meta, const ProcessConfig config, cudaStream_t stream) {
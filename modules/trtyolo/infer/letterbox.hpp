@@ -10,7 +10,9 @@
 
 #pragma once
 
+#ifndef TRTYOLO_HOST_ONLY
 #include <cuda_runtime_api.h>
+#endif
 
 #include "utils/common.hpp"
 
@@ -47,6 +49,8 @@ struct Transform {
     void apply(float x, float y, float* transformed_x, float* transformed_y) const;
 };
 
+#ifndef TRTYOLO_HOST_ONLY
+
 /**
  * @brief 使用 CUDA 对图像应用 Letterbox 缩放和归一化。
  *
@@ -87,4 +91,6 @@ void cudaMultiLetterbox(const void* src, const int src_cols, const int src_rows,
                         void* dst, const int dst_cols, const int dst_rows, const int4 meta,
                         const ProcessConfig config, int num_images, cudaStream_t stream);
 
+#endif  // TRTYOLO_HOST_ONLY
+
 }  // namespace trtyolo
\ No newline at end of file
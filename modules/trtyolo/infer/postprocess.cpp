@@ -0,0 +1,208 @@
+/**
+ * @file postprocess.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 各任务后处理函数的实现
+ * @date 2025-07-08
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include "postprocess.hpp"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace trtyolo {
+
+// ClassifyModel 的后处理方法实现
+ClassifyRes postProcessClassify(const OutputViews& outputs, const Transform& /*transform*/, int idx) {
+    const auto&  tensor_info = outputs[OutputRole::Topk];
+    const float* topk        = static_cast<const float*>(tensor_info.data) + idx * tensor_info.shape[1] * tensor_info.shape[2];
+
+    ClassifyRes result;
+    result.num = tensor_info.shape[1];
+    result.scores.reserve(result.num);
+    result.classes.reserve(result.num);
+
+    for (int i = 0; i < result.num; ++i) {
+        result.scores.push_back(topk[i * tensor_info.shape[2]]);
+        result.classes.push_back(topk[i * tensor_info.shape[2] + 1]);
+    }
+
+    return result;
+}
+
+// DetectModel 的后处理方法实现
+DetectRes postProcessDetect(const OutputViews& outputs, const Transform& transform, int idx) {
+    const auto& num_tensor   = outputs[OutputRole::Num];
+    const auto& box_tensor   = outputs[OutputRole::Boxes];
+    const auto& score_tensor = outputs[OutputRole::Scores];
+    const auto& class_tensor = outputs[OutputRole::Classes];
+
+    int          num     = static_cast<const int*>(num_tensor.data)[idx];
+    const float* boxes   = static_cast<const float*>(box_tensor.data) + idx * box_tensor.shape[1] * box_tensor.shape[2];
+    const float* scores  = static_cast<const float*>(score_tensor.data) + idx * score_tensor.shape[1];
+    const int*   classes = static_cast<const int*>(class_tensor.data) + idx * class_tensor.shape[1];
+
+    DetectRes result;
+    result.num   = num;
+    int box_size = box_tensor.shape[2];
+
+    result.boxes.reserve(num);
+    result.scores.reserve(num);
+    result.classes.reserve(num);
+
+    for (int i = 0; i < num; ++i) {
+        int   base_index = i * box_size;
+        float left = boxes[base_index], top = boxes[base_index + 1];
+        float right = boxes[base_index + 2], bottom = boxes[base_index + 3];
+
+        transform.apply(left, top, &left, &top);
+        transform.apply(right, bottom, &right, &bottom);
+
+        result.boxes.emplace_back(Box{left, top, right, bottom});
+        result.scores.push_back(scores[i]);
+        result.classes.push_back(classes[i]);
+    }
+
+    return result;
+}
+
+// OBBModel 的后处理方法实现
+OBBRes postProcessOBB(const OutputViews& outputs, const Transform& transform, int idx) {
+    const auto& num_tensor   = outputs[OutputRole::Num];
+    const auto& box_tensor   = outputs[OutputRole::Boxes];
+    const auto& score_tensor = outputs[OutputRole::Scores];
+    const auto& class_tensor = outputs[OutputRole::Classes];
+
+    int          num     = static_cast<const int*>(num_tensor.data)[idx];
+    const float* boxes   = static_cast<const float*>(box_tensor.data) + idx * box_tensor.shape[1] * box_tensor.shape[2];
+    const float* scores  = static_cast<const float*>(score_tensor.data) + idx * score_tensor.shape[1];
+    const int*   classes = static_cast<const int*>(class_tensor.data) + idx * class_tensor.shape[1];
+
+    OBBRes result;
+    result.num   = num;
+    int box_size = box_tensor.shape[2];
+
+    result.boxes.reserve(num);
+    result.scores.reserve(num);
+    result.classes.reserve(num);
+
+    for (int i = 0; i < num; ++i) {
+        int   base_index = i * box_size;
+        float left = boxes[base_index], top = boxes[base_index + 1];
+        float right = boxes[base_index + 2], bottom = boxes[base_index + 3];
+        float theta = boxes[base_index + 4];
+
+        transform.apply(left, top, &left, &top);
+        transform.apply(right, bottom, &right, &bottom);
+
+        result.boxes.emplace_back(RotatedBox{left, top, right, bottom, theta});
+        result.scores.push_back(scores[i]);
+        result.classes.push_back(classes[i]);
+    }
+
+    return result;
+}
+
+// SegmentModel 的后处理方法实现
+SegmentRes postProcessSegment(const OutputViews& outputs, const Transform& transform, int idx) {
+    const auto& num_tensor   = outputs[OutputRole::Num];
+    const auto& box_tensor   = outputs[OutputRole::Boxes];
+    const auto& score_tensor = outputs[OutputRole::Scores];
+    const auto& class_tensor = outputs[OutputRole::Classes];
+    const auto& mask_tensor  = outputs[OutputRole::Masks];
+    int         mask_height  = mask_tensor.shape[2];
+    int         mask_width   = mask_tensor.shape[3];
+
+    int          num     = static_cast<const int*>(num_tensor.data)[idx];
+    const float* boxes   = static_cast<const float*>(box_tensor.data) + idx * box_tensor.shape[1] * box_tensor.shape[2];
+    const float* scores  = static_cast<const float*>(score_tensor.data) + idx * score_tensor.shape[1];
+    const int*   classes = static_cast<const int*>(class_tensor.data) + idx * class_tensor.shape[1];
+    const float* masks   = static_cast<const float*>(mask_tensor.data) + idx * mask_tensor.shape[1] * mask_height * mask_width;
+
+    SegmentRes result;
+    result.num   = num;
+    int box_size = box_tensor.shape[2];
+
+    result.boxes.reserve(num);
+    result.scores.reserve(num);
+    result.classes.reserve(num);
+    result.masks.reserve(num);
+
+    for (int i = 0; i < num; ++i) {
+        int   base_index = i * box_size;
+        float left = boxes[base_index], top = boxes[base_index + 1];
+        float right = boxes[base_index + 2], bottom = boxes[base_index + 3];
+
+        transform.apply(left, top, &left, &top);
+        transform.apply(right, bottom, &right, &bottom);
+
+        result.boxes.emplace_back(Box{left, top, right, bottom});
+        result.scores.push_back(scores[i]);
+        result.classes.push_back(classes[i]);
+
+        Mask mask(mask_width, mask_height);
+        // Directly copy all mask data without edge cropping
+        int  start_idx = i * mask_height * mask_width;
+        std::memcpy(mask.data.data(), masks + start_idx, mask_height * mask_width * sizeof(float));
+
+        result.masks.emplace_back(std::move(mask));
+    }
+
+    return result;
+}
+
+// PoseModel 的后处理方法实现
+PoseRes postProcessPose(const OutputViews& outputs, const Transform& transform, int idx) {
+    const auto& num_tensor   = outputs[OutputRole::Num];
+    const auto& box_tensor   = outputs[OutputRole::Boxes];
+    const auto& score_tensor = outputs[OutputRole::Scores];
+    const auto& class_tensor = outputs[OutputRole::Classes];
+    const auto& kpt_tensor   = outputs[OutputRole::Keypoints];
+    int         nkpt         = kpt_tensor.shape[2];
+    int         ndim         = kpt_tensor.shape[3];
+
+    int          num     = static_cast<const int*>(num_tensor.data)[idx];
+    const float* boxes   = static_cast<const float*>(box_tensor.data) + idx * box_tensor.shape[1] * box_tensor.shape[2];
+    const float* scores  = static_cast<const float*>(score_tensor.data) + idx * score_tensor.shape[1];
+    const int*   classes = static_cast<const int*>(class_tensor.data) + idx * class_tensor.shape[1];
+    const float* kpts    = static_cast<const float*>(kpt_tensor.data) + idx * kpt_tensor.shape[1] * nkpt * ndim;
+
+    PoseRes result;
+    result.num   = num;
+    int box_size = box_tensor.shape[2];
+
+    result.boxes.reserve(num);
+    result.scores.reserve(num);
+    result.classes.reserve(num);
+    result.kpts.reserve(num);
+
+    for (int i = 0; i < num; ++i) {
+        int   base_index = i * box_size;
+        float left = boxes[base_index], top = boxes[base_index + 1];
+        float right = boxes[base_index + 2], bottom = boxes[base_index + 3];
+
+        transform.apply(left, top, &left, &top);
+        transform.apply(right, bottom, &right, &bottom);
+
+        result.boxes.emplace_back(Box{left, top, right, bottom});
+        result.scores.push_back(scores[i]);
+        result.classes.push_back(classes[i]);
+
+        std::vector<KeyPoint> keypoints;
+        for (int j = 0; j < nkpt; ++j) {
+            float x = kpts[i * nkpt * ndim + j * ndim];
+            float y = kpts[i * nkpt * ndim + j * ndim + 1];
+            transform.apply(x, y, &x, &y);
+            keypoints.emplace_back((ndim == 2) ? KeyPoint(x, y) : KeyPoint(x, y, kpts[i * nkpt * ndim + j * ndim + 2]));
+        }
+        result.kpts.emplace_back(std::move(keypoints));
+    }
+
+    return result;
+}
+
+}  // namespace trtyolo
@@ -0,0 +1,94 @@
+/**
+ * @file postprocess.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 各任务的后处理函数，只读取主机上的输出张量视图，不依赖推理后端
+ * @date 2025-07-08
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "letterbox.hpp"
+#include "schema.hpp"
+#include "trtyolo.hpp"
+
+namespace trtyolo {
+
+/**
+ * @brief 主机上一个输出张量的只读视图
+ */
+struct OutputView {
+    const void*            data = nullptr;  // < 张量数据（主机内存），未绑定的角色为 nullptr
+    std::array<int64_t, 4> shape{};         // < 张量形状，不足四维时其余维度为 0
+    size_t                 item_bytes = 0;  // < 批量中每个元素占用的字节数
+};
+
+/**
+ * @brief 按输出角色索引的张量视图集合
+ *
+ * 可以指向推理后端的输出缓冲区，也可以指向捕获文件中保存的张量，后处理函数对两者一视同仁。
+ */
+struct OutputViews {
+    std::array<OutputView, static_cast<size_t>(OutputRole::Count)> views{};  // < 各角色的视图
+
+    const OutputView& operator[](OutputRole role) const { return views[static_cast<size_t>(role)]; }
+    OutputView&       operator[](OutputRole role) { return views[static_cast<size_t>(role)]; }
+};
+
+/**
+ * @brief 分类模型的后处理
+ *
+ * @param outputs 输出张量视图
+ * @param transform 第 idx 张图像的仿射变换（分类任务不使用）
+ * @param idx 图像在批量中的下标
+ * @return ClassifyRes 分类结果
+ */
+ClassifyRes postProcessClassify(const OutputViews& outputs, const Transform& transform, int idx);
+
+/**
+ * @brief 检测模型的后处理，将检测框变换回原图坐标
+ *
+ * @param outputs 输出张量视图
+ * @param transform 第 idx 张图像的仿射变换
+ * @param idx 图像在批量中的下标
+ * @return DetectRes 检测结果
+ */
+DetectRes postProcessDetect(const OutputViews& outputs, const Transform& transform, int idx);
+
+/**
+ * @brief 旋转框检测模型的后处理，将检测框变换回原图坐标
+ *
+ * @param outputs 输出张量视图
+ * @param transform 第 idx 张图像的仿射变换
+ * @param idx 图像在批量中的下标
+ * @return OBBRes 旋转框检测结果
+ */
+OBBRes postProcessOBB(const OutputViews& outputs, const Transform& transform, int idx);
+
+/**
+ * @brief 分割模型的后处理，将检测框变换回原图坐标并拷贝掩码
+ *
+ * @param outputs 输出张量视图
+ * @param transform 第 idx 张图像的仿射变换
+ * @param idx 图像在批量中的下标
+ * @return SegmentRes 分割结果
+ */
+SegmentRes postProcessSegment(const OutputViews& outputs, const Transform& transform, int idx);
+
+/**
+ * @brief 姿态估计模型的后处理，将检测框和关键点变换回原图坐标
+ *
+ * @param outputs 输出张量视图
+ * @param transform 第 idx 张图像的仿射变换
+ * @param idx 图像在批量中的下标
+ * @return PoseRes 姿态估计结果
+ */
+PoseRes postProcessPose(const OutputViews& outputs, const Transform& transform, int idx);
+
+}  // namespace trtyolo
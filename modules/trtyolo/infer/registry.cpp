@@ -0,0 +1,290 @@
+/**
+ * @file registry.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 模型注册表的实现，按需构建模型并在内存预算内按 LRU 策略淘汰
+ * @date 2025-06-22
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "trtyolo.hpp"
+
+namespace trtyolo {
+
+namespace {
+
+/**
+ * @brief 任务类型对应的模型构建函数和模型类型
+ */
+struct TaskFactory {
+    std::function<std::shared_ptr<BaseModel>(const std::vector<std::string>&, const InferOption&)> create;
+    const std::type_info*                                                                        type;
+};
+
+template <typename ModelType>
+TaskFactory makeTaskFactory() {
+    return TaskFactory{
+        [](const std::vector<std::string>& trt_engine_files, const InferOption& infer_option) -> std::shared_ptr<BaseModel> {
+            return std::make_shared<ModelType>(trt_engine_files, infer_option);
+        },
+        &typeid(ModelType)};
+}
+
+const TaskFactory& findTaskFactory(const std::string& task) {
+    static const std::unordered_map<std::string, TaskFactory> factories = {
+        {"classify", makeTaskFactory<ClassifyModel>()},
+        {  "detect",   makeTaskFactory<DetectModel>()},
+        { "segment",  makeTaskFactory<SegmentModel>()},
+        {    "pose",     makeTaskFactory<PoseModel>()},
+        {     "obb",      makeTaskFactory<OBBModel>()},
+    };
+
+    auto it = factories.find(task);
+    if (it == factories.end()) {
+        throw std::invalid_argument("ModelRegistry: unknown task '" + task + "', expected one of classify, detect, segment, pose, obb");
+    }
+    return it->second;
+}
+
+}  // namespace
+
+class ModelRegistry::Impl {
+public:
+    Impl(size_t device_budget, size_t pinned_budget)
+        : device_budget_(device_budget), pinned_budget_(pinned_budget) {}
+
+    void add(const std::string& name, const std::string& task, const std::vector<std::string>& trt_engine_files, const InferOption& infer_option) {
+        const auto& factory = findTaskFactory(task);
+        if (trt_engine_files.empty()) {
+            throw std::invalid_argument("ModelRegistry: model '" + name + "' requires at least one engine file");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.count(name)) {
+            throw std::invalid_argument("ModelRegistry: model '" + name + "' is already registered");
+        }
+        entries_.emplace(name, Entry{task, trt_engine_files, infer_option, &factory});
+    }
+
+    std::shared_ptr<BaseModel> get(const std::string& name) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto& entry = findEntry(name);
+
+        if (entry.model) {
+            // 已驻留：移动到 LRU 链表头部，并刷新内存占用（动态输入的暂存缓冲区可能增长）
+            lru_.splice(lru_.begin(), lru_, entry.lru_it);
+            entry.usage = entry.model->memoryUsage();
+            enforceBudget(name, MemoryUsage{});
+            return entry.model;
+        }
+
+        if (entry.loading.valid()) {
+            // 其他线程正在构建：在锁外等待其结果，构建失败时抛出相同的异常
+            auto loading = entry.loading;
+            lock.unlock();
+            return loading.get();
+        }
+
+        // 首次使用或已被淘汰：按上次统计（或估计）的占用先淘汰，再在锁外构建，构建期间不阻塞其他模型的查询
+        std::promise<std::shared_ptr<BaseModel>> promise;
+        entry.loading = promise.get_future().share();
+        auto estimate = entry.usage.device_bytes || entry.usage.pinned_bytes ? entry.usage : estimateUsage(entry.trt_engine_files);
+        enforceBudget(name, estimate);
+        pending_ += estimate;
+        lock.unlock();
+
+        std::shared_ptr<BaseModel> model;
+        try {
+            model = entry.factory->create(entry.trt_engine_files, entry.infer_option);
+        } catch (...) {
+            lock.lock();
+            pending_      -= estimate;
+            entry.loading  = {};
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+        auto usage = model->memoryUsage();
+
+        lock.lock();
+        pending_      -= estimate;
+        entry.loading  = {};
+        entry.model    = model;
+        entry.usage    = usage;
+        entry.lru_it   = lru_.insert(lru_.begin(), name);
+        enforceBudget(name, MemoryUsage{});  // 估计值可能偏小，按实际占用再检查一次
+        promise.set_value(model);
+        return model;
+    }
+
+    std::string task(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return findEntry(name).task;
+    }
+
+    const std::type_info& modelType(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return *findEntry(name).factory->type;
+    }
+
+    bool resident(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(name);
+        return it != entries_.end() && it->second.model != nullptr;
+    }
+
+    void evict(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        release(findEntry(name));
+    }
+
+    MemoryUsage memoryUsage() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return totalUsage();
+    }
+
+private:
+    struct Entry {
+        std::string                      task;              // < 任务类型
+        std::vector<std::string>         trt_engine_files;  // < 引擎文件路径列表
+        InferOption                      infer_option;      // < 推理选项
+        const TaskFactory*               factory;           // < 模型构建函数
+        std::shared_ptr<BaseModel>       model;             // < 已构建的模型，未驻留时为空
+        MemoryUsage                      usage;             // < 最近一次统计的内存占用，淘汰后保留作为下次构建的估计
+        std::list<std::string>::iterator lru_it;            // < 在 LRU 链表中的位置
+
+        std::shared_future<std::shared_ptr<BaseModel>> loading;  // < 正在构建时有效，其他线程在锁外等待
+    };
+
+    Entry& findEntry(const std::string& name) {
+        auto it = entries_.find(name);
+        if (it == entries_.end()) {
+            throw std::out_of_range("ModelRegistry: model '" + name + "' is not registered");
+        }
+        return it->second;
+    }
+
+    const Entry& findEntry(const std::string& name) const {
+        return const_cast<Impl*>(this)->findEntry(name);
+    }
+
+    MemoryUsage totalUsage() const {
+        MemoryUsage total;
+        for (const auto& name : lru_) total += entries_.at(name).usage;
+        return total;
+    }
+
+    void release(Entry& entry) {
+        if (!entry.model) return;
+        lru_.erase(entry.lru_it);
+        entry.model.reset();
+    }
+
+    // 从未构建过的模型没有统计值，以引擎文件大小估计其显存占用（权重占显存的主要部分）
+    static MemoryUsage estimateUsage(const std::vector<std::string>& trt_engine_files) {
+        MemoryUsage     usage;
+        std::error_code ec;
+        for (const auto& file : trt_engine_files) {
+            auto size = std::filesystem::file_size(file, ec);
+            if (!ec) usage.device_bytes += static_cast<size_t>(size);
+        }
+        return usage;
+    }
+
+    // 超出预算时从 LRU 链表尾部淘汰模型，保留刚使用的模型（即使其单独超出预算）。
+    // incoming 为即将构建的模型的预计占用，正在构建的模型的预计占用也计入总量，保证峰值不超出预算。
+    void enforceBudget(const std::string& keep, const MemoryUsage& incoming) {
+        auto total  = totalUsage();
+        total      += pending_;
+        total      += incoming;
+        while ((total.device_bytes > device_budget_ || total.pinned_bytes > pinned_budget_) && !lru_.empty()) {
+            const auto& victim = lru_.back();
+            if (victim == keep) break;
+            auto& entry         = entries_.at(victim);
+            total.device_bytes -= entry.usage.device_bytes;
+            total.pinned_bytes -= entry.usage.pinned_bytes;
+            release(entry);
+        }
+    }
+
+    size_t                                 device_budget_;  // < 设备显存预算
+    size_t                                 pinned_budget_;  // < 锁页主机内存预算
+    std::unordered_map<std::string, Entry> entries_;        // < 已注册的模型
+    std::list<std::string>                 lru_;            // < 驻留模型的 LRU 链表，头部为最近使用
+    MemoryUsage                            pending_;        // < 正在构建的模型的预计占用之和
+    mutable std::mutex                     mutex_;          // < 保护注册表状态的互斥锁
+};
+
+ModelRegistry::ModelRegistry(size_t device_budget, size_t pinned_budget)
+    : impl_(std::make_unique<Impl>(device_budget, pinned_budget)) {}
+
+ModelRegistry::~ModelRegistry() = default;
+
+void ModelRegistry::add(const std::string& name, const std::string& task, const std::vector<std::string>& trt_engine_files, const InferOption& infer_option) {
+    impl_->add(name, task, trt_engine_files, infer_option);
+}
+
+void ModelRegistry::loadManifest(const std::string& manifest_file, const InferOption& infer_option) {
+    std::ifstream fin(manifest_file);
+    if (!fin.is_open()) {
+        throw std::runtime_error("Failed to open file: " + manifest_file + " to read.");
+    }
+
+    std::string line;
+    int         line_no = 0;
+    while (std::getline(fin, line)) {
+        ++line_no;
+        auto start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string        name, task, engines;
+        if (!(iss >> name >> task >> engines)) {
+            throw std::runtime_error("ModelRegistry: invalid manifest entry at " + manifest_file + ":" + std::to_string(line_no));
+        }
+
+        std::vector<std::string> trt_engine_files;
+        std::istringstream       engine_stream(engines);
+        for (std::string engine; std::getline(engine_stream, engine, ',');) {
+            if (!engine.empty()) trt_engine_files.push_back(engine);
+        }
+        add(name, task, trt_engine_files, infer_option);
+    }
+}
+
+std::shared_ptr<BaseModel> ModelRegistry::get(const std::string& name) {
+    return impl_->get(name);
+}
+
+std::string ModelRegistry::task(const std::string& name) const {
+    return impl_->task(name);
+}
+
+bool ModelRegistry::resident(const std::string& name) const {
+    return impl_->resident(name);
+}
+
+void ModelRegistry::evict(const std::string& name) {
+    impl_->evict(name);
+}
+
+MemoryUsage ModelRegistry::memoryUsage() const {
+    return impl_->memoryUsage();
+}
+
+const std::type_info& ModelRegistry::modelType(const std::string& name) const {
+    return impl_->modelType(name);
+}
+
+}  // namespace trtyolo
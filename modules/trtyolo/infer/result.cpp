@@ -0,0 +1,83 @@
+/**
+ * @file result.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 图像和推理结果结构体的实现，只依赖主机代码
+ * @date 2025-07-10
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <cmath>
+#include <stdexcept>
+
+#include "trtyolo.hpp"
+#include "utils/common.hpp"
+
+namespace trtyolo {
+
+Image::Image(void* data, int width, int height) : ptr(data), width(width), height(height), channels(3), pitch(width * sizeof(uint8_t) * 3) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: width and height must be positive"));
+    }
+}
+
+Image::Image(void* data, int width, int height, size_t pitch)
+    : ptr(data), width(width), height(height), channels(3), pitch(pitch) {
+    if (width <= 0 || height <= 0 || channels <= 0) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: width, height and channels must be positive"));
+    }
+    if (pitch < static_cast<size_t>(width * sizeof(uint8_t) * channels)) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: pitch must >= width * channels"));
+    }
+}
+
+Image::Image(void* data, int width, int height, int channels, size_t pitch)
+    : ptr(data), width(width), height(height), channels(channels), pitch(pitch) {
+    if (width <= 0 || height <= 0 || channels <= 0) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: width, height and channels must be positive"));
+    }
+    if (pitch < static_cast<size_t>(width * sizeof(uint8_t) * channels)) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: pitch must >= width * channels"));
+    }
+}
+
+Mask::Mask(int width, int height) : width(width), height(height) {
+    if (width < 0 || height < 0) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Mask: width and height must be positive"));
+    }
+    data.resize(width * height);
+}
+
+std::array<int, 4> Box::xyxy() const {
+    return {static_cast<int>(left), static_cast<int>(top), static_cast<int>(right), static_cast<int>(bottom)};
+}
+
+std::array<float, 8> RotatedBox::corners() const {
+    float cx   = (left + right) * 0.5f;
+    float cy   = (top + bottom) * 0.5f;
+    float dx   = (right - left) * 0.5f;
+    float dy   = (bottom - top) * 0.5f;
+    float cosa = std::cos(theta);
+    float sina = std::sin(theta);
+
+    auto rot = [&](float px, float py) -> std::pair<float, float> {
+        return {px * cosa - py * sina + cx, px * sina + py * cosa + cy};
+    };
+
+    auto [x1, y1] = rot(-dx, -dy);  // 左上
+    auto [x2, y2] = rot(dx, -dy);   // 右上
+    auto [x3, y3] = rot(dx, dy);    // 右下
+    auto [x4, y4] = rot(-dx, dy);   // 左下
+
+    return {x1, y1, x2, y2, x3, y3, x4, y4};
+}
+
+std::array<int, 8> RotatedBox::xyxyxyxy() const {
+    std::array<float, 8> points = corners();
+    std::array<int, 8>   result;
+    for (size_t i = 0; i < points.size(); ++i) result[i] = static_cast<int>(std::round(points[i]));
+    return result;
+}
+
+}  // namespace trtyolo
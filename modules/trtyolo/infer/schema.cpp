@@ -0,0 +1,112 @@
+/**
+ * @file schema.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 各任务输出张量的命名约定，以及按名称绑定输出张量的实现
+ * @date 2025-06-26
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "schema.hpp"
+#include "utils/common.hpp"
+
+namespace trtyolo {
+
+namespace {
+
+// 每个角色接受的张量名称（小写）
+const std::vector<std::string>& roleNames(OutputRole role) {
+    static const std::array<std::vector<std::string>, static_cast<size_t>(OutputRole::Count)> names = {{
+        {"num_dets", "num", "num_detections"},                      // Num
+        {"det_boxes", "boxes", "detection_boxes"},                  // Boxes
+        {"det_scores", "scores", "detection_scores"},               // Scores
+        {"det_classes", "classes", "detection_classes", "labels"},  // Classes
+        {"det_masks", "masks", "detection_masks"},                  // Masks
+        {"det_kpts", "kpts", "keypoints"},                          // Keypoints
+        {"topk"},                                                   // Topk
+    }};
+    return names[static_cast<size_t>(role)];
+}
+
+std::string toLower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+    return str;
+}
+
+std::string joinNames(const std::vector<std::string>& names) {
+    std::string joined;
+    for (const auto& name : names) joined += (joined.empty() ? "" : ", ") + name;
+    return joined;
+}
+
+}  // namespace
+
+const std::vector<OutputRole>& outputSchema(TaskType task) {
+    static const std::vector<OutputRole> classify = {OutputRole::Topk};
+    static const std::vector<OutputRole> detect   = {OutputRole::Num, OutputRole::Boxes, OutputRole::Scores, OutputRole::Classes};
+    static const std::vector<OutputRole> segment  = {OutputRole::Num, OutputRole::Boxes, OutputRole::Scores, OutputRole::Classes, OutputRole::Masks};
+    static const std::vector<OutputRole> pose     = {OutputRole::Num, OutputRole::Boxes, OutputRole::Scores, OutputRole::Classes, OutputRole::Keypoints};
+    static const std::vector<OutputRole> unknown  = {};
+
+    switch (task) {
+        case TaskType::Classify:
+            return classify;
+        case TaskType::Detect:
+        case TaskType::OBB:
+            return detect;
+        case TaskType::Segment:
+            return segment;
+        case TaskType::Pose:
+            return pose;
+        default:
+            break;
+    }
+    return unknown;
+}
+
+OutputBinding bindOutputs(TaskType task, const std::vector<std::string>& names, const std::vector<bool>& inputs) {
+    OutputBinding binding;
+    binding.fill(-1);
+
+    const auto& schema = outputSchema(task);
+    if (schema.empty()) return binding;
+
+    std::vector<int> outputs;
+    for (int i = 0, n = static_cast<int>(names.size()); i < n; ++i) {
+        if (!inputs[i]) outputs.push_back(i);
+    }
+
+    // 1. 按名称匹配
+    int matched = 0;
+    for (auto role : schema) {
+        const auto& accepted = roleNames(role);
+        for (int index : outputs) {
+            if (std::find(accepted.begin(), accepted.end(), toLower(names[index])) != accepted.end()) {
+                binding[static_cast<size_t>(role)] = index;
+                ++matched;
+                break;
+            }
+        }
+    }
+    if (matched == static_cast<int>(schema.size())) return binding;
+
+    // 2. 没有任何名称匹配时，按位置绑定（兼容旧引擎）
+    if (matched == 0 && outputs.size() >= schema.size()) {
+        for (size_t i = 0; i < schema.size(); ++i) binding[static_cast<size_t>(schema[i])] = outputs[i];
+        return binding;
+    }
+
+    // 3. 部分匹配或输出数量不足：报告缺失的张量
+    std::string missing;
+    for (auto role : schema) {
+        if (binding[static_cast<size_t>(role)] < 0) missing += " [" + joinNames(roleNames(role)) + "]";
+    }
+    throw std::invalid_argument(MAKE_ERROR_MESSAGE("bindOutputs: engine outputs do not match the " + taskTypeToString(task) + " schema, missing one of:" + missing));
+}
+
+}  // namespace trtyolo
@@ -0,0 +1,63 @@
+/**
+ * @file schema.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 各任务输出张量的命名约定，以及按名称绑定输出张量
+ * @date 2025-06-26
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "trtyolo.hpp"
+
+namespace trtyolo {
+
+/**
+ * @brief 输出张量在后处理中的角色
+ */
+enum class OutputRole : int {
+    Num = 0,    // < 每张图像的检测数量 [B, 1]
+    Boxes,      // < 检测框 [B, N, 4|5]
+    Scores,     // < 置信度 [B, N]
+    Classes,    // < 类别 [B, N]
+    Masks,      // < 分割掩码 [B, N, H, W]
+    Keypoints,  // < 关键点 [B, N, K, 2|3]
+    Topk,       // < 分类结果 [B, K, 2]
+    Count,      // < 角色数量
+};
+
+/**
+ * @brief 输出张量的绑定结果，记录每个角色在 tensor_infos 中的下标，未使用的角色为 -1
+ */
+using OutputBinding = std::array<int, static_cast<size_t>(OutputRole::Count)>;
+
+/**
+ * @brief 获取任务需要的输出角色（按导出器的默认输出顺序排列）
+ *
+ * @param task 任务类型
+ * @return const std::vector<OutputRole>& 输出角色列表，未知任务返回空列表
+ */
+const std::vector<OutputRole>& outputSchema(TaskType task);
+
+/**
+ * @brief 按名称将引擎的输出张量绑定到任务需要的角色
+ *
+ * 名称匹配不区分大小写，并接受常见导出器的命名（如 `num_dets`、`det_boxes`、`num_detections`、`detection_boxes`）。
+ * 所有角色都无法按名称匹配时，按旧的位置约定依次绑定，以兼容未遵循命名约定的引擎；
+ * 部分匹配时抛出异常，避免输出顺序变化后静默地读取错误的张量。
+ *
+ * @param task 任务类型，未知任务时所有输出按位置绑定到空角色
+ * @param names 所有张量的名称（与 tensor_infos 顺序一致）
+ * @param inputs 每个张量是否为输入张量
+ * @return OutputBinding 绑定结果
+ * @throws std::invalid_argument 如果缺少任务需要的输出张量
+ */
+OutputBinding bindOutputs(TaskType task, const std::vector<std::string>& names, const std::vector<bool>& inputs);
+
+}  // namespace trtyolo
@@ -0,0 +1,37 @@
+/**
+ * @file transform.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 仿射变换的主机端实现，不依赖 CUDA 编译器
+ * @date 2025-07-10
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "letterbox.hpp"
+#include "utils/vector_types.hpp"
+
+namespace trtyolo {
+
+void Transform::update(int src_width, int src_height, int dst_width, int dst_height) {
+    if (src_width == last_src_width_ && src_height == last_src_height_) return;
+    last_src_width_  = src_width;
+    last_src_height_ = src_height;
+
+    scale        = std::min(static_cast<float>(dst_width) / src_width, static_cast<float>(dst_height) / src_height);
+    int valid_w  = static_cast<int>(roundf(scale * src_width));
+    int valid_h  = static_cast<int>(roundf(scale * src_height));
+    int offset_x = (dst_width - valid_w) / 2;
+    int offset_y = (dst_height - valid_h) / 2;
+    meta         = make_int4(valid_w, valid_h, offset_x, offset_y);
+}
+
+void Transform::apply(float x, float y, float* transformed_x, float* transformed_y) const {
+    *transformed_x = (x - meta.z) / scale;
+    *transformed_y = (y - meta.w) / scale;
+}
+
+}  // namespace trtyolo
@@ -8,77 +8,25 @@
  *
  */
 
+#include <array>
+#include <atomic>
 #include <cassert>
-#include <cmath>
+#include <chrono>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <vector_functions.hpp>
 
 #include "backend.hpp"
+#include "capture.hpp"
+#include "family.hpp"
 #include "utils/common.hpp"
+#include "utils/metrics.hpp"
+#include "utils/trace.hpp"
 
 namespace trtyolo {
 
-Image::Image(void* data, int width, int height) : ptr(data), width(width), height(height), channels(3), pitch(width * sizeof(uint8_t) * 3) {
-    if (width <= 0 || height <= 0) {
-        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: width and height must be positive"));
-    }
-}
-
-Image::Image(void* data, int width, int height, size_t pitch)
-    : ptr(data), width(width), height(height), channels(3), pitch(pitch) {
-    if (width <= 0 || height <= 0 || channels <= 0) {
-        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: width, height and channels must be positive"));
-    }
-    if (pitch < static_cast<size_t>(width * sizeof(uint8_t) * channels)) {
-        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: pitch must >= width * channels"));
-    }
-}
-
-Image::Image(void* data, int width, int height, int channels, size_t pitch)
-    : ptr(data), width(width), height(height), channels(channels), pitch(pitch) {
-    if (width <= 0 || height <= 0 || channels <= 0) {
-        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: width, height and channels must be positive"));
-    }
-    if (pitch < static_cast<size_t>(width * sizeof(uint8_t) * channels)) {
-        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Image: pitch must >= width * channels"));
-    }
-}
-
-Mask::Mask(int width, int height) : width(width), height(height) {
-    if (width < 0 || height < 0) {
-        throw std::invalid_argument(MAKE_ERROR_MESSAGE("Mask: width and height must be positive"));
-    }
-    data.resize(width * height);
-}
-
-std::array<int, 4> Box::xyxy() const {
-    return {static_cast<int>(left), static_cast<int>(top), static_cast<int>(right), static_cast<int>(bottom)};
-}
-
-std::array<int, 8> RotatedBox::xyxyxyxy() const {
-    float cx   = (left + right) * 0.5f;
-    float cy   = (top + bottom) * 0.5f;
-    float dx   = (right - left) * 0.5f;
-    float dy   = (bottom - top) * 0.5f;
-    float cosa = std::cos(theta);
-    float sina = std::sin(theta);
-
-    auto rot = [&](float px, float py) -> std::pair<int, int> {
-        int x = static_cast<int>(std::round(px * cosa - py * sina + cx));
-        int y = static_cast<int>(std::round(px * sina + py * cosa + cy));
-        return {x, y};
-    };
-
-    auto [x1, y1] = rot(-dx, -dy);  // 左上
-    auto [x2, y2] = rot(dx, -dy);   // 右上
-    auto [x3, y3] = rot(dx, dy);    // 右下
-    auto [x4, y4] = rot(-dx, dy);   // 左下
-
-    return {x1, y1, x2, y2, x3, y3, x4, y4};
-}
-
 class InferOption::Impl {
 public:
     InferConfig getInferConfig() const { return infer_config; }
@@ -86,6 +34,7 @@ public:
     void        enableCudaMem() { infer_config.cuda_mem = true; }
     void        enableManagedMemory() { infer_config.enable_managed_memory = true; }
     void        enablePerformanceReport() { infer_config.enable_performance_report = true; }
+    void        setProfileSampling(int every) { infer_config.profile_sample_every = every; }
     void        setInputDimensions(int width, int height) { infer_config.input_shape = make_int2(height, width); }
     void        enableSwapRB() { infer_config.config.swap_rb = true; }
     void        setBorderValue(float value) { infer_config.config.border_value = value; }
@@ -106,41 +55,163 @@ private:
 
 InferOption::InferOption() : impl_(std::make_unique<InferOption::Impl>()) {}
 InferOption::~InferOption() = default;
+InferOption::InferOption(const InferOption& other) : impl_(std::make_unique<InferOption::Impl>(*other.impl_)) {}
+InferOption& InferOption::operator=(const InferOption& other) {
+    if (this != &other) *impl_ = *other.impl_;
+    return *this;
+}
 
 void InferOption::setDeviceId(int id) { impl_->setDeviceId(id); }
 void InferOption::enableCudaMem() { impl_->enableCudaMem(); }
 void InferOption::enableManagedMemory() { impl_->enableManagedMemory(); }
 void InferOption::enablePerformanceReport() { impl_->enablePerformanceReport(); }
+void InferOption::setProfileSampling(int every) {
+    if (every < 1) {
+        throw std::invalid_argument(MAKE_ERROR_MESSAGE("InferOption: profile sampling interval must be >= 1"));
+    }
+    impl_->setProfileSampling(every);
+}
 void InferOption::enableSwapRB() { impl_->enableSwapRB(); }
 void InferOption::setBorderValue(float border_value) { impl_->setBorderValue(border_value); }
 void InferOption::setNormalizeParams(const std::vector<float>& mean, const std::vector<float>& std) { impl_->setNormalizeParams(mean, std); }
 void InferOption::setInputDimensions(int width, int height) { impl_->setInputDimensions(height, width); }
 
+namespace {
+
+/**
+ * @brief 模型的性能统计数据，克隆出的模型共享同一份统计
+ *
+ * 统计数据由原子计数和定长直方图组成，多个线程同时记录时无需加锁，内存占用与请求数无关。
+ * 吞吐量按首次调用开始到最后一次调用结束的实际时间计算：多个克隆并行推理时，各克隆的 CPU 耗时之和会超过实际时间。
+ */
+struct ProfileStats {
+    std::atomic<unsigned long long>   total_request{0};                                  // < 总请求数
+    std::atomic<int64_t>              first_start_ns{0};                                 // < 最早一次调用的开始时间（steady_clock），0 表示尚无调用
+    std::atomic<int64_t>              last_stop_ns{0};                                   // < 最晚一次调用的结束时间（steady_clock）
+    std::shared_ptr<LatencyHistogram> cpu_total   = std::make_shared<LatencyHistogram>();  // < 整次调用（CPU）
+    std::shared_ptr<LatencyHistogram> gpu_total   = std::make_shared<LatencyHistogram>();  // < 整次调用（GPU）
+    std::shared_ptr<LatencyHistogram> postprocess = std::make_shared<LatencyHistogram>();  // < 后处理（CPU）
+    std::array<LatencyHistogram, 5>   stages;                                            // < 暂存拷贝、H2D、LetterBox、推理、D2H
+
+    void markStart(std::chrono::steady_clock::time_point time) noexcept {
+        int64_t none = 0;
+        first_start_ns.compare_exchange_strong(none, toNanoseconds(time));
+    }
+
+    void markStop(std::chrono::steady_clock::time_point time) noexcept {
+        int64_t ns = toNanoseconds(time), last = last_stop_ns.load();
+        while (ns > last && !last_stop_ns.compare_exchange_weak(last, ns)) {}
+    }
+
+    double throughput() const noexcept {
+        int64_t first = first_start_ns.load(), span = last_stop_ns.load() - first;
+        return first != 0 && span > 0 ? total_request.load() * 1e9 / span : 0.0;
+    }
+
+    void reset() {
+        total_request  = 0;
+        first_start_ns = 0;
+        last_stop_ns   = 0;
+        cpu_total->reset();
+        gpu_total->reset();
+        postprocess->reset();
+        for (auto& stage : stages) stage.reset();
+    }
+
+private:
+    static int64_t toNanoseconds(std::chrono::steady_clock::time_point time) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+};
+
+/**
+ * @brief 模型的批量占用统计，始终开启，克隆出的模型共享同一份统计
+ */
+struct OccupancyStats {
+    std::atomic<uint64_t> requests{0};  // < 推理调用次数
+    std::atomic<uint64_t> images{0};    // < 请求推理的图像数量
+    std::atomic<uint64_t> slots{0};     // < 实际执行的批量槽位数量
+
+    void record(uint64_t num_images, uint64_t num_slots) noexcept {
+        requests.fetch_add(1, std::memory_order_relaxed);
+        images.fetch_add(num_images, std::memory_order_relaxed);
+        slots.fetch_add(num_slots, std::memory_order_relaxed);
+    }
+
+    void reset() noexcept {
+        requests = 0;
+        images   = 0;
+        slots    = 0;
+    }
+};
+
+// 将内部的内存账本转换为公开的内存占用结构体
+MemoryFootprint toMemoryFootprint(const MemoryLedger& ledger) {
+    auto bytes = [&](BufferType type) { return BufferBytes{ledger.current(type), ledger.peak(type)}; };
+
+    MemoryFootprint footprint;
+    footprint.device   = bytes(BufferType::Device);
+    footprint.discrete = bytes(BufferType::Discrete);
+    footprint.unified  = bytes(BufferType::Unified);
+    footprint.mapped   = bytes(BufferType::Mapped);
+    footprint.total    = BufferBytes{ledger.currentTotal(), ledger.peakTotal()};
+    return footprint;
+}
+
+// 由内存占用的当前值得到设备显存和锁页主机内存，与 MemoryFootprint 中各类型的含义一致
+MemoryUsage toMemoryUsage(const MemoryFootprint& footprint) {
+    return MemoryUsage{footprint.device.current + footprint.discrete.current + footprint.unified.current,
+                       footprint.discrete.current + footprint.mapped.current};
+}
+
+}  // namespace
+
 class BaseModel::Impl {
 public:
     // 私有的无参构造函数，仅在 clone 方法中使用
-    Impl()  = default;
-    ~Impl() = default;
-
-    Impl(const std::string& trt_engine_file, const InferOption& infer_option)
-        : backend_(std::make_unique<TrtBackend>(trt_engine_file, infer_option.impl_->getInferConfig())) {
-        if (backend_->infer_config.enable_performance_report) {
-            infer_gpu_trace_ = std::make_unique<GpuTimer>(backend_->stream);
-            infer_cpu_trace_ = std::make_unique<CpuTimer>();
+    Impl() { MetricsRegistry::instance().models.add(); }
+    ~Impl() { MetricsRegistry::instance().models.sub(); }
+
+    Impl(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option, TaskType task)
+        : family_(std::make_unique<BackendFamily>(trt_engine_files, infer_option.impl_->getInferConfig(), task)) {
+        MetricsRegistry::instance().models.add();
+        if (family_->inferConfig().enable_performance_report) {
+            createTimers(std::make_shared<ProfileStats>());
         }
     }
 
     std::unique_ptr<Impl> clone() const {
-        auto clone_impl              = std::make_unique<Impl>();
-        clone_impl->backend_         = backend_->clone();
-        clone_impl->infer_gpu_trace_ = std::make_unique<GpuTimer>(clone_impl->backend_->stream);
-        clone_impl->infer_cpu_trace_ = std::make_unique<CpuTimer>();
+        auto clone_impl        = std::make_unique<Impl>();
+        clone_impl->family_    = family()->clone();
+        clone_impl->occupancy_ = occupancy_;  // 克隆共享批量占用统计
+        if (profile_) clone_impl->createTimers(profile_);  // 克隆共享统计数据，性能报告覆盖所有克隆
         return clone_impl;
     }
 
+    // 获取当前引擎族的引用，调用期间持有可保证旧引擎在切换后仍然有效
+    std::shared_ptr<BackendFamily> family() const {
+        std::lock_guard<std::mutex> lock(family_mutex_);
+        return family_;
+    }
+
+    // 替换引擎族：新引擎在锁外加载，加载完成后原子切换，旧引擎在最后一个进行中的调用结束后释放
+    void reload(std::shared_ptr<BackendFamily> family) {
+        std::lock_guard<std::mutex> lock(family_mutex_);
+        family_.swap(family);
+    }
+
+    void reload(const std::vector<std::string>& trt_engine_files) {
+        auto family = this->family();
+        reload(std::make_shared<BackendFamily>(trt_engine_files, family->inferConfig(), family->task()));
+    }
+
+    void reloadFrom(const Impl& other) {
+        reload(std::shared_ptr<BackendFamily>(other.family()->clone()));
+    }
+
     std::tuple<std::string, std::string, std::string> performanceReport() {
-        if (backend_->infer_config.enable_performance_report) {
-            float             throughput = total_request_ / infer_cpu_trace_->totalMilliseconds() * 1000;
+        if (family()->inferConfig().enable_performance_report) {
+            double            throughput = profile_->throughput();
             std::stringstream ss;
 
             // 构建吞吐量字符串
@@ -151,7 +222,7 @@ public:
             auto percentiles = std::vector<float>{90, 95, 99};
 
             auto getLatencyStr = [&](const auto& trace, const std::string& device) {
-                auto result = getPerformanceResult(trace->milliseconds(), {0.90, 0.95, 0.99});
+                auto result = getPerformanceResult(trace->histogram(), percentiles);
                 ss << device << " Latency: min = " << result.min << " ms, max = " << result.max
                    << " ms, mean = " << result.mean << " ms, median = " << result.median << " ms";
                 for (int32_t i = 0, n = percentiles.size(); i < n; ++i) {
@@ -165,271 +236,246 @@ public:
             std::string cpuLatencyStr = getLatencyStr(infer_cpu_trace_, "CPU");
             std::string gpuLatencyStr = getLatencyStr(infer_gpu_trace_, "GPU");
 
-            total_request_ = 0;
-            infer_cpu_trace_->reset();
-            infer_gpu_trace_->reset();
-
             return std::make_tuple(throughputStr, cpuLatencyStr, gpuLatencyStr);
         }
         // 性能报告未启用时返回空字符串
         return std::make_tuple("", "", "");
     }
 
-    size_t batch() const {
-        return backend_->max_shape.x;
+    PerformanceBreakdown performanceBreakdown() const {
+        PerformanceBreakdown breakdown;
+        if (!family()->inferConfig().enable_performance_report) return breakdown;
+
+        auto toLatencyStats = [](const LatencyHistogram& histogram) {
+            LatencyStats stats;
+            if (histogram.count() == 0) return stats;
+
+            auto result  = getPerformanceResult(histogram, {90, 95, 99});
+            stats.count  = histogram.count();
+            stats.min    = result.min;
+            stats.max    = result.max;
+            stats.mean   = result.mean;
+            stats.median = result.median;
+            stats.p90    = result.percentiles[0];
+            stats.p95    = result.percentiles[1];
+            stats.p99    = result.percentiles[2];
+            return stats;
+        };
+
+        breakdown.throughput  = profile_->throughput();
+        breakdown.staging     = toLatencyStats(profile_->stages[0]);
+        breakdown.h2d         = toLatencyStats(profile_->stages[1]);
+        breakdown.letterbox   = toLatencyStats(profile_->stages[2]);
+        breakdown.inference   = toLatencyStats(profile_->stages[3]);
+        breakdown.d2h         = toLatencyStats(profile_->stages[4]);
+        breakdown.postprocess = toLatencyStats(*profile_->postprocess);
+        breakdown.cpu_total   = toLatencyStats(*profile_->cpu_total);
+        breakdown.gpu_total   = toLatencyStats(*profile_->gpu_total);
+        return breakdown;
     }
 
-    // 装饰器函数
-    template <typename Func, typename ReturnType>
-    ReturnType withPerformanceReport(const std::vector<Image>& images, Func func) {
-        if (backend_->infer_config.enable_performance_report) {
-            total_request_ += (backend_->dynamic ? images.size() : backend_->max_shape.x);
-            infer_cpu_trace_->start();
-            infer_gpu_trace_->start();
-        }
+    void resetPerformanceReport() {
+        if (profile_) profile_->reset();
+    }
 
-        backend_->infer(images);  // 调用推理方法
-        ReturnType result = func(images.size());
+    size_t batch() const {
+        return family()->batch();
+    }
 
-        if (backend_->infer_config.enable_performance_report) {
-            infer_gpu_trace_->stop();
-            infer_cpu_trace_->stop();
-        }
+    int inputDevice() const {
+        auto        family = this->family();  // 持有引擎族，热重载替换 family_ 时 config 仍然有效
+        const auto& config = family->inferConfig();
+        return config.cuda_mem ? config.device_id : -1;
+    }
 
-        return result;
+    int numOutputBoxes() const {
+        auto family = this->family();
+        auto role   = family->task() == TaskType::Classify ? OutputRole::Topk : OutputRole::Boxes;
+        return static_cast<int>(family->members().front()->outputViews()[role].shape[1]);
     }
 
-    // ClassifyModel 的后处理方法实现
-    ClassifyRes postProcessClassify(int idx) {
-        auto&  tensor_info = backend_->tensor_infos[1];
-        float* topk        = static_cast<float*>(tensor_info.buffer->host()) + idx * tensor_info.shape.d[1] * tensor_info.shape.d[2];
+    MemoryUsage memoryUsage() const {
+        return toMemoryUsage(memoryFootprint());
+    }
 
-        ClassifyRes result;
-        result.num = tensor_info.shape.d[1];
-        result.scores.reserve(result.num);
-        result.classes.reserve(result.num);
+    BatchOccupancy batchOccupancy() const {
+        return BatchOccupancy{occupancy_->requests.load(), occupancy_->images.load(), occupancy_->slots.load()};
+    }
 
-        for (int i = 0; i < result.num; ++i) {
-            result.scores.push_back(topk[i * tensor_info.shape.d[2]]);
-            result.classes.push_back(topk[i * tensor_info.shape.d[2] + 1]);
-        }
+    void resetBatchOccupancy() {
+        occupancy_->reset();
+    }
 
-        return result;
+    MemoryFootprint memoryFootprint() const {
+        auto            family = this->family();
+        MemoryFootprint footprint;
+        for (const auto& backend : family->members()) footprint += toMemoryFootprint(backend->memoryLedger());
+        return footprint;
     }
 
-    // DetectModel 的后处理方法实现
-    DetectRes postProcessDetect(int idx) {
-        auto& num_tensor   = backend_->tensor_infos[1];
-        auto& box_tensor   = backend_->tensor_infos[2];
-        auto& score_tensor = backend_->tensor_infos[3];
-        auto& class_tensor = backend_->tensor_infos[4];
-
-        int    num     = static_cast<int*>(num_tensor.buffer->host())[idx];
-        float* boxes   = static_cast<float*>(box_tensor.buffer->host()) + idx * box_tensor.shape.d[1] * box_tensor.shape.d[2];
-        float* scores  = static_cast<float*>(score_tensor.buffer->host()) + idx * score_tensor.shape.d[1];
-        int*   classes = static_cast<int*>(class_tensor.buffer->host()) + idx * class_tensor.shape.d[1];
-
-        DetectRes result;
-        result.num   = num;
-        int box_size = box_tensor.shape.d[2];
-
-        auto& transform = backend_->infer_config.input_shape.has_value()
-                              ? backend_->transforms.front()
-                              : backend_->transforms[idx];
-
-        result.boxes.reserve(num);
-        result.scores.reserve(num);
-        result.classes.reserve(num);
-
-        for (int i = 0; i < num; ++i) {
-            int   base_index = i * box_size;
-            float left = boxes[base_index], top = boxes[base_index + 1];
-            float right = boxes[base_index + 2], bottom = boxes[base_index + 3];
-
-            transform.apply(left, top, &left, &top);
-            transform.apply(right, bottom, &right, &bottom);
-
-            result.boxes.emplace_back(Box{left, top, right, bottom});
-            result.scores.push_back(scores[i]);
-            result.classes.push_back(classes[i]);
-        }
+    // 装饰器函数
+    template <typename Func, typename ReturnType>
+    ReturnType withPerformanceReport(const std::vector<Image>& images, Func func) {
+        TraceScope trace("predict", trace_id_);
+        auto&      metrics = MetricsRegistry::instance();
+        auto       start   = std::chrono::steady_clock::now();
+        GaugeScope in_flight(metrics.queue_depth);
 
-        return result;
-    }
+        // 同一实例共享一组输入输出缓冲区，并发调用在此串行执行；需要并行时每个线程使用一个克隆
+        std::lock_guard<std::mutex> lock(predict_mutex_);
 
-    // OBBModel 的后处理方法实现
-    OBBRes postProcessOBB(int idx) {
-        auto& num_tensor   = backend_->tensor_infos[1];
-        auto& box_tensor   = backend_->tensor_infos[2];
-        auto& score_tensor = backend_->tensor_infos[3];
-        auto& class_tensor = backend_->tensor_infos[4];
-
-        int    num     = static_cast<int*>(num_tensor.buffer->host())[idx];
-        float* boxes   = static_cast<float*>(box_tensor.buffer->host()) + idx * box_tensor.shape.d[1] * box_tensor.shape.d[2];
-        float* scores  = static_cast<float*>(score_tensor.buffer->host()) + idx * score_tensor.shape.d[1];
-        int*   classes = static_cast<int*>(class_tensor.buffer->host()) + idx * class_tensor.shape.d[1];
-
-        OBBRes result;
-        result.num   = num;
-        int box_size = box_tensor.shape.d[2];
-
-        auto& transform = backend_->infer_config.input_shape.has_value()
-                              ? backend_->transforms.front()
-                              : backend_->transforms[idx];
-
-        result.boxes.reserve(num);
-        result.scores.reserve(num);
-        result.classes.reserve(num);
-
-        for (int i = 0; i < num; ++i) {
-            int   base_index = i * box_size;
-            float left = boxes[base_index], top = boxes[base_index + 1];
-            float right = boxes[base_index + 2], bottom = boxes[base_index + 3];
-            float theta = boxes[base_index + 4];
-
-            transform.apply(left, top, &left, &top);
-            transform.apply(right, bottom, &right, &bottom);
-
-            result.boxes.emplace_back(RotatedBox{left, top, right, bottom, theta});
-            result.scores.push_back(scores[i]);
-            result.classes.push_back(classes[i]);
+        auto  family  = this->family();                 // 持有引擎族直到本次调用结束
+        auto& backend = family->select(images.size());  // 选择填充槽位最少的后端
+
+        if (backend.infer_config.enable_performance_report) {
+            profile_->total_request += (backend.dynamic ? images.size() : backend.max_shape.x);
+            profile_->markStart(start);
+            infer_gpu_trace_->setStream(backend.stream);
+            infer_cpu_trace_->start();
+            infer_gpu_trace_->start();
         }
 
-        return result;
-    }
+        {
+            TraceScope infer_trace("infer");
+            backend.infer(images);  // 调用推理方法
+        }
 
-    // SegmentModel 的后处理方法实现
-    SegmentRes postProcessSegment(int idx) {
-        auto& num_tensor   = backend_->tensor_infos[1];
-        auto& box_tensor   = backend_->tensor_infos[2];
-        auto& score_tensor = backend_->tensor_infos[3];
-        auto& class_tensor = backend_->tensor_infos[4];
-        auto& mask_tensor  = backend_->tensor_infos[5];
-        int   mask_height  = mask_tensor.shape.d[2];
-        int   mask_width   = mask_tensor.shape.d[3];
-
-        int    num     = static_cast<int*>(num_tensor.buffer->host())[idx];
-        float* boxes   = static_cast<float*>(box_tensor.buffer->host()) + idx * box_tensor.shape.d[1] * box_tensor.shape.d[2];
-        float* scores  = static_cast<float*>(score_tensor.buffer->host()) + idx * score_tensor.shape.d[1];
-        int*   classes = static_cast<int*>(class_tensor.buffer->host()) + idx * class_tensor.shape.d[1];
-        float* masks   = static_cast<float*>(mask_tensor.buffer->host()) + idx * mask_tensor.shape.d[1] * mask_height * mask_width;
-
-        SegmentRes result;
-        result.num   = num;
-        int box_size = box_tensor.shape.d[2];
-
-        auto& transform = backend_->infer_config.input_shape.has_value()
-                              ? backend_->transforms.front()
-                              : backend_->transforms[idx];
-
-        result.boxes.reserve(num);
-        result.scores.reserve(num);
-        result.classes.reserve(num);
-        result.masks.reserve(num);
-
-        for (int i = 0; i < num; ++i) {
-            int   base_index = i * box_size;
-            float left = boxes[base_index], top = boxes[base_index + 1];
-            float right = boxes[base_index + 2], bottom = boxes[base_index + 3];
-
-            transform.apply(left, top, &left, &top);
-            transform.apply(right, bottom, &right, &bottom);
-
-            result.boxes.emplace_back(Box{left, top, right, bottom});
-            result.scores.push_back(scores[i]);
-            result.classes.push_back(classes[i]);
-
-            Mask mask(mask_width, mask_height);
-            // Directly copy all mask data without edge cropping
-            int  start_idx = i * mask_height * mask_width;
-            std::memcpy(mask.data.data(), masks + start_idx, mask_height * mask_width * sizeof(float));
-
-            result.masks.emplace_back(std::move(mask));
+        auto& capture = CaptureWriter::instance();
+        if (capture.enabled()) {
+            TraceScope capture_trace("capture");
+            capture.write(trace_id_, backend, images);  // 在后处理之前记录原始输出
         }
 
-        return result;
-    }
+        if (backend.infer_config.enable_performance_report) {
+            auto times = backend.stageTimes();
+            profile_->stages[0].record(times.staging);
+            profile_->stages[1].record(times.h2d);
+            profile_->stages[2].record(times.letterbox);
+            profile_->stages[3].record(times.inference);
+            profile_->stages[4].record(times.d2h);
+            postprocess_trace_->start();
+        }
+
+        ReturnType result;
+        {
+            TraceScope postprocess_trace("postprocess");
+            result = func(backend, images.size());
+        }
 
-    // PoseModel 的后处理方法实现
-    PoseRes postProcessPose(int idx) {
-        auto& num_tensor   = backend_->tensor_infos[1];
-        auto& box_tensor   = backend_->tensor_infos[2];
-        auto& score_tensor = backend_->tensor_infos[3];
-        auto& class_tensor = backend_->tensor_infos[4];
-        auto& kpt_tensor   = backend_->tensor_infos[5];
-        int   nkpt         = kpt_tensor.shape.d[2];
-        int   ndim         = kpt_tensor.shape.d[3];
-
-        int    num     = static_cast<int*>(num_tensor.buffer->host())[idx];
-        float* boxes   = static_cast<float*>(box_tensor.buffer->host()) + idx * box_tensor.shape.d[1] * box_tensor.shape.d[2];
-        float* scores  = static_cast<float*>(score_tensor.buffer->host()) + idx * score_tensor.shape.d[1];
-        int*   classes = static_cast<int*>(class_tensor.buffer->host()) + idx * class_tensor.shape.d[1];
-        float* kpts    = static_cast<float*>(kpt_tensor.buffer->host()) + idx * kpt_tensor.shape.d[1] * nkpt * ndim;
-
-        PoseRes result;
-        result.num   = num;
-        int box_size = box_tensor.shape.d[2];
-
-        auto& transform = backend_->infer_config.input_shape.has_value()
-                              ? backend_->transforms.front()
-                              : backend_->transforms[idx];
-
-        result.boxes.reserve(num);
-        result.scores.reserve(num);
-        result.classes.reserve(num);
-        result.kpts.reserve(num);
-
-        for (int i = 0; i < num; ++i) {
-            int   base_index = i * box_size;
-            float left = boxes[base_index], top = boxes[base_index + 1];
-            float right = boxes[base_index + 2], bottom = boxes[base_index + 3];
-
-            transform.apply(left, top, &left, &top);
-            transform.apply(right, bottom, &right, &bottom);
-
-            result.boxes.emplace_back(Box{left, top, right, bottom});
-            result.scores.push_back(scores[i]);
-            result.classes.push_back(classes[i]);
-
-            std::vector<KeyPoint> keypoints;
-            for (int j = 0; j < nkpt; ++j) {
-                float x = kpts[i * nkpt * ndim + j * ndim];
-                float y = kpts[i * nkpt * ndim + j * ndim + 1];
-                transform.apply(x, y, &x, &y);
-                keypoints.emplace_back((ndim == 2) ? KeyPoint(x, y) : KeyPoint(x, y, kpts[i * nkpt * ndim + j * ndim + 2]));
-            }
-            result.kpts.emplace_back(std::move(keypoints));
+        if (backend.infer_config.enable_performance_report) {
+            postprocess_trace_->stop();
+            infer_gpu_trace_->stop();
+            infer_cpu_trace_->stop();
+            profile_->markStop(std::chrono::steady_clock::now());
         }
 
+        size_t slots = backend.dynamic ? images.size() : backend.max_shape.x;
+        occupancy_->record(images.size(), slots);
+        metrics.requests.inc();
+        metrics.images.inc(images.size());
+        metrics.batch_slots.inc(slots);
+        metrics.batch_fill.observe(static_cast<double>(images.size()) / slots);
+        metrics.latency.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
         return result;
     }
 
 private:
-    std::unique_ptr<TrtBackend> backend_;           // < TensorRT 后端
-    unsigned long long          total_request_{0};  // < 总请求数
-    std::unique_ptr<GpuTimer>   infer_gpu_trace_;   // < GPU推理计时器
-    std::unique_ptr<CpuTimer>   infer_cpu_trace_;   // < CPU推理计时器
+    void createTimers(std::shared_ptr<ProfileStats> profile) {
+        profile_           = std::move(profile);
+        infer_gpu_trace_   = std::make_unique<GpuTimer>(family_->members().front()->stream, profile_->gpu_total,
+                                                          family_->inferConfig().profile_sample_every);
+        infer_cpu_trace_   = std::make_unique<CpuTimer>(profile_->cpu_total);
+        postprocess_trace_ = std::make_unique<CpuTimer>(profile_->postprocess);
+    }
+
+    std::shared_ptr<BackendFamily>  family_;             // < TensorRT 引擎族
+    mutable std::mutex              family_mutex_;       // < 保护引擎族切换的互斥锁
+    std::mutex                      predict_mutex_;      // < 串行化同一实例上的并发调用
+    std::shared_ptr<ProfileStats>   profile_;            // < 性能统计数据（与克隆共享）
+    std::unique_ptr<GpuTimer>       infer_gpu_trace_;    // < GPU推理计时器
+    std::unique_ptr<CpuTimer>       infer_cpu_trace_;    // < CPU推理计时器
+    std::unique_ptr<CpuTimer>       postprocess_trace_;  // < 后处理计时器
+    std::shared_ptr<OccupancyStats> occupancy_{std::make_shared<OccupancyStats>()};  // < 批量占用统计（与克隆共享）
+    uint32_t                        trace_id_{TraceRecorder::instance().nextModelId()};  // < 追踪事件中的模型实例编号（克隆各自编号）
 };
 
 BaseModel::BaseModel()  = default;
 BaseModel::~BaseModel() = default;
 
 BaseModel::BaseModel(const std::string& trt_engine_file, const InferOption& infer_option)
-    : impl_(std::make_unique<Impl>(trt_engine_file, infer_option)) {}
+    : BaseModel(std::vector<std::string>{trt_engine_file}, infer_option) {}
+
+BaseModel::BaseModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option)
+    : BaseModel(trt_engine_files, infer_option, TaskType::Unknown) {}
+
+BaseModel::BaseModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option, TaskType task)
+    : impl_(std::make_unique<Impl>(trt_engine_files, infer_option, task)) {}
 
 int BaseModel::batch() const {
     return impl_->batch();
 }
 
+int BaseModel::inputDevice() const {
+    return impl_->inputDevice();
+}
+
+int BaseModel::numOutputBoxes() const {
+    return impl_->numOutputBoxes();
+}
+
+MemoryUsage BaseModel::memoryUsage() const {
+    return impl_->memoryUsage();
+}
+
+MemoryFootprint BaseModel::memoryFootprint() const {
+    return impl_->memoryFootprint();
+}
+
+MemoryFootprint processMemoryFootprint() {
+    return toMemoryFootprint(MemoryLedger::global());
+}
+
+void BaseModel::reload(const std::string& trt_engine_file) {
+    impl_->reload(std::vector<std::string>{trt_engine_file});
+}
+
+void BaseModel::reload(const std::vector<std::string>& trt_engine_files) {
+    impl_->reload(trt_engine_files);
+}
+
+void BaseModel::reloadFrom(const BaseModel& model) {
+    impl_->reloadFrom(*model.impl_);
+}
+
 std::tuple<std::string, std::string, std::string> BaseModel::performanceReport() {
     return impl_->performanceReport();
 }
 
+void BaseModel::resetPerformanceReport() {
+    impl_->resetPerformanceReport();
+}
+
+PerformanceBreakdown BaseModel::performanceBreakdown() const {
+    return impl_->performanceBreakdown();
+}
+
+BatchOccupancy BaseModel::batchOccupancy() const {
+    return impl_->batchOccupancy();
+}
+
+void BaseModel::resetBatchOccupancy() {
+    impl_->resetBatchOccupancy();
+}
+
 ClassifyModel::ClassifyModel()  = default;
 ClassifyModel::~ClassifyModel() = default;
 
 ClassifyModel::ClassifyModel(const std::string& trt_engine_file, const InferOption& infer_option)
-    : BaseModel(trt_engine_file, infer_option) {}
+    : ClassifyModel(std::vector<std::string>{trt_engine_file}, infer_option) {}
+
+ClassifyModel::ClassifyModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option)
+    : BaseModel(trt_engine_files, infer_option, TaskType::Classify) {}
 
 std::unique_ptr<ClassifyModel> ClassifyModel::clone() const {
     auto clone_model   = std::make_unique<ClassifyModel>();
@@ -438,10 +484,11 @@ std::unique_ptr<ClassifyModel> ClassifyModel::clone() const {
 }
 
 std::vector<ClassifyRes> ClassifyModel::predict(const std::vector<Image>& images) {
-    auto processImages = [this](size_t num) -> std::vector<ClassifyRes> {
+    auto processImages = [](TrtBackend& backend, size_t num) -> std::vector<ClassifyRes> {
         std::vector<ClassifyRes> results(num);
+        auto outputs = backend.outputViews();
         for (size_t idx = 0; idx < num; ++idx) {
-            results[idx] = this->impl_->postProcessClassify(idx);
+            results[idx] = postProcessClassify(outputs, backend.transform(idx), idx);
         }
         return results;
     };
@@ -458,7 +505,10 @@ DetectModel::DetectModel()  = default;
 DetectModel::~DetectModel() = default;
 
 DetectModel::DetectModel(const std::string& trt_engine_file, const InferOption& infer_option)
-    : BaseModel(trt_engine_file, infer_option) {}
+    : DetectModel(std::vector<std::string>{trt_engine_file}, infer_option) {}
+
+DetectModel::DetectModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option)
+    : BaseModel(trt_engine_files, infer_option, TaskType::Detect) {}
 
 std::unique_ptr<DetectModel> DetectModel::clone() const {
     auto clone_model   = std::make_unique<DetectModel>();
@@ -467,10 +517,11 @@ std::unique_ptr<DetectModel> DetectModel::clone() const {
 }
 
 std::vector<DetectRes> DetectModel::predict(const std::vector<Image>& images) {
-    auto processImages = [this](size_t num) -> std::vector<DetectRes> {
+    auto processImages = [](TrtBackend& backend, size_t num) -> std::vector<DetectRes> {
         std::vector<DetectRes> results(num);
+        auto outputs = backend.outputViews();
         for (size_t idx = 0; idx < num; ++idx) {
-            results[idx] = this->impl_->postProcessDetect(idx);
+            results[idx] = postProcessDetect(outputs, backend.transform(idx), idx);
         }
         return results;
     };
@@ -487,7 +538,10 @@ OBBModel::OBBModel()  = default;
 OBBModel::~OBBModel() = default;
 
 OBBModel::OBBModel(const std::string& trt_engine_file, const InferOption& infer_option)
-    : BaseModel(trt_engine_file, infer_option) {}
+    : OBBModel(std::vector<std::string>{trt_engine_file}, infer_option) {}
+
+OBBModel::OBBModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option)
+    : BaseModel(trt_engine_files, infer_option, TaskType::OBB) {}
 
 std::unique_ptr<OBBModel> OBBModel::clone() const {
     auto clone_model   = std::make_unique<OBBModel>();
@@ -496,10 +550,11 @@ std::unique_ptr<OBBModel> OBBModel::clone() const {
 }
 
 std::vector<OBBRes> OBBModel::predict(const std::vector<Image>& images) {
-    auto processImages = [this](size_t num) -> std::vector<OBBRes> {
+    auto processImages = [](TrtBackend& backend, size_t num) -> std::vector<OBBRes> {
         std::vector<OBBRes> results(num);
+        auto outputs = backend.outputViews();
         for (size_t idx = 0; idx < num; ++idx) {
-            results[idx] = this->impl_->postProcessOBB(idx);
+            results[idx] = postProcessOBB(outputs, backend.transform(idx), idx);
         }
         return results;
     };
@@ -516,7 +571,10 @@ SegmentModel::SegmentModel()  = default;
 SegmentModel::~SegmentModel() = default;
 
 SegmentModel::SegmentModel(const std::string& trt_engine_file, const InferOption& infer_option)
-    : BaseModel(trt_engine_file, infer_option) {}
+    : SegmentModel(std::vector<std::string>{trt_engine_file}, infer_option) {}
+
+SegmentModel::SegmentModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option)
+    : BaseModel(trt_engine_files, infer_option, TaskType::Segment) {}
 
 std::unique_ptr<SegmentModel> SegmentModel::clone() const {
     auto clone_model   = std::make_unique<SegmentModel>();
@@ -525,10 +583,11 @@ std::unique_ptr<SegmentModel> SegmentModel::clone() const {
 }
 
 std::vector<SegmentRes> SegmentModel::predict(const std::vector<Image>& images) {
-    auto processImages = [this](size_t num) -> std::vector<SegmentRes> {
+    auto processImages = [](TrtBackend& backend, size_t num) -> std::vector<SegmentRes> {
         std::vector<SegmentRes> results(num);
+        auto outputs = backend.outputViews();
         for (size_t idx = 0; idx < num; ++idx) {
-            results[idx] = this->impl_->postProcessSegment(idx);
+            results[idx] = postProcessSegment(outputs, backend.transform(idx), idx);
         }
         return results;
     };
@@ -545,7 +604,10 @@ PoseModel::PoseModel()  = default;
 PoseModel::~PoseModel() = default;
 
 PoseModel::PoseModel(const std::string& trt_engine_file, const InferOption& infer_option)
-    : BaseModel(trt_engine_file, infer_option) {}
+    : PoseModel(std::vector<std::string>{trt_engine_file}, infer_option) {}
+
+PoseModel::PoseModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option)
+    : BaseModel(trt_engine_files, infer_option, TaskType::Pose) {}
 
 std::unique_ptr<PoseModel> PoseModel::clone() const {
     auto clone_model   = std::make_unique<PoseModel>();
@@ -554,10 +616,11 @@ std::unique_ptr<PoseModel> PoseModel::clone() const {
 }
 
 std::vector<PoseRes> PoseModel::predict(const std::vector<Image>& images) {
-    auto processImages = [this](size_t num) -> std::vector<PoseRes> {
+    auto processImages = [](TrtBackend& backend, size_t num) -> std::vector<PoseRes> {
         std::vector<PoseRes> results(num);
+        auto outputs = backend.outputViews();
         for (size_t idx = 0; idx < num; ++idx) {
-            results[idx] = this->impl_->postProcessPose(idx);
+            results[idx] = postProcessPose(outputs, backend.transform(idx), idx);
         }
         return results;
     };
@@ -17,10 +17,12 @@
 #endif
 
 #include <array>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <string>
+#include <typeinfo>
 #include <vector>
 
 namespace trtyolo {
@@ -183,6 +185,13 @@ struct TRTYOLOAPI RotatedBox : public Box {
      */
     std::array<int, 8> xyxyxyxy() const;
 
+    /**
+     * @brief 返回旋转矩形框四个角点的浮点坐标，格式同 xyxyxyxy，不取整
+     *
+     * @return std::array<float, 8> 旋转矩形框的角点坐标数组
+     */
+    std::array<float, 8> corners() const;
+
     friend std::ostream& operator<<(std::ostream& os, const RotatedBox& rbox) {
         os << "RotatedBox(left=" << rbox.left << ", top=" << rbox.top << ", right=" << rbox.right << ", bottom=" << rbox.bottom << ", theta=" << rbox.theta << ")";
         return os;
@@ -382,6 +391,241 @@ struct TRTYOLOAPI PoseRes : public BaseRes {
     }
 };
 
+/**
+ * @brief 内存占用结构体，用于统计模型的设备显存和锁页主机内存
+ */
+struct TRTYOLOAPI MemoryUsage {
+    size_t device_bytes = 0;  // < 设备显存字节数（统一内存计入显存）
+    size_t pinned_bytes = 0;  // < 锁页主机内存字节数
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        device_bytes += other.device_bytes;
+        pinned_bytes += other.pinned_bytes;
+        return *this;
+    }
+
+    MemoryUsage& operator-=(const MemoryUsage& other) {
+        device_bytes -= other.device_bytes;
+        pinned_bytes -= other.pinned_bytes;
+        return *this;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const MemoryUsage& usage) {
+        os << "MemoryUsage(device_bytes=" << usage.device_bytes << ", pinned_bytes=" << usage.pinned_bytes << ")";
+        return os;
+    }
+};
+
+/**
+ * @brief 某类缓冲区的当前和峰值字节数
+ */
+struct TRTYOLOAPI BufferBytes {
+    size_t current = 0;  // < 当前字节数
+    size_t peak    = 0;  // < 峰值字节数
+
+    BufferBytes& operator+=(const BufferBytes& other) {
+        current += other.current;
+        peak    += other.peak;
+        return *this;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BufferBytes& bytes) {
+        os << "BufferBytes(current=" << bytes.current << ", peak=" << bytes.peak << ")";
+        return os;
+    }
+};
+
+/**
+ * @brief 按缓冲区类型统计的内存占用，字节数为缓冲区的分配大小
+ *
+ * 分离内存在设备和锁页主机上各占用该字节数，统一内存由驱动在设备和主机间迁移，映射内存只占用锁页主机内存，
+ * 因此锁页主机内存为 discrete + mapped。total 的峰值是合计占用的峰值，不等于各类型峰值之和。
+ */
+struct TRTYOLOAPI MemoryFootprint {
+    BufferBytes device;    // < 仅设备内存（输入张量、任务不使用的输出张量）
+    BufferBytes discrete;  // < 分离内存（设备内存 + 锁页主机内存）
+    BufferBytes unified;   // < 统一内存
+    BufferBytes mapped;    // < 映射内存（锁页主机内存）
+    BufferBytes total;     // < 合计
+
+    MemoryFootprint& operator+=(const MemoryFootprint& other) {
+        device   += other.device;
+        discrete += other.discrete;
+        unified  += other.unified;
+        mapped   += other.mapped;
+        total    += other.total;
+        return *this;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const MemoryFootprint& footprint) {
+        os << "MemoryFootprint(device=" << footprint.device << ", discrete=" << footprint.discrete << ", unified=" << footprint.unified
+           << ", mapped=" << footprint.mapped << ", total=" << footprint.total << ")";
+        return os;
+    }
+};
+
+/**
+ * @brief 获取进程内所有缓冲区（所有模型和克隆）的内存占用
+ *
+ * @return 按缓冲区类型统计的当前和峰值字节数
+ */
+TRTYOLOAPI MemoryFootprint processMemoryFootprint();
+
+/**
+ * @brief 延迟统计结构体（毫秒）
+ */
+struct TRTYOLOAPI LatencyStats {
+    uint64_t count  = 0;    // < 样本数量
+    float    min    = 0.f;  // < 最小值
+    float    max    = 0.f;  // < 最大值
+    float    mean   = 0.f;  // < 平均值
+    float    median = 0.f;  // < 中位数
+    float    p90    = 0.f;  // < 90 百分位数
+    float    p95    = 0.f;  // < 95 百分位数
+    float    p99    = 0.f;  // < 99 百分位数
+
+    friend std::ostream& operator<<(std::ostream& os, const LatencyStats& stats) {
+        os << "LatencyStats(count=" << stats.count << ", min=" << stats.min << ", max=" << stats.max << ", mean=" << stats.mean
+           << ", median=" << stats.median << ", p90=" << stats.p90 << ", p95=" << stats.p95 << ", p99=" << stats.p99 << ")";
+        return os;
+    }
+};
+
+/**
+ * @brief 各推理阶段的延迟分解，仅在启用性能报告时统计
+ *
+ * GPU 阶段由推理流上的 CUDA 事件划分；未发生的阶段（如 cudaMem 输入时的暂存拷贝和 H2D）耗时为 0。
+ */
+struct TRTYOLOAPI PerformanceBreakdown {
+    double       throughput = 0.0;  // < 吞吐量（qps），按首次调用开始到最后一次调用结束的实际时间计算
+    LatencyStats staging;           // < 输入拷贝到主机暂存缓冲区（CPU）
+    LatencyStats h2d;               // < 主机到设备拷贝（GPU）
+    LatencyStats letterbox;         // < LetterBox 预处理（GPU）
+    LatencyStats inference;         // < 引擎推理（GPU）
+    LatencyStats d2h;               // < 设备到主机拷贝（GPU）
+    LatencyStats postprocess;       // < 后处理（CPU）
+    LatencyStats cpu_total;         // < 整次调用（CPU）
+    LatencyStats gpu_total;         // < 整次调用（GPU）
+};
+
+/**
+ * @brief 批量占用统计，区分请求的图像数量和实际执行的批量槽位数量
+ *
+ * 动态引擎按实际图像数量执行，静态引擎每次都执行最大批量，多出的槽位为填充浪费。
+ * 统计始终开启，与性能报告无关，克隆出的模型共享同一份统计。
+ */
+struct TRTYOLOAPI BatchOccupancy {
+    uint64_t requests = 0;  // < 推理调用次数
+    uint64_t images   = 0;  // < 请求推理的图像数量
+    uint64_t slots    = 0;  // < 实际执行的批量槽位数量
+
+    double   fillRatio() const { return slots ? static_cast<double>(images) / slots : 0.0; }  // < 槽位填充率
+    uint64_t padding() const { return slots - images; }                                      // < 填充浪费的槽位数量
+
+    friend std::ostream& operator<<(std::ostream& os, const BatchOccupancy& occupancy) {
+        os << "BatchOccupancy(requests=" << occupancy.requests << ", images=" << occupancy.images << ", slots=" << occupancy.slots
+           << ", fill_ratio=" << occupancy.fillRatio() << ")";
+        return os;
+    }
+};
+
+/**
+ * @brief 任务类型枚举，由引擎的输出张量推断
+ */
+enum class TaskType {
+    Unknown,   // < 未知任务
+    Classify,  // < 图像分类
+    Detect,    // < 目标检测
+    OBB,       // < 旋转目标检测
+    Segment,   // < 实例分割
+    Pose       // < 姿态估计
+};
+
+/**
+ * @brief 将任务类型转换为字符串（classify、detect、obb、segment、pose、unknown）
+ *
+ * @param task 任务类型
+ * @return 任务类型字符串
+ */
+TRTYOLOAPI std::string taskTypeToString(TaskType task);
+
+/**
+ * @brief 优化配置文件中某个输入张量的形状范围
+ */
+struct TRTYOLOAPI ProfileRange {
+    std::vector<int64_t> min;  // < 最小形状
+    std::vector<int64_t> opt;  // < 最优形状
+    std::vector<int64_t> max;  // < 最大形状
+};
+
+/**
+ * @brief 引擎输入输出张量的描述
+ */
+struct TRTYOLOAPI TensorDesc {
+    std::string               name;      // < 张量名称
+    bool                      input;     // < 是否为输入张量
+    std::string               dtype;     // < 数据类型（float32、float16、int32 等）
+    std::vector<int64_t>      shape;     // < 张量形状，动态维度为 -1
+    std::vector<ProfileRange> profiles;  // < 各优化配置文件的形状范围（仅输入张量）
+};
+
+/**
+ * @brief 引擎元数据结构体，用于在不反序列化引擎的情况下获取引擎信息
+ *
+ * 首次检查引擎时会反序列化引擎并写入同目录下的旁车文件（`<engine>.info`），
+ * 之后只要引擎文件的大小和修改时间未变化，就直接读取旁车文件，
+ * 便于调度器在毫秒级内规划大量引擎的放置和批量大小。
+ */
+struct TRTYOLOAPI EngineInfo {
+    std::vector<TensorDesc> tensors;                           // < 输入输出张量描述
+    TaskType                task         = TaskType::Unknown;  // < 由输出张量推断的任务类型
+    bool                    dynamic      = false;              // < 是否为动态形状
+    int                     min_batch    = 0;                  // < 最小批量大小
+    int                     max_batch    = 0;                  // < 最大批量大小
+    uint64_t                engine_size  = 0;                  // < 引擎文件大小，用于校验旁车文件是否过期
+    int64_t                 engine_mtime = 0;                  // < 引擎文件修改时间，用于校验旁车文件是否过期
+
+    /**
+     * @brief 获取引擎元数据，旁车文件有效时直接读取，否则反序列化引擎并写入旁车文件
+     *
+     * @param trt_engine_file TensorRT 引擎文件路径
+     * @return 引擎元数据
+     */
+    static EngineInfo inspect(const std::string& trt_engine_file);
+
+    /**
+     * @brief 反序列化引擎并提取元数据（不读写旁车文件）
+     *
+     * @param trt_engine_file TensorRT 引擎文件路径
+     * @return 引擎元数据
+     */
+    static EngineInfo fromEngine(const std::string& trt_engine_file);
+
+    /**
+     * @brief 从旁车文件读取元数据
+     *
+     * @param sidecar_file 旁车文件路径
+     * @return 引擎元数据
+     * @throws std::runtime_error 如果文件无法打开或格式错误
+     */
+    static EngineInfo load(const std::string& sidecar_file);
+
+    /**
+     * @brief 将元数据写入旁车文件
+     *
+     * @param sidecar_file 旁车文件路径
+     */
+    void save(const std::string& sidecar_file) const;
+
+    /**
+     * @brief 获取引擎对应的旁车文件路径
+     *
+     * @param trt_engine_file TensorRT 引擎文件路径
+     * @return 旁车文件路径
+     */
+    static std::string sidecarPath(const std::string& trt_engine_file);
+};
+
 /**
  * @brief 推理选项配置类
  */
@@ -389,6 +633,8 @@ class TRTYOLOAPI InferOption {
 public:
     InferOption();
     ~InferOption();
+    InferOption(const InferOption& other);
+    InferOption& operator=(const InferOption& other);
 
     /**
      * @brief 设置 GPU 设备 ID
@@ -415,6 +661,15 @@ public:
      */
     void enablePerformanceReport();
 
+    /**
+     * @brief 设置 GPU 计时的采样间隔，每 every 次请求计时一次（默认 1）
+     *
+     * GPU 计时的事件对异步读取，不会阻塞主机；增大采样间隔可进一步降低开启性能报告时的开销。
+     *
+     * @param every 采样间隔，必须 >= 1
+     */
+    void setProfileSampling(int every);
+
     /**
      * @brief 设置图像通道交换
      *
@@ -470,20 +725,137 @@ public:
     explicit BaseModel(const std::string& trt_engine_file, const InferOption& infer_option);
 
     /**
-     * @brief 获取批量大小
+     * @brief 构造一个由多个引擎组成的 BaseModel 对象（引擎族）
+     *
+     * 引擎列表为同一网络以不同批量大小构建的引擎（如 1、4、16），每次推理时选择填充槽位最少的引擎。
+     *
+     * @param trt_engine_files TensorRT 引擎文件路径列表
+     * @param infer_option 推理选项
+     */
+    explicit BaseModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option);
+
+    /**
+     * @brief 获取批量大小（引擎族时为族内最大批量）
      *
      * @return 批量大小
      */
     int batch() const;
 
+    /**
+     * @brief 获取输入图像所在的设备
+     *
+     * 启用 InferOption::enableCudaMem 时输入图像指向该 CUDA 设备上的显存，否则指向主机内存。
+     *
+     * @return CUDA 设备 ID，输入为主机内存时返回 -1
+     */
+    int inputDevice() const;
+
+    /**
+     * @brief 获取每张图像最多输出的目标数量（分类模型为 top-k 的 k）
+     *
+     * 由引擎输出张量的第二维决定，可用于预先分配 `numOutputBoxes() * batch()` 大小的结果缓冲区。
+     *
+     * @return 每张图像的最大目标数量
+     */
+    int numOutputBoxes() const;
+
+    /**
+     * @brief 获取模型当前的内存占用（由张量缓冲区和输入暂存缓冲区统计，不包含引擎权重）
+     *
+     * 由 memoryFootprint 的当前值换算：设备显存为 device + discrete + unified，锁页主机内存为 discrete + mapped。
+     * 模型注册表按该值执行内存预算，因此与 memoryFootprint 报告的占用始终一致。
+     *
+     * @return 内存占用
+     */
+    MemoryUsage memoryUsage() const;
+
+    /**
+     * @brief 获取模型各类缓冲区的当前和峰值字节数（引擎族时为所有成员之和，峰值在重新加载引擎后重新统计）
+     *
+     * @return 按缓冲区类型统计的内存占用
+     */
+    MemoryFootprint memoryFootprint() const;
+
+    /**
+     * @brief 热替换模型引擎
+     *
+     * 新引擎在调用线程中加载，期间其他线程的推理继续使用旧引擎；加载完成后原子切换，
+     * 之后的推理使用新引擎，已在进行中的推理在旧引擎上完成后旧引擎才会被释放。
+     * 该方法是线程安全的，可在管理线程中与 predict 并发调用。
+     *
+     * @param trt_engine_file 新的 TensorRT 引擎文件路径
+     */
+    void reload(const std::string& trt_engine_file);
+
+    /**
+     * @brief 热替换模型引擎（引擎族）
+     *
+     * @param trt_engine_files 新的 TensorRT 引擎文件路径列表
+     */
+    void reload(const std::vector<std::string>& trt_engine_files);
+
+    /**
+     * @brief 切换到另一个模型当前使用的引擎（共享引擎，创建新的上下文）
+     *
+     * 用于克隆出的多个模型实例：只需对其中一个调用 reload 加载新引擎，
+     * 其余实例通过 reloadFrom 切换，避免重复加载引擎。
+     *
+     * @param model 提供引擎的模型
+     */
+    void reloadFrom(const BaseModel& model);
+
     /**
      * @brief 获取性能报告
      *
+     * 统计数据与克隆共享，报告覆盖所有克隆。
+     *
+     * - 读取不会清空统计：数值从模型创建（或上一次 resetPerformanceReport）起累计。
+     *   需要按周期统计时，每次读取后调用 resetPerformanceReport。
+     * - 吞吐量为请求数除以统计窗口内第一次调用开始到最后一次调用结束的实际时间，调用之间的空闲时间也计入；
+     *   多个克隆并行推理时不会重复计算时间。
+     *
      * @return 包含吞吐量、CPU延迟和GPU延迟的元组
      */
     std::tuple<std::string, std::string, std::string> performanceReport();
 
+    /**
+     * @brief 清空性能统计，开始新的统计窗口
+     *
+     * 同时影响共享统计的所有克隆，多个线程各自读取报告时应只由一处调用。
+     */
+    void resetPerformanceReport();
+
+    /**
+     * @brief 获取各推理阶段的延迟分解
+     *
+     * 与 performanceReport 共享统计数据（同时覆盖所有克隆），读取不会清空统计。
+     *
+     * @return 各阶段延迟统计
+     */
+    PerformanceBreakdown performanceBreakdown() const;
+
+    /**
+     * @brief 获取批量占用统计（请求的图像数量和实际执行的批量槽位数量）
+     *
+     * @return 批量占用统计
+     */
+    BatchOccupancy batchOccupancy() const;
+
+    /**
+     * @brief 清空批量占用统计（同时影响共享统计的克隆）
+     */
+    void resetBatchOccupancy();
+
 protected:
+    /**
+     * @brief 构造指定任务的 BaseModel 对象，输出张量按任务的命名约定绑定
+     *
+     * @param trt_engine_files TensorRT 引擎文件路径列表
+     * @param infer_option 推理选项
+     * @param task 任务类型
+     */
+    BaseModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option, TaskType task);
+
     class Impl;                   // 前向声明实现类
     std::unique_ptr<Impl> impl_;  // 隐藏实现细节;
 };
@@ -502,6 +874,14 @@ public:
      */
     explicit ClassifyModel(const std::string& trt_engine_file, const InferOption& infer_option);
 
+    /**
+     * @brief 构造一个由多个引擎组成的 ClassifyModel 对象（引擎族）
+     *
+     * @param trt_engine_files 同一网络不同批量构建的 TensorRT 引擎文件路径列表
+     * @param infer_option 推理选项
+     */
+    explicit ClassifyModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option);
+
     /**
      * @brief 克隆 ClassifyModel 对象
      *
@@ -540,6 +920,14 @@ public:
      */
     explicit DetectModel(const std::string& trt_engine_file, const InferOption& infer_option);
 
+    /**
+     * @brief 构造一个由多个引擎组成的 DetectModel 对象（引擎族）
+     *
+     * @param trt_engine_files 同一网络不同批量构建的 TensorRT 引擎文件路径列表
+     * @param infer_option 推理选项
+     */
+    explicit DetectModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option);
+
     /**
      * @brief 克隆 DetectModel 对象
      *
@@ -578,6 +966,14 @@ public:
      */
     explicit OBBModel(const std::string& trt_engine_file, const InferOption& infer_option);
 
+    /**
+     * @brief 构造一个由多个引擎组成的 OBBModel 对象（引擎族）
+     *
+     * @param trt_engine_files 同一网络不同批量构建的 TensorRT 引擎文件路径列表
+     * @param infer_option 推理选项
+     */
+    explicit OBBModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option);
+
     /**
      * @brief 克隆 OBBModel 对象
      *
@@ -616,6 +1012,14 @@ public:
      */
     explicit SegmentModel(const std::string& trt_engine_file, const InferOption& infer_option);
 
+    /**
+     * @brief 构造一个由多个引擎组成的 SegmentModel 对象（引擎族）
+     *
+     * @param trt_engine_files 同一网络不同批量构建的 TensorRT 引擎文件路径列表
+     * @param infer_option 推理选项
+     */
+    explicit SegmentModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option);
+
     /**
      * @brief 克隆 SegmentModel 对象
      *
@@ -654,6 +1058,14 @@ public:
      */
     explicit PoseModel(const std::string& trt_engine_file, const InferOption& infer_option);
 
+    /**
+     * @brief 构造一个由多个引擎组成的 PoseModel 对象（引擎族）
+     *
+     * @param trt_engine_files 同一网络不同批量构建的 TensorRT 引擎文件路径列表
+     * @param infer_option 推理选项
+     */
+    explicit PoseModel(const std::vector<std::string>& trt_engine_files, const InferOption& infer_option);
+
     /**
      * @brief 克隆 PoseModel 对象
      *
@@ -678,4 +1090,433 @@ public:
     std::vector<PoseRes> predict(const std::vector<Image>& images);
 };
 
+/**
+ * @brief 模型注册表类，按需从清单构建模型，并在内存预算内按最近最少使用（LRU）策略淘汰模型。
+ *
+ * 注册时只记录模型的任务类型、引擎文件和推理选项，首次 get 时才构建模型。
+ * 每次构建后统计各模型的设备显存和锁页主机内存，超出预算时淘汰最久未使用的模型。
+ * 被淘汰的模型仅从注册表中移除，调用方仍持有的实例在释放后才会真正销毁。
+ * 所有方法都是线程安全的。
+ */
+class TRTYOLOAPI ModelRegistry {
+public:
+    /**
+     * @brief 构造一个新的 ModelRegistry 对象
+     *
+     * @param device_budget 设备显存预算（字节）
+     * @param pinned_budget 锁页主机内存预算（字节），默认不限制
+     */
+    explicit ModelRegistry(size_t device_budget, size_t pinned_budget = static_cast<size_t>(-1));
+    ~ModelRegistry();
+
+    ModelRegistry(const ModelRegistry&)            = delete;
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    /**
+     * @brief 注册模型（不会立即构建）
+     *
+     * @param name 模型名称
+     * @param task 任务类型，取值为 classify、detect、segment、pose、obb
+     * @param trt_engine_files TensorRT 引擎文件路径列表（多个时构建为引擎族）
+     * @param infer_option 推理选项
+     * @throws std::invalid_argument 如果任务类型未知
+     */
+    void add(const std::string& name, const std::string& task, const std::vector<std::string>& trt_engine_files, const InferOption& infer_option);
+
+    /**
+     * @brief 从清单文件注册模型
+     *
+     * 清单文件每行描述一个模型，格式为 `<name> <task> <engine>[,<engine>...]`，以 # 开头的行为注释。
+     *
+     * @param manifest_file 清单文件路径
+     * @param infer_option 清单中所有模型使用的推理选项
+     * @throws std::runtime_error 如果清单文件无法打开或格式错误
+     */
+    void loadManifest(const std::string& manifest_file, const InferOption& infer_option);
+
+    /**
+     * @brief 获取模型，未构建时按需构建，并标记为最近使用
+     *
+     * 构建前按该模型上次的内存占用（首次构建时按引擎文件大小估计）淘汰最久未使用的模型，构建在锁外进行，
+     * 不阻塞其他模型的查询；多个线程同时获取同一个未驻留的模型时只构建一次。
+     *
+     * @param name 模型名称
+     * @return 模型的共享指针
+     * @throws std::out_of_range 如果模型未注册
+     */
+    std::shared_ptr<BaseModel> get(const std::string& name);
+
+    /**
+     * @brief 获取指定类型的模型
+     *
+     * @tparam ModelType 模型类型，需与注册时的任务类型一致
+     * @param name 模型名称
+     * @return 模型的共享指针
+     * @throws std::invalid_argument 如果模型类型与注册时的任务类型不一致
+     */
+    template <typename ModelType>
+    std::shared_ptr<ModelType> get(const std::string& name) {
+        if (modelType(name) != typeid(ModelType)) {
+            throw std::invalid_argument("ModelRegistry: model '" + name + "' is not of the requested type");
+        }
+        return std::static_pointer_cast<ModelType>(get(name));
+    }
+
+    /**
+     * @brief 获取模型的任务类型
+     *
+     * @param name 模型名称
+     * @return 任务类型字符串
+     */
+    std::string task(const std::string& name) const;
+
+    /**
+     * @brief 判断模型当前是否已构建并驻留在注册表中
+     *
+     * @param name 模型名称
+     */
+    bool resident(const std::string& name) const;
+
+    /**
+     * @brief 主动淘汰模型
+     *
+     * @param name 模型名称
+     */
+    void evict(const std::string& name);
+
+    /**
+     * @brief 获取注册表中所有驻留模型的内存占用总和
+     *
+     * @return 内存占用
+     */
+    MemoryUsage memoryUsage() const;
+
+private:
+    const std::type_info& modelType(const std::string& name) const;
+
+    class Impl;                   // 前向声明实现类
+    std::unique_ptr<Impl> impl_;  // 隐藏实现细节;
+};
+
+/**
+ * @brief 推理阶段追踪，导出为 Chrome 追踪格式（chrome://tracing、Perfetto 可直接打开）。
+ *
+ * 默认关闭，关闭时每个追踪点只有一次原子读取的开销。开启后记录每次 predict 的各阶段
+ * （predict、staging、infer、postprocess），事件带有线程编号和模型实例编号（每个克隆单独编号），
+ * 可以直观地看到多个克隆在不同线程上的重叠和排队。每个线程使用独立的环形缓冲区，
+ * 写满后覆盖最早的事件。所有方法都是线程安全的。
+ */
+class TRTYOLOAPI Tracer {
+public:
+    /**
+     * @brief 开启追踪，丢弃之前记录的事件
+     *
+     * @param events_per_thread 每个线程保留的事件数量上限
+     * @throws std::invalid_argument 如果 events_per_thread 为 0
+     */
+    static void start(size_t events_per_thread = 65536);
+
+    /**
+     * @brief 停止追踪，已记录的事件保留到下一次 start 或 clear
+     */
+    static void stop();
+
+    /**
+     * @brief 是否正在追踪
+     */
+    static bool enabled();
+
+    /**
+     * @brief 丢弃已记录的事件
+     */
+    static void clear();
+
+    /**
+     * @brief 导出已记录的事件
+     *
+     * @return Chrome 追踪格式的 JSON 字符串
+     */
+    static std::string json();
+
+    /**
+     * @brief 将已记录的事件保存为 Chrome 追踪格式的 JSON 文件
+     *
+     * @param file 文件路径
+     * @throws std::runtime_error 如果文件无法写入
+     */
+    static void save(const std::string& file);
+};
+
+/**
+ * @brief 进程级运行指标，汇总进程内所有模型和克隆，导出为 Prometheus 文本格式。
+ *
+ * 指标始终开启，与性能报告无关，包括：predict 调用次数、请求的图像数量、实际执行的批量槽位数量、
+ * 批量填充率、正在进行的 predict 调用数量（队列深度）、缓冲区分配的命中和未命中次数、
+ * 存活的模型实例数量以及 predict 端到端延迟直方图。所有方法都是线程安全的。
+ */
+class TRTYOLOAPI Metrics {
+public:
+    /**
+     * @brief 导出当前指标
+     *
+     * @return Prometheus 文本格式（0.0.4）的字符串
+     */
+    static std::string prometheus();
+
+    /**
+     * @brief 启动本地 HTTP 端点，任意路径的 GET 请求都返回 Prometheus 文本
+     *
+     * 端点运行在一个后台线程中，同一时间只能运行一个端点。
+     *
+     * @param port 监听端口，为 0 时由系统分配
+     * @param address 监听的 IPv4 地址，默认只监听本机
+     * @return int 实际监听的端口
+     * @throws std::invalid_argument 如果端口或地址无效
+     * @throws std::runtime_error 如果端点已在运行或无法监听
+     */
+    static int serve(int port, const std::string& address = "127.0.0.1");
+
+    /**
+     * @brief 停止本地 HTTP 端点，未启动时不做任何操作
+     */
+    static void shutdown();
+};
+
+/**
+ * @brief 捕获文件中的一张输入图像
+ */
+struct TRTYOLOAPI CaptureFrame {
+    int                  width    = 0;     // < 图像宽度
+    int                  height   = 0;     // < 图像高度
+    int                  channels = 0;     // < 图像通道数
+    uint64_t             hash     = 0;     // < 像素内容的哈希值，输入位于设备内存时为 0
+    std::array<int, 4>   meta{};           // < 仿射变换元数据：有效宽度、有效高度、偏移量 X、偏移量 Y
+    float                scale    = 1.0f;  // < 仿射变换的缩放比例
+    std::vector<uint8_t> data;             // < 紧密排列的像素（height × width × channels），未记录图像内容时为空
+};
+
+/**
+ * @brief 捕获文件中的一条记录，对应一次 predict 调用
+ */
+struct TRTYOLOAPI CaptureRecord {
+    int64_t                   timestamp_ns = 0;                  // < 记录时间（系统时钟，Unix 纪元起的纳秒数）
+    uint32_t                  model_id     = 0;                  // < 模型实例编号（与追踪中的编号一致）
+    TaskType                  task         = TaskType::Unknown;  // < 任务类型
+    bool                      swap_rb      = false;              // < 预处理是否交换 R 和 B 通道
+    float                     border_value = 114.0f;             // < 预处理的填充值
+    std::array<float, 3>      alpha{};                           // < 预处理的归一化系数
+    std::array<float, 3>      beta{};                            // < 预处理的偏移量
+    std::vector<CaptureFrame> frames;                            // < 本次调用的输入图像
+};
+
+/**
+ * @brief 推理捕获，将每次 predict 的输入和原始输出写入文件，用于离线复现和基准测试。
+ *
+ * 每条记录包含预处理配置、每张图像的仿射变换和像素哈希（可选地包含像素本身），
+ * 以及后处理读取的原始输出张量（只保存实际请求的图像）。文件只追加写入，记录按 64 字节对齐，
+ * 可以直接内存映射读取；进程异常退出时最多丢失最后一条不完整的记录。默认关闭，
+ * 关闭时每次 predict 只有一次原子读取的开销。所有方法都是线程安全的。
+ */
+class TRTYOLOAPI Capture {
+public:
+    /**
+     * @brief 开始捕获，覆盖已有文件；正在捕获时先关闭之前的文件
+     *
+     * @param file 捕获文件路径
+     * @param frames 是否保存图像像素，为 false 时只保存像素哈希
+     * @throws std::runtime_error 如果文件无法写入
+     */
+    static void start(const std::string& file, bool frames = false);
+
+    /**
+     * @brief 停止捕获并关闭文件
+     */
+    static void stop();
+
+    /**
+     * @brief 是否正在捕获
+     */
+    static bool enabled();
+
+    /**
+     * @brief 获取本次捕获已写入的记录数量
+     */
+    static size_t records();
+};
+
+/**
+ * @brief 捕获文件读取器，读取记录并离线重新执行后处理。
+ *
+ * 文件通过内存映射读取，重放只依赖主机内存，不需要 GPU 和引擎文件。
+ * 末尾不完整的记录会被忽略。
+ */
+class TRTYOLOAPI CaptureReader {
+public:
+    /**
+     * @brief 打开捕获文件
+     *
+     * @param file 捕获文件路径
+     * @throws std::runtime_error 如果文件无法读取或不是捕获文件
+     */
+    explicit CaptureReader(const std::string& file);
+
+    ~CaptureReader();
+    CaptureReader(CaptureReader&& other) noexcept;
+    CaptureReader& operator=(CaptureReader&& other) noexcept;
+
+    /**
+     * @brief 获取完整记录的数量
+     */
+    size_t size() const;
+
+    /**
+     * @brief 获取记录的任务类型
+     *
+     * @param index 记录下标
+     * @throws std::out_of_range 如果下标越界
+     */
+    TaskType task(size_t index) const;
+
+    /**
+     * @brief 读取记录的元数据和输入图像
+     *
+     * @param index 记录下标
+     * @throws std::out_of_range 如果下标越界
+     */
+    CaptureRecord record(size_t index) const;
+
+    /**
+     * @brief 使用记录中的原始输出重新执行后处理
+     *
+     * @param index 记录下标
+     * @return 每张输入图像的结果
+     * @throws std::out_of_range 如果下标越界
+     * @throws std::invalid_argument 如果记录的任务类型与调用的方法不符
+     */
+    std::vector<ClassifyRes> replayClassify(size_t index) const;
+    std::vector<DetectRes>   replayDetect(size_t index) const;   // < 同 replayClassify
+    std::vector<OBBRes>      replayOBB(size_t index) const;      // < 同 replayClassify
+    std::vector<SegmentRes>  replaySegment(size_t index) const;  // < 同 replayClassify
+    std::vector<PoseRes>     replayPose(size_t index) const;     // < 同 replayClassify
+
+private:
+    class Impl;                   // 前向声明实现类
+    std::unique_ptr<Impl> impl_;  // 隐藏实现细节
+};
+
+/**
+ * @brief 共享内存帧环的配置
+ */
+struct TRTYOLOAPI FrameRingOptions {
+    int    slots        = 32;       // < 帧槽位数量，即同时在途的帧数上限
+    int    max_width    = 1920;     // < 单帧最大宽度
+    int    max_height   = 1080;     // < 单帧最大高度
+    size_t result_bytes = 1 << 20;  // < 每个槽位的结果区字节数，分割掩码需要较大的结果区
+    int    workers      = 1;        // < 推理线程数量，每个线程持有一个模型克隆
+};
+
+/**
+ * @brief 共享内存帧环服务端，在一个进程中托管模型，为多个生产者进程批量推理。
+ *
+ * 服务端创建 POSIX 共享内存段，其中包含固定数量的帧槽位。生产者进程通过 FrameRingClient 将帧写入空闲槽位，
+ * 推理线程按提交顺序取出所有已就绪的帧（不超过模型的最大批量）组成一个批量，直接读取共享内存中的像素推理，
+ * 结果序列化后写回对应槽位，再通过槽位中的进程间信号量通知生产者。推理期间到达的帧在下一批中一起处理，
+ * 负载越高批量越满。生产者进程之间相互隔离，引擎只在服务端加载一份。
+ * 生产者进程异常退出时，其占用的槽位在服务端空闲时被回收。仅支持 POSIX 系统。
+ */
+class TRTYOLOAPI FrameRingServer {
+public:
+    /**
+     * @brief 创建共享内存段并启动推理线程，同名的旧共享内存段会被替换
+     *
+     * @param name 共享内存段名称，如 "/trtyolo"
+     * @param task 任务类型，取值为 classify、detect、segment、pose、obb
+     * @param trt_engine_files TensorRT 引擎文件路径列表（多个时构建为引擎族）
+     * @param infer_option 推理选项
+     * @param options 帧环配置
+     * @throws std::invalid_argument 如果任务类型未知或配置无效
+     * @throws std::runtime_error 如果无法创建共享内存段，或系统不支持 POSIX 共享内存
+     */
+    FrameRingServer(const std::string& name, const std::string& task, const std::vector<std::string>& trt_engine_files,
+                    const InferOption& infer_option, const FrameRingOptions& options = FrameRingOptions());
+
+    /**
+     * @brief 停止推理线程并删除共享内存段
+     */
+    ~FrameRingServer();
+
+    FrameRingServer(const FrameRingServer&)            = delete;
+    FrameRingServer& operator=(const FrameRingServer&) = delete;
+
+    /**
+     * @brief 停止推理线程并删除共享内存段，之后客户端的调用会超时；重复调用不做任何操作
+     */
+    void stop();
+
+    /**
+     * @brief 获取已完成推理的帧数量
+     */
+    uint64_t frames() const;
+
+    /**
+     * @brief 获取已执行的批量数量，frames() / batches() 为平均批量大小
+     */
+    uint64_t batches() const;
+
+private:
+    class Impl;                   // 前向声明实现类
+    std::unique_ptr<Impl> impl_;  // 隐藏实现细节
+};
+
+/**
+ * @brief 共享内存帧环客户端，在生产者进程中将帧提交给 FrameRingServer 并等待结果。
+ *
+ * 每次调用占用一个槽位：将像素拷贝到共享内存，通知服务端后阻塞等待结果。
+ * 客户端不加载引擎，也不需要 GPU；多个线程可以同时调用，各自占用不同的槽位。
+ */
+class TRTYOLOAPI FrameRingClient {
+public:
+    /**
+     * @brief 连接服务端创建的共享内存段
+     *
+     * @param name 共享内存段名称
+     * @param timeout_ms 等待空闲槽位和推理结果的超时时间（毫秒）
+     * @throws std::runtime_error 如果共享内存段不存在或不是帧环
+     */
+    explicit FrameRingClient(const std::string& name, int timeout_ms = 10000);
+
+    ~FrameRingClient();
+    FrameRingClient(FrameRingClient&& other) noexcept;
+    FrameRingClient& operator=(FrameRingClient&& other) noexcept;
+
+    /**
+     * @brief 获取服务端模型的任务类型
+     */
+    TaskType task() const;
+
+    /**
+     * @brief 获取单帧的最大宽度和高度
+     */
+    int maxWidth() const;
+    int maxHeight() const;  // < 同 maxWidth
+
+    /**
+     * @brief 提交一帧并等待推理结果
+     *
+     * @param image 输入图像（主机内存），尺寸不能超过服务端配置的最大宽高
+     * @return 推理结果
+     * @throws std::invalid_argument 如果图像尺寸超出槽位容量，或调用的方法与服务端的任务类型不符
+     * @throws std::runtime_error 如果等待超时，或服务端推理失败
+     */
+    ClassifyRes predictClassify(const Image& image);
+    DetectRes   predictDetect(const Image& image);   // < 同 predictClassify
+    OBBRes      predictOBB(const Image& image);      // < 同 predictClassify
+    SegmentRes  predictSegment(const Image& image);  // < 同 predictClassify
+    PoseRes     predictPose(const Image& image);     // < 同 predictClassify
+
+private:
+    class Impl;                   // 前向声明实现类
+    std::unique_ptr<Impl> impl_;  // 隐藏实现细节
+};
+
 }  // namespace trtyolo
\ No newline at end of file
@@ -9,7 +9,9 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <limits>
 
 #include "common.hpp"
 
@@ -41,44 +43,122 @@ bool SupportsIntegratedZeroCopy(const int gpu_id) {
     }
 }
 
-float findPercentile(float percentile, std::vector<float> const& timings) {
-    int32_t const all     = static_cast<int32_t>(timings.size());
-    int32_t const exclude = static_cast<int32_t>((1 - percentile / 100) * all);
-    if (timings.empty()) {
-        return std::numeric_limits<float>::infinity();
-    }
-    if (percentile < 0.F || percentile > 100.F) {
-        throw std::runtime_error("percentile is not in [0, 100]!");
-    }
-    return timings[std::max(all - 1 - exclude, 0)];
+size_t LatencyHistogram::bucketIndex(uint64_t ns) noexcept {
+    ns = std::min<uint64_t>(ns, (uint64_t(1) << kMaxValueBits) - 1);
+    if (ns < 2 * kSubBucketCount) return static_cast<size_t>(ns);  // 线性区间，每纳秒一个桶
+
+    int msb = 0;  // 最高有效位
+    for (uint64_t v = ns; v >>= 1;) ++msb;
+
+    int    shift = msb - kSubBucketBits;
+    size_t sub   = static_cast<size_t>(ns >> shift) - kSubBucketCount;
+    return 2 * kSubBucketCount + (msb - kSubBucketBits - 1) * kSubBucketCount + sub;
 }
 
-float findMedian(std::vector<float> const& timings) {
-    if (timings.empty()) {
-        return std::numeric_limits<float>::infinity();
-    }
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) noexcept {
+    if (index < 2 * kSubBucketCount) return index;
+
+    size_t octave = (index - 2 * kSubBucketCount) / kSubBucketCount;
+    size_t sub    = (index - 2 * kSubBucketCount) % kSubBucketCount;
+    return static_cast<uint64_t>(kSubBucketCount + sub) << (octave + 1);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) noexcept {
+    if (index < 2 * kSubBucketCount) return index + 1;
+
+    size_t octave = (index - 2 * kSubBucketCount) / kSubBucketCount;
+    return bucketLowerBound(index) + (uint64_t(1) << (octave + 1));
+}
 
-    int32_t const m = timings.size() / 2;
-    if (timings.size() % 2) {
-        return timings[m];
+void LatencyHistogram::record(float ms) noexcept {
+    uint64_t ns = ms > 0.F ? static_cast<uint64_t>(static_cast<double>(ms) * 1e6) : 0;
+
+    mBuckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSumNs.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t prev = mMinNs.load(std::memory_order_relaxed);
+    while (ns < prev && !mMinNs.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+    prev = mMaxNs.load(std::memory_order_relaxed);
+    while (ns > prev && !mMaxNs.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t n = other.mBuckets[i].load(std::memory_order_relaxed);
+        if (n) mBuckets[i].fetch_add(n, std::memory_order_relaxed);
     }
+    mCount.fetch_add(other.mCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    mSumNs.fetch_add(other.mSumNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    uint64_t value = other.mMinNs.load(std::memory_order_relaxed);
+    uint64_t prev  = mMinNs.load(std::memory_order_relaxed);
+    while (value < prev && !mMinNs.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+    value = other.mMaxNs.load(std::memory_order_relaxed);
+    prev  = mMaxNs.load(std::memory_order_relaxed);
+    while (value > prev && !mMaxNs.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() noexcept {
+    for (auto& bucket : mBuckets) bucket.store(0, std::memory_order_relaxed);
+    mCount.store(0, std::memory_order_relaxed);
+    mSumNs.store(0, std::memory_order_relaxed);
+    mMinNs.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    mMaxNs.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const noexcept {
+    return mCount.load(std::memory_order_relaxed);
+}
+
+float LatencyHistogram::totalMilliseconds() const noexcept {
+    return static_cast<float>(mSumNs.load(std::memory_order_relaxed) / 1e6);
+}
 
-    return (timings[m - 1] + timings[m]) / 2;
+float LatencyHistogram::min() const noexcept {
+    return count() ? static_cast<float>(mMinNs.load(std::memory_order_relaxed) / 1e6) : 0.F;
 }
 
-PerformanceResult getPerformanceResult(std::vector<float> const& timings, std::vector<float> const& percentiles) {
-    auto metricComparator  = [](float const& a, float const& b) { return a < b; };
-    auto metricAccumulator = [](float acc, float const& a) { return acc + a; };
+float LatencyHistogram::max() const noexcept {
+    return static_cast<float>(mMaxNs.load(std::memory_order_relaxed) / 1e6);
+}
+
+float LatencyHistogram::mean() const noexcept {
+    uint64_t n = count();
+    return n ? totalMilliseconds() / n : 0.F;
+}
+
+float LatencyHistogram::percentile(float percentile) const {
+    if (percentile < 0.F || percentile > 100.F) {
+        throw std::runtime_error("percentile is not in [0, 100]!");
+    }
+
+    uint64_t n = count();
+    if (n == 0) return 0.F;
+
+    // 累加桶计数直到达到目标排名，取桶的中点并限制在 [min, max] 内
+    uint64_t rank       = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100 * n)));
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        cumulative += mBuckets[i].load(std::memory_order_relaxed);
+        if (cumulative >= rank) {
+            uint64_t lower = bucketLowerBound(i);
+            uint64_t mid   = lower + (bucketUpperBound(i) - lower) / 2;
+            mid            = std::clamp(mid, mMinNs.load(std::memory_order_relaxed), mMaxNs.load(std::memory_order_relaxed));
+            return static_cast<float>(mid / 1e6);
+        }
+    }
+    return max();
+}
 
-    std::vector<float> newTimings = timings;
-    std::sort(newTimings.begin(), newTimings.end(), metricComparator);
+PerformanceResult getPerformanceResult(LatencyHistogram const& histogram, std::vector<float> const& percentiles) {
     PerformanceResult result;
-    result.min    = newTimings.front();
-    result.max    = newTimings.back();
-    result.mean   = std::accumulate(newTimings.begin(), newTimings.end(), 0.0F, metricAccumulator) / newTimings.size();
-    result.median = findMedian(newTimings);
+    result.min    = histogram.min();
+    result.max    = histogram.max();
+    result.mean   = histogram.mean();
+    result.median = histogram.percentile(50);
     for (auto percentile : percentiles) {
-        result.percentiles.emplace_back(findPercentile(percentile, newTimings));
+        result.percentiles.emplace_back(histogram.percentile(percentile));
     }
     return result;
 }
@@ -89,29 +169,55 @@ void CpuTimer::start() {
 
 void CpuTimer::stop() {
     mStop = std::chrono::high_resolution_clock::now();
-    mMs.push_back(std::chrono::duration<float, std::milli>{mStop - mStart}.count());
+    mHistogram->record(std::chrono::duration<float, std::milli>{mStop - mStart}.count());
+}
+
+cudaEvent_t CudaEventSource::create() const {
+    cudaEvent_t event;
+    CHECK(cudaEventCreate(&event));
+    return event;
 }
 
-GpuTimer::GpuTimer(cudaStream_t stream) : mStream(stream) {
-    CHECK(cudaEventCreate(&mStart));
-    CHECK(cudaEventCreate(&mStop));
+void CudaEventSource::destroy(cudaEvent_t event) const {
+    CHECK(cudaEventDestroy(event));
 }
 
-GpuTimer::~GpuTimer() {
-    CHECK(cudaEventDestroy(mStart));
-    CHECK(cudaEventDestroy(mStop));
+void CudaEventSource::record(cudaEvent_t event) const {
+    CHECK(cudaEventRecord(event, stream));
+}
+
+bool CudaEventSource::ready(cudaEvent_t event) const {
+    cudaError_t status = cudaEventQuery(event);
+    if (status == cudaErrorNotReady) return false;
+    CHECK(status);
+    return true;
+}
+
+float CudaEventSource::elapsed(cudaEvent_t start, cudaEvent_t stop) const {
+    float ms{0.0F};
+    CHECK(cudaEventElapsedTime(&ms, start, stop));
+    return ms;
+}
+
+GpuTimer::GpuTimer(cudaStream_t stream, std::shared_ptr<LatencyHistogram> histogram, uint32_t sample_every, size_t ring_size)
+    : TimerBase(std::move(histogram)), mRing(CudaEventSource{stream}, ring_size, sample_every) {}
+
+void GpuTimer::setStream(cudaStream_t stream) {
+    mRing.source().stream = stream;
 }
 
 void GpuTimer::start() {
-    CHECK(cudaEventRecord(mStart, mStream));
+    poll();
+    mRing.begin();
 }
 
 void GpuTimer::stop() {
-    CHECK(cudaEventRecord(mStop, mStream));
-    CHECK(cudaEventSynchronize(mStop));
-    float ms{0.0F};
-    CHECK(cudaEventElapsedTime(&ms, mStart, mStop));
-    mMs.push_back(ms);
+    mRing.end();
+    poll();
+}
+
+void GpuTimer::poll() {
+    mRing.collect([this](float ms) { mHistogram->record(ms); });
 }
 
 }  // namespace trtyolo
\ No newline at end of file
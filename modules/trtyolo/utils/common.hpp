@@ -10,17 +10,28 @@
 
 #pragma once
 
+#ifndef TRTYOLO_HOST_ONLY
 #include <cuda_runtime.h>
+#endif
 
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <optional>
 #include <vector>
 
+#include "utils/event_ring.hpp"
+#include "utils/vector_types.hpp"
+
 namespace trtyolo {
 
+#ifndef TRTYOLO_HOST_ONLY
+
 /**
  * @brief 检查 CUDA 错误并处理，通过打印错误消息。
  *
@@ -49,6 +60,8 @@ inline void checkCudaError(cudaError_t code, const char* file, int line) {
  */
 #define CHECK(code) checkCudaError((code), __FILE__, __LINE__)
 
+#endif  // TRTYOLO_HOST_ONLY
+
 /**
  * @brief 生成错误消息的宏。
  *
@@ -78,6 +91,7 @@ struct InferConfig {
     bool                cuda_mem                  = false;  // < 推理数据是否已经在 CUDA 显存中
     bool                enable_managed_memory     = false;  // < 是否启用统一内存
     bool                enable_performance_report = false;  // < 是否启用性能报告
+    int                 profile_sample_every      = 1;      // < GPU 计时的采样间隔，每 N 次请求计时一次
     std::optional<int2> input_shape;                        // < 输入数据的高、宽，未设置时表示宽度可变（用于输入数据宽高确定的任务场景：监控视频分析，AI外挂等）
     ProcessConfig       config;                             // < 图像预处理配置
 };
@@ -106,22 +120,45 @@ void ReadBinaryFromFile(const std::string& file, std::string* contents);
 bool SupportsIntegratedZeroCopy(const int gpu_id);
 
 /**
- * @brief 在一个升序的时间序列中找到指定的百分位数
- * @note 百分位数必须在 [0, 100] 范围内。否则，将抛出异常。
+ * @brief 定义一个延迟直方图类
  *
- * @param percentile 百分位数
- * @param timings 时间序列
- * @return float 计算得到的百分位数值
+ * 采用 HDR 直方图的对数-线性分桶：以纳秒记录，[0, 64) 纳秒逐纳秒分桶，之后每个二进制数量级再细分为 32 个桶，
+ * 相对误差不超过 1/32，覆盖至约 18 分钟。内存占用固定，与记录次数无关；
+ * 所有计数均为原子变量，多个线程（如克隆出的模型）可以无锁地同时记录到同一个直方图，
+ * 百分位数通过累加桶计数得到，无需保存和排序样本。
  */
-float findPercentile(float percentile, std::vector<float> const& timings);
+class LatencyHistogram {
+public:
+    static constexpr int    kSubBucketBits  = 5;                                // < 每个数量级细分为 2^5 个桶
+    static constexpr int    kMaxValueBits   = 40;                               // < 可记录的最大值为 2^40 纳秒
+    static constexpr size_t kSubBucketCount = size_t(1) << kSubBucketBits;      // < 每个数量级的桶数
+    static constexpr size_t kBucketCount    = 2 * kSubBucketCount + (kMaxValueBits - kSubBucketBits - 1) * kSubBucketCount;  // < 桶总数
 
-/**
- * @brief 在一个已排序的时间序列中找到中位数
- *
- * @param timings 时间序列
- * @return float 中位数值
- */
-float findMedian(std::vector<float> const& timings);
+    LatencyHistogram() { reset(); }
+    LatencyHistogram(const LatencyHistogram&)            = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void     record(float ms) noexcept;                       // < 记录一次计时结果（毫秒）
+    void     merge(const LatencyHistogram& other) noexcept;   // < 将另一个直方图的计数无锁地累加到本直方图
+    void     reset() noexcept;                                // < 清空直方图
+    uint64_t count() const noexcept;                          // < 获取记录次数
+    float    totalMilliseconds() const noexcept;              // < 获取总计时（毫秒）
+    float    min() const noexcept;                            // < 获取最小值（毫秒）
+    float    max() const noexcept;                            // < 获取最大值（毫秒）
+    float    mean() const noexcept;                           // < 获取平均值（毫秒）
+    float    percentile(float percentile) const;              // < 获取百分位数（毫秒），百分位数必须在 [0, 100] 范围内
+
+    static size_t   bucketIndex(uint64_t ns) noexcept;        // < 计算纳秒值所在的桶
+    static uint64_t bucketLowerBound(size_t index) noexcept;  // < 获取桶的下界（纳秒）
+    static uint64_t bucketUpperBound(size_t index) noexcept;  // < 获取桶的上界（纳秒，不含）
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> mBuckets;  // < 各桶计数
+    std::atomic<uint64_t>                           mCount;    // < 记录次数
+    std::atomic<uint64_t>                           mSumNs;    // < 总计时（纳秒）
+    std::atomic<uint64_t>                           mMinNs;    // < 最小值（纳秒）
+    std::atomic<uint64_t>                           mMaxNs;    // < 最大值（纳秒）
+};
 
 /**
  * @struct PerformanceResult
@@ -138,34 +175,42 @@ struct PerformanceResult {
 /**
  * @brief 获取性能结果对象
  *
- * @param timings 时间序列
+ * @param histogram 延迟直方图
  * @param percentiles 百分位数列表
  * @return PerformanceResult 性能结果对象
  */
-PerformanceResult getPerformanceResult(std::vector<float> const& timings, std::vector<float> const& percentiles);
+PerformanceResult getPerformanceResult(LatencyHistogram const& histogram, std::vector<float> const& percentiles);
 
 /**
  * @brief 定义一个计时器基类
  *
- * 该类提供了基本的计时功能，包括开始计时、停止计时、获取计时结果（毫秒）、重置计时结果以及获取总计时（毫秒）。
+ * 该类提供了基本的计时功能，包括开始计时、停止计时、获取计时结果、重置计时结果以及获取总计时（毫秒）。
+ * 计时结果记录在延迟直方图中，多个计时器可以共享同一个直方图。
  * 它是一个抽象类，用于派生出具体的 CPU 计时器和 GPU 计时器类。
  */
 class TimerBase {
 public:
-    virtual void       start() {}  // < 虚函数，用于开始计时
-    virtual void       stop() {}   // < 虚函数，用于停止计时
-    std::vector<float> milliseconds() const noexcept {
-        return mMs;
-    }  // < 获取计时结果（毫秒）
+    explicit TimerBase(std::shared_ptr<LatencyHistogram> histogram = std::make_shared<LatencyHistogram>())
+        : mHistogram(std::move(histogram)) {}
+    virtual ~TimerBase() = default;
+
+    virtual void start() {}  // < 虚函数，用于开始计时
+    virtual void stop() {}   // < 虚函数，用于停止计时
+    const LatencyHistogram& histogram() const noexcept {
+        return *mHistogram;
+    }  // < 获取计时结果
     void reset() noexcept {
-        mMs.clear();
+        mHistogram->reset();
     }  // < 重置计时结果
     float totalMilliseconds() const noexcept {
-        return std::accumulate(mMs.begin(), mMs.end(), 0.0F);
+        return mHistogram->totalMilliseconds();
     }  // < 获取总计时（毫秒）
+    void add(float ms) noexcept {
+        mHistogram->record(ms);
+    }  // < 添加一次外部测得的计时结果（毫秒）
 
 protected:
-    std::vector<float> mMs;  // < 计时结果列表
+    std::shared_ptr<LatencyHistogram> mHistogram;  // < 计时结果直方图
 };
 
 /**
@@ -176,6 +221,8 @@ protected:
  */
 class CpuTimer : public TimerBase {
 public:
+    using TimerBase::TimerBase;
+
     void start() override;                                                      // < 重写 start 方法，开始 CPU 计时
     void stop() override;                                                       // < 重写 stop 方法，停止 CPU 计时
 
@@ -183,23 +230,53 @@ private:
     std::chrono::time_point<std::chrono::high_resolution_clock> mStart, mStop;  // < 计时起止时间点
 };  // class CpuTimer
 
+#ifndef TRTYOLO_HOST_ONLY
+
+/**
+ * @brief 基于 CUDA 事件的事件源，供 SampledEventRing 使用
+ */
+struct CudaEventSource {
+    using Event = cudaEvent_t;
+
+    cudaStream_t stream = nullptr;  // < 记录事件的 CUDA 流
+
+    Event create() const;                          // < 创建事件
+    void  destroy(Event event) const;              // < 销毁事件
+    void  record(Event event) const;               // < 在 stream 上记录事件
+    bool  ready(Event event) const;                // < 查询事件是否完成（cudaEventQuery，不阻塞）
+    float elapsed(Event start, Event stop) const;  // < 获取两个事件之间的耗时（毫秒）
+};
+
 /**
  * @brief 定义一个 GPU 计时器类
  *
  * 该类继承自 TimerBase 类，实现了具体的 GPU 计时功能。
- * 它使用 CUDA 事件来记录 GPU 上的时间。
+ * 它使用 CUDA 事件来记录 GPU 上的时间：按采样间隔记录事件对，事件对完成后在之后的 start/stop 中异步读取，
+ * 不会调用 cudaEventSynchronize 阻塞主机，因此可以在生产环境中保持开启。
  */
 class GpuTimer : public TimerBase {
 public:
-    explicit GpuTimer(cudaStream_t stream);  // < 构造函数，传入 CUDA 流
-    ~GpuTimer();                             // < 析构函数
+    /**
+     * @brief 构造函数
+     *
+     * @param stream CUDA 流
+     * @param histogram 记录计时结果的直方图，多个计时器可共享同一个直方图
+     * @param sample_every 采样间隔，每 sample_every 次请求计时一次
+     * @param ring_size 同时未完成的事件对数量上限
+     */
+    explicit GpuTimer(cudaStream_t stream, std::shared_ptr<LatencyHistogram> histogram = std::make_shared<LatencyHistogram>(),
+                      uint32_t sample_every = 1, size_t ring_size = 16);
 
-    void start() override;                   // < 重写 start 方法，开始 GPU 计时
-    void stop() override;                    // < 重写 stop 方法，停止 GPU 计时
+    void start() override;                // < 重写 start 方法，读取已完成的采样并开始 GPU 计时
+    void stop() override;                 // < 重写 stop 方法，停止 GPU 计时并读取已完成的采样
+    void setStream(cudaStream_t stream);  // < 设置记录事件的 CUDA 流
 
 private:
-    cudaEvent_t  mStart, mStop;              // < 计时事件
-    cudaStream_t mStream;                    // < CUDA 流
+    void poll();  // < 将已完成的事件对耗时记录到直方图
+
+    SampledEventRing<CudaEventSource> mRing;  // < 事件对环形缓冲区
 };
 
+#endif  // TRTYOLO_HOST_ONLY
+
 }  // namespace trtyolo
\ No newline at end of file
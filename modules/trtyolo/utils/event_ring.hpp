@@ -0,0 +1,138 @@
+/**
+ * @file event_ring.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 采样计时的事件对环形缓冲区，异步读取计时结果而不阻塞主机
+ * @date 2025-06-30
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace trtyolo {
+
+/**
+ * @brief 采样计时的事件对环形缓冲区
+ *
+ * 每 `sample_every` 次请求记录一次开始/结束事件对，事件对进入环形缓冲区后不等待其完成，
+ * 之后调用 collect 时按记录顺序读取已完成的事件对。环形缓冲区已满时跳过本次采样而不是等待，
+ * 因此计时永远不会引入主机端的同步。
+ *
+ * 事件的创建、记录、查询和耗时计算由 EventSource 提供，需要满足以下接口：
+ * - `using Event = ...;`
+ * - `Event create();`、`void destroy(Event);`
+ * - `void record(Event);`：在当前流上记录事件
+ * - `bool ready(Event);`：事件是否已完成，不得阻塞
+ * - `float elapsed(Event start, Event stop);`：两个已完成事件之间的耗时（毫秒）
+ *
+ * GPU 计时使用基于 CUDA 事件的实现；单元测试可以使用基于假时钟的实现，手动推进时钟来控制事件何时完成。
+ *
+ * @tparam EventSource 事件源类型
+ */
+template <typename EventSource>
+class SampledEventRing {
+public:
+    using Event = typename EventSource::Event;
+
+    /**
+     * @brief 构造函数
+     *
+     * @param source 事件源
+     * @param capacity 环形缓冲区容量（同时未完成的事件对数量上限）
+     * @param sample_every 采样间隔，每 sample_every 次请求计时一次，1 表示每次请求都计时
+     */
+    SampledEventRing(EventSource source, size_t capacity, uint32_t sample_every)
+        : source_(std::move(source)), slots_(std::max<size_t>(capacity, 1)), sample_every_(std::max<uint32_t>(sample_every, 1)) {
+        for (auto& slot : slots_) {
+            slot.start = source_.create();
+            slot.stop  = source_.create();
+        }
+    }
+
+    ~SampledEventRing() {
+        for (auto& slot : slots_) {
+            source_.destroy(slot.start);
+            source_.destroy(slot.stop);
+        }
+    }
+
+    SampledEventRing(const SampledEventRing&)            = delete;
+    SampledEventRing& operator=(const SampledEventRing&) = delete;
+
+    /**
+     * @brief 开始一次请求，按采样间隔决定是否记录开始事件
+     *
+     * @return true 如果本次请求被采样
+     */
+    bool begin() {
+        active_ = false;
+        if (counter_++ % sample_every_ != 0) return false;
+        if (pending_ == slots_.size()) {
+            ++dropped_;  // 环形缓冲区已满：跳过本次采样，不等待旧事件完成
+            return false;
+        }
+        source_.record(slots_[tail()].start);
+        active_ = true;
+        return true;
+    }
+
+    /**
+     * @brief 结束一次请求，被采样时记录结束事件并将事件对加入待读取队列
+     */
+    void end() {
+        if (!active_) return;
+        source_.record(slots_[tail()].stop);
+        ++pending_;
+        active_ = false;
+    }
+
+    /**
+     * @brief 按记录顺序读取已完成的事件对，遇到未完成的事件对时停止，不会阻塞
+     *
+     * @param sink 接收耗时（毫秒）的回调
+     * @return size_t 本次读取的事件对数量
+     */
+    template <typename Sink>
+    size_t collect(Sink&& sink) {
+        size_t collected = 0;
+        while (pending_ > 0) {
+            auto& slot = slots_[head_];
+            if (!source_.ready(slot.stop)) break;
+            sink(source_.elapsed(slot.start, slot.stop));
+            head_ = (head_ + 1) % slots_.size();
+            --pending_;
+            ++collected;
+        }
+        return collected;
+    }
+
+    EventSource& source() noexcept { return source_; }          // < 获取事件源
+    size_t       pending() const noexcept { return pending_; }  // < 获取尚未读取的事件对数量
+    uint64_t     dropped() const noexcept { return dropped_; }  // < 获取因环形缓冲区已满而跳过的采样次数
+
+private:
+    struct Slot {
+        Event start{};  // < 开始事件
+        Event stop{};   // < 结束事件
+    };
+
+    size_t tail() const noexcept { return (head_ + pending_) % slots_.size(); }
+
+    EventSource       source_;         // < 事件源
+    std::vector<Slot> slots_;          // < 事件对环形缓冲区
+    uint32_t          sample_every_;   // < 采样间隔
+    uint64_t          counter_{0};     // < 请求计数
+    uint64_t          dropped_{0};     // < 跳过的采样次数
+    size_t            head_{0};        // < 最早未读取的事件对
+    size_t            pending_{0};     // < 未读取的事件对数量
+    bool              active_{false};  // < 当前请求是否被采样
+};
+
+}  // namespace trtyolo
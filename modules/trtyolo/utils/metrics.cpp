@@ -0,0 +1,350 @@
+/**
+ * @file metrics.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 进程级指标注册表的实现、Prometheus 文本导出和本地 HTTP 端点
+ * @date 2025-07-04
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include "utils/metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "core/buffer.hpp"
+#include "infer/trtyolo.hpp"
+
+namespace trtyolo {
+
+namespace {
+
+#ifdef _WIN32
+using Socket                    = SOCKET;
+constexpr Socket kInvalidSocket = INVALID_SOCKET;
+constexpr int    kSendFlags     = 0;
+
+bool startupSockets() {
+    WSADATA wsa_data;
+    return WSAStartup(MAKEWORD(2, 2), &wsa_data) == 0;
+}
+
+void cleanupSockets() { WSACleanup(); }
+void closeSocket(Socket fd) { closesocket(fd); }
+int  pollSocket(pollfd* fd, int timeout_ms) { return WSAPoll(fd, 1, timeout_ms); }
+void shutdownSocket(Socket fd) { shutdown(fd, SD_BOTH); }
+
+void setSocketTimeout(Socket fd, int timeout_ms) {
+    DWORD timeout = static_cast<DWORD>(timeout_ms);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+#else
+using Socket                    = int;
+constexpr Socket kInvalidSocket = -1;
+constexpr int    kSendFlags     = MSG_NOSIGNAL;  // 采集器提前断开时不触发 SIGPIPE
+
+bool startupSockets() { return true; }
+void cleanupSockets() {}
+void closeSocket(Socket fd) { close(fd); }
+int  pollSocket(pollfd* fd, int timeout_ms) { return poll(fd, 1, timeout_ms); }
+void shutdownSocket(Socket fd) { shutdown(fd, SHUT_RDWR); }
+
+void setSocketTimeout(Socket fd, int timeout_ms) {
+    timeval timeout{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+#endif
+
+/**
+ * @brief 套接字库（Winsock）引用的作用域守卫
+ *
+ * 构造时初始化，析构时释放；启动成功后调用 keep，引用交由 MetricsServer::stop 释放。
+ */
+class SocketLibraryGuard {
+public:
+    SocketLibraryGuard() {
+        if (!startupSockets()) throw std::runtime_error("Metrics: failed to initialize Winsock");
+    }
+
+    ~SocketLibraryGuard() {
+        if (active_) cleanupSockets();
+    }
+
+    SocketLibraryGuard(const SocketLibraryGuard&)            = delete;
+    SocketLibraryGuard& operator=(const SocketLibraryGuard&) = delete;
+
+    void keep() { active_ = false; }
+
+private:
+    bool active_ = true;  // < 析构时是否释放
+};
+
+void writeCounter(std::ostringstream& oss, const char* name, const char* help, uint64_t value) {
+    oss << "# HELP " << name << ' ' << help << '\n';
+    oss << "# TYPE " << name << " counter\n";
+    oss << name << ' ' << value << '\n';
+}
+
+void writeGauge(std::ostringstream& oss, const char* name, const char* help, int64_t value) {
+    oss << "# HELP " << name << ' ' << help << '\n';
+    oss << "# TYPE " << name << " gauge\n";
+    oss << name << ' ' << value << '\n';
+}
+
+void writeBufferBytes(std::ostringstream& oss, const char* name, const char* help, size_t (MemoryLedger::*bytes)(BufferType) const noexcept) {
+    static constexpr std::pair<BufferType, const char*> kTypes[] = {
+        {BufferType::Device, "device"}, {BufferType::Discrete, "discrete"}, {BufferType::Unified, "unified"}, {BufferType::Mapped, "mapped"}};
+
+    const auto& ledger = MemoryLedger::global();
+    oss << "# HELP " << name << ' ' << help << '\n';
+    oss << "# TYPE " << name << " gauge\n";
+    for (const auto& [type, label] : kTypes) {
+        oss << name << "{type=\"" << label << "\"} " << (ledger.*bytes)(type) << '\n';
+    }
+}
+
+void writeHistogram(std::ostringstream& oss, const char* name, const char* help, const Histogram& histogram) {
+    oss << "# HELP " << name << ' ' << help << '\n';
+    oss << "# TYPE " << name << " histogram\n";
+
+    // 一次读取所有桶，保证导出的累计计数单调且与 _count 一致
+    const auto& bounds = histogram.bounds();
+    auto        counts = histogram.cumulativeCounts();
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        oss << name << "_bucket{le=\"" << bounds[i] << "\"} " << counts[i] << '\n';
+    }
+    oss << name << "_bucket{le=\"+Inf\"} " << counts.back() << '\n';
+    oss << name << "_sum " << histogram.sum() << '\n';
+    oss << name << "_count " << counts.back() << '\n';
+}
+
+/**
+ * @brief 只响应指标请求的本地 HTTP 服务器
+ *
+ * 单个后台线程依次处理连接，每个请求都返回最新的 Prometheus 文本，不解析请求路径，
+ * 只用于被本机或内网的采集器抓取。每个连接的读写都有超时，连接后不发送请求的客户端不会阻塞端点和 stop。
+ */
+class MetricsServer {
+public:
+    static MetricsServer& instance() {
+        static MetricsServer server;
+        return server;
+    }
+
+    ~MetricsServer() { stop(); }
+
+    int start(const std::string& address, int port) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (thread_.joinable()) {
+            throw std::runtime_error("Metrics: HTTP endpoint is already running on port " + std::to_string(port_));
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port   = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+            throw std::invalid_argument("Metrics: invalid IPv4 address '" + address + "'");
+        }
+
+        SocketLibraryGuard sockets;  // 之后任一步骤失败都会释放 Winsock 引用
+
+        Socket fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd == kInvalidSocket) {
+            throw std::runtime_error("Metrics: failed to create socket");
+        }
+
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+            closeSocket(fd);
+            throw std::runtime_error("Metrics: failed to listen on " + address + ":" + std::to_string(port));
+        }
+
+        // 端口为 0 时由系统分配，读取实际端口
+        socklen_t len = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+
+        listen_fd_ = fd;
+        port_      = ntohs(addr.sin_port);
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread(&MetricsServer::serve, this);
+        sockets.keep();
+        return port_;
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!thread_.joinable()) return;
+
+        running_.store(false, std::memory_order_release);
+        shutdownSocket(listen_fd_);  // 唤醒阻塞在 poll 上的服务线程；不支持时由 poll 的超时兜底
+        thread_.join();
+        closeSocket(listen_fd_);
+        listen_fd_ = kInvalidSocket;
+        port_      = 0;
+        cleanupSockets();
+    }
+
+private:
+    MetricsServer() = default;
+
+    void serve() {
+        while (running_.load(std::memory_order_acquire)) {
+            // 定期超时以便及时响应 stop
+            pollfd pfd{};
+            pfd.fd     = listen_fd_;
+            pfd.events = POLLIN;
+            if (pollSocket(&pfd, 200) <= 0) continue;
+
+            Socket client = accept(listen_fd_, nullptr, nullptr);
+            if (client == kInvalidSocket) continue;
+            respond(client);
+            closeSocket(client);
+        }
+    }
+
+    void respond(Socket client) {
+        setSocketTimeout(client, kClientTimeoutMs);  // 限制 recv 和 send 阻塞的时间
+
+        // 等待请求到达，分段等待以便及时响应 stop；超时未收到请求时直接关闭连接
+        auto   deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kClientTimeoutMs);
+        pollfd pfd{};
+        pfd.fd     = client;
+        pfd.events = POLLIN;
+        while (true) {
+            if (!running_.load(std::memory_order_acquire) || std::chrono::steady_clock::now() >= deadline) return;
+            int ready = pollSocket(&pfd, 100);
+            if (ready < 0) return;
+            if (ready > 0) break;
+        }
+
+        // 读取请求头（忽略内容），请求过大时直接返回指标
+        char buffer[2048];
+        if (recv(client, buffer, sizeof(buffer), 0) <= 0) return;
+
+        auto body = MetricsRegistry::instance().prometheus();
+
+        std::ostringstream oss;
+        oss << "HTTP/1.1 200 OK\r\n"
+            << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            << "Content-Length: " << body.size() << "\r\n"
+            << "Connection: close\r\n\r\n"
+            << body;
+
+        auto   response = oss.str();
+        size_t sent     = 0;
+        while (sent < response.size()) {
+            auto n = send(client, response.data() + sent, static_cast<int>(response.size() - sent), kSendFlags);
+            if (n <= 0) break;
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    static constexpr int kClientTimeoutMs = 1000;  // < 单个连接等待请求和发送响应的超时时间
+
+    std::mutex        mutex_;                      // < 保护启动和停止
+    std::thread       thread_;                     // < 服务线程
+    std::atomic<bool> running_{false};             // < 服务线程是否继续运行
+    Socket            listen_fd_{kInvalidSocket};  // < 监听套接字
+    int               port_{0};                    // < 实际监听的端口
+};
+
+}  // namespace
+
+Histogram::Histogram(std::initializer_list<double> bounds)
+    : bounds_(bounds), buckets_(new std::atomic<uint64_t>[bounds.size() + 1]) {
+    std::sort(bounds_.begin(), bounds_.end());
+    for (size_t i = 0; i <= bounds_.size(); ++i) buckets_[i].store(0, std::memory_order_relaxed);
+}
+
+void Histogram::observe(double value) noexcept {
+    auto bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    // C++17 没有浮点数的 fetch_add，使用 CAS 循环累加
+    double sum = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t Histogram::count() const noexcept {
+    uint64_t total = 0;
+    for (size_t i = 0; i <= bounds_.size(); ++i) total += buckets_[i].load(std::memory_order_relaxed);
+    return total;
+}
+
+double Histogram::sum() const noexcept {
+    return sum_.load(std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::cumulativeCounts() const {
+    std::vector<uint64_t> counts(bounds_.size() + 1);
+    uint64_t              total = 0;
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+        total     += buckets_[i].load(std::memory_order_relaxed);
+        counts[i]  = total;
+    }
+    return counts;
+}
+
+MetricsRegistry::MetricsRegistry()
+    : latency({0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5}),
+      batch_fill({0.125, 0.25, 0.375, 0.5, 0.625, 0.75, 0.875, 1.0}) {}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+std::string MetricsRegistry::prometheus() const {
+    std::ostringstream oss;
+    writeCounter(oss, "trtyolo_requests_total", "Number of predict calls.", requests.value());
+    writeCounter(oss, "trtyolo_images_total", "Number of images requested.", images.value());
+    writeCounter(oss, "trtyolo_batch_slots_total", "Number of batch slots executed (static engines always run max batch).", batch_slots.value());
+    writeCounter(oss, "trtyolo_allocator_hits_total", "Buffer allocations served by existing capacity.", allocator_hits.value());
+    writeCounter(oss, "trtyolo_allocator_misses_total", "Buffer allocations that had to allocate new memory.", allocator_misses.value());
+    writeGauge(oss, "trtyolo_queue_depth", "Predict calls in flight, including those waiting for a backend.", queue_depth.value());
+    writeGauge(oss, "trtyolo_models", "Live model instances, including clones.", models.value());
+    writeBufferBytes(oss, "trtyolo_buffer_bytes", "Bytes currently allocated by buffers of each type.", &MemoryLedger::current);
+    writeBufferBytes(oss, "trtyolo_buffer_peak_bytes", "Peak bytes allocated by buffers of each type.", &MemoryLedger::peak);
+    writeHistogram(oss, "trtyolo_predict_latency_seconds", "End-to-end predict latency in seconds.", latency);
+    writeHistogram(oss, "trtyolo_batch_fill_ratio", "Fraction of executed batch slots holding a requested image.", batch_fill);
+    return oss.str();
+}
+
+std::string Metrics::prometheus() {
+    return MetricsRegistry::instance().prometheus();
+}
+
+int Metrics::serve(int port, const std::string& address) {
+    if (port < 0 || port > 65535) {
+        throw std::invalid_argument("Metrics: port must be in [0, 65535]");
+    }
+    return MetricsServer::instance().start(address, port);
+}
+
+void Metrics::shutdown() {
+    MetricsServer::instance().stop();
+}
+
+}  // namespace trtyolo
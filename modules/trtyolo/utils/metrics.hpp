@@ -0,0 +1,119 @@
+/**
+ * @file metrics.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 进程级指标注册表：计数器、仪表和直方图，汇总所有模型和克隆，导出为 Prometheus 文本格式
+ * @date 2025-07-04
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace trtyolo {
+
+/**
+ * @brief 单调递增的计数器
+ */
+class Counter {
+public:
+    void     inc(uint64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};  // < 计数值
+};
+
+/**
+ * @brief 可增可减的仪表
+ */
+class Gauge {
+public:
+    void    add(int64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    void    sub(int64_t n = 1) noexcept { value_.fetch_sub(n, std::memory_order_relaxed); }
+    int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};  // < 当前值
+};
+
+/**
+ * @brief RAII 仪表增量，构造时加一，析构时减一，异常退出时同样会恢复
+ */
+class GaugeScope {
+public:
+    explicit GaugeScope(Gauge& gauge) noexcept : gauge_(gauge) { gauge_.add(); }
+    ~GaugeScope() { gauge_.sub(); }
+
+    GaugeScope(const GaugeScope&)            = delete;
+    GaugeScope& operator=(const GaugeScope&) = delete;
+
+private:
+    Gauge& gauge_;  // < 仪表
+};
+
+/**
+ * @brief 固定桶边界的直方图，与 Prometheus 直方图一一对应
+ *
+ * 每个桶独立计数，导出时累加为 Prometheus 要求的累计计数；记录只做一次二分查找和两次原子加法。
+ */
+class Histogram {
+public:
+    explicit Histogram(std::initializer_list<double> bounds);
+
+    void                  observe(double value) noexcept;  // < 记录一次观测值
+    uint64_t              count() const noexcept;          // < 获取观测次数
+    double                sum() const noexcept;            // < 获取观测值之和
+    std::vector<uint64_t> cumulativeCounts() const;        // < 获取各边界的累计计数，最后一个为 +Inf 桶（即观测次数）
+
+    const std::vector<double>& bounds() const noexcept { return bounds_; }
+
+private:
+    std::vector<double>                      bounds_;    // < 桶上界（升序，不含 +Inf）
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;   // < 各桶计数，最后一个为 +Inf 桶
+    std::atomic<double>                      sum_{0.0};  // < 观测值之和
+};
+
+/**
+ * @brief 进程级指标注册表
+ *
+ * 所有模型和克隆共享同一组指标，始终开启，与性能报告无关；记录只使用无锁的原子操作。
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    std::string prometheus() const;  // < 导出为 Prometheus 文本格式（0.0.4）
+
+    Counter   requests;          // < predict 调用次数
+    Counter   images;            // < 请求推理的图像数量
+    Counter   batch_slots;       // < 实际执行的批量槽位数量（静态引擎按最大批量计）
+    Counter   allocator_hits;    // < 缓冲区复用已有内存的次数
+    Counter   allocator_misses;  // < 缓冲区重新分配内存的次数
+    Gauge     queue_depth;       // < 正在进行（包括等待后端）的 predict 调用数量
+    Gauge     models;            // < 存活的模型实例数量（包括克隆）
+    Histogram latency;           // < predict 端到端延迟（秒）
+    Histogram batch_fill;        // < 每次推理的批量填充率（图像数量 / 槽位数量）
+
+private:
+    MetricsRegistry();
+};
+
+/**
+ * @brief 记录一次缓冲区分配请求
+ *
+ * @param reused 已有容量是否足够（命中），为 false 表示重新分配了内存
+ */
+inline void recordAllocation(bool reused) noexcept {
+    auto& metrics = MetricsRegistry::instance();
+    (reused ? metrics.allocator_hits : metrics.allocator_misses).inc();
+}
+
+}  // namespace trtyolo
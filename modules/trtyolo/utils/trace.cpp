@@ -0,0 +1,219 @@
+/**
+ * @file trace.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 推理阶段追踪的实现和 Chrome 追踪格式导出
+ * @date 2025-07-02
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include "utils/trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "infer/trtyolo.hpp"
+
+namespace trtyolo {
+
+namespace {
+
+/**
+ * @brief 线程本地的追踪状态
+ */
+struct ThreadTraceState {
+    std::shared_ptr<TraceRing> ring;              // < 本线程当前的环形缓冲区
+    uint64_t                   generation{0};     // < 缓冲区所属的追踪轮次
+    uint32_t                   thread_id{0};      // < 本线程的编号，0 表示尚未分配
+    uint32_t                   current_model{0};  // < 当前正在追踪的模型实例编号
+};
+
+thread_local ThreadTraceState tls_trace;
+
+int processId() {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return static_cast<int>(getpid());
+#endif
+}
+
+}  // namespace
+
+TraceRing::TraceRing(size_t capacity, uint32_t thread_id)
+    : slots_(new Slot[std::max<size_t>(capacity, 1)]), capacity_(std::max<size_t>(capacity, 1)), thread_id_(thread_id) {}
+
+void TraceRing::push(const TraceEvent& event) noexcept {
+    uint64_t index = head_.load(std::memory_order_relaxed);
+    auto&    slot  = slots_[index % capacity_];
+
+    // 序号置 0 表示槽位正在写入，读取方据此丢弃该槽位
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.seq.store(index + 1, std::memory_order_release);
+    head_.store(index + 1, std::memory_order_release);
+}
+
+void TraceRing::snapshot(std::vector<TraceEvent>* out) const {
+    uint64_t head  = head_.load(std::memory_order_acquire);
+    uint64_t first = std::max(floor_.load(std::memory_order_acquire), head > capacity_ ? head - capacity_ : 0);
+
+    for (uint64_t index = first; index < head; ++index) {
+        const auto& slot = slots_[index % capacity_];
+        if (slot.seq.load(std::memory_order_acquire) != index + 1) continue;
+        TraceEvent event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // 复制期间被写入线程覆盖时丢弃该事件
+        if (slot.seq.load(std::memory_order_relaxed) != index + 1) continue;
+        out->push_back(event);
+    }
+}
+
+void TraceRing::clear() noexcept {
+    floor_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+TraceRecorder& TraceRecorder::instance() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+int64_t TraceRecorder::now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::start(size_t events_per_thread) {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.clear();
+    events_per_thread_ = events_per_thread;
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop() {
+    enabled_.store(false, std::memory_order_release);
+}
+
+void TraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto& ring : rings_) ring->clear();
+}
+
+TraceRing* TraceRecorder::localRing() {
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+    if (tls_trace.ring && tls_trace.generation == generation) return tls_trace.ring.get();
+
+    // 每个线程在每轮追踪中只会进入这里一次
+    if (tls_trace.thread_id == 0) tls_trace.thread_id = next_thread_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    tls_trace.ring       = std::make_shared<TraceRing>(events_per_thread_, tls_trace.thread_id);
+    tls_trace.generation = generation_.load(std::memory_order_relaxed);
+    rings_.push_back(tls_trace.ring);
+    return tls_trace.ring.get();
+}
+
+void TraceRecorder::record(const char* name, int64_t begin_ns, int64_t end_ns) noexcept {
+    if (!enabled()) return;
+    try {
+        localRing()->push(TraceEvent{name, begin_ns, end_ns, tls_trace.current_model});
+    } catch (...) {
+        // 追踪缓冲区分配失败时丢弃事件，不影响推理
+    }
+}
+
+std::string TraceRecorder::json() const {
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings = rings_;
+    }
+
+    int                pid = processId();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "{\"traceEvents\":[";
+
+    bool                    first = true;
+    std::vector<TraceEvent> events;
+    for (const auto& ring : rings) {
+        events.clear();
+        ring->snapshot(&events);
+
+        if (!first) oss << ',';
+        first = false;
+        oss << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << ring->threadId()
+            << ",\"args\":{\"name\":\"thread " << ring->threadId() << "\"}}";
+
+        // 完整事件（"X"）同时包含开始时间和持续时间，时间单位为微秒
+        for (const auto& event : events) {
+            oss << ",{\"name\":\"" << event.name << "\",\"cat\":\"trtyolo\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << ring->threadId()
+                << ",\"ts\":" << event.begin_ns / 1e3 << ",\"dur\":" << (event.end_ns - event.begin_ns) / 1e3
+                << ",\"args\":{\"model\":" << event.model_id << "}}";
+        }
+    }
+
+    oss << "],\"displayTimeUnit\":\"ms\"}";
+    return oss.str();
+}
+
+uint32_t TraceRecorder::nextModelId() noexcept {
+    return next_model_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+uint32_t TraceRecorder::currentModel() noexcept {
+    return tls_trace.current_model;
+}
+
+uint32_t TraceRecorder::exchangeCurrentModel(uint32_t model_id) noexcept {
+    return std::exchange(tls_trace.current_model, model_id);
+}
+
+void Tracer::start(size_t events_per_thread) {
+    if (events_per_thread == 0) {
+        throw std::invalid_argument("Tracer: events_per_thread must be positive");
+    }
+    TraceRecorder::instance().start(events_per_thread);
+}
+
+void Tracer::stop() {
+    TraceRecorder::instance().stop();
+}
+
+bool Tracer::enabled() {
+    return TraceRecorder::instance().enabled();
+}
+
+void Tracer::clear() {
+    TraceRecorder::instance().clear();
+}
+
+std::string Tracer::json() {
+    return TraceRecorder::instance().json();
+}
+
+void Tracer::save(const std::string& file) {
+    std::ofstream fout(file, std::ios::out | std::ios::trunc);
+    if (!fout.is_open()) {
+        throw std::runtime_error("Failed to open file: " + file + " to write.");
+    }
+    fout << json();
+    if (!fout) {
+        throw std::runtime_error("Failed to write file: " + file + ".");
+    }
+}
+
+}  // namespace trtyolo
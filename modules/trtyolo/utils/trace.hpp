@@ -0,0 +1,128 @@
+/**
+ * @file trace.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief 推理阶段追踪：每个线程一个无锁环形缓冲区，导出为 Chrome 追踪格式
+ * @date 2025-07-02
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trtyolo {
+
+/**
+ * @brief 追踪事件，记录一个阶段的开始和结束时间
+ */
+struct TraceEvent {
+    const char* name     = nullptr;  // < 阶段名称（必须是静态字符串）
+    int64_t     begin_ns = 0;        // < 开始时间（steady_clock，纳秒）
+    int64_t     end_ns   = 0;        // < 结束时间（steady_clock，纳秒）
+    uint32_t    model_id = 0;        // < 模型实例编号（克隆各自编号，0 表示不属于任何模型）
+};
+
+/**
+ * @brief 单个线程的追踪事件环形缓冲区
+ *
+ * 只有所属线程写入，写入时不加锁；导出线程可以随时读取，
+ * 每个槽位带有序号，读取到正在被覆盖的槽位时丢弃该事件。
+ */
+class TraceRing {
+public:
+    TraceRing(size_t capacity, uint32_t thread_id);
+
+    void     push(const TraceEvent& event) noexcept;        // < 写入事件（仅所属线程调用），缓冲区满时覆盖最早的事件
+    void     snapshot(std::vector<TraceEvent>* out) const;  // < 读取当前保留的事件（任意线程调用）
+    void     clear() noexcept;                              // < 丢弃当前保留的事件（任意线程调用）
+    uint32_t threadId() const noexcept { return thread_id_; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};  // < 事件序号 + 1，写入过程中为 0
+        TraceEvent            event;   // < 事件
+    };
+
+    std::unique_ptr<Slot[]> slots_;      // < 槽位
+    size_t                  capacity_;   // < 槽位数量
+    std::atomic<uint64_t>   head_{0};    // < 已写入的事件数量
+    std::atomic<uint64_t>   floor_{0};   // < clear 之后读取的起点
+    uint32_t                thread_id_;  // < 线程编号
+};
+
+/**
+ * @brief 进程级追踪记录器
+ *
+ * 关闭时每个追踪点只有一次原子读取的开销。开启后各线程在首次记录时创建自己的环形缓冲区，
+ * 之后的记录只写本线程的缓冲区，不同线程、不同克隆之间没有竞争。
+ */
+class TraceRecorder {
+public:
+    static TraceRecorder& instance();
+
+    static int64_t now() noexcept;  // < 获取当前时间（steady_clock，纳秒）
+
+    bool enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    void        start(size_t events_per_thread);                                      // < 开启追踪，丢弃之前的事件
+    void        stop();                                                               // < 停止追踪，保留已记录的事件
+    void        clear();                                                              // < 丢弃已记录的事件
+    void        record(const char* name, int64_t begin_ns, int64_t end_ns) noexcept;  // < 以当前线程的模型实例编号记录事件
+    std::string json() const;                                                         // < 导出为 Chrome 追踪格式的 JSON
+    uint32_t    nextModelId() noexcept;                                               // < 分配模型实例编号
+
+    static uint32_t currentModel() noexcept;                         // < 获取当前线程正在追踪的模型实例编号
+    static uint32_t exchangeCurrentModel(uint32_t model_id) noexcept;  // < 设置当前线程正在追踪的模型实例编号，返回之前的编号
+
+private:
+    TraceRecorder() = default;
+    TraceRing* localRing();
+
+    std::atomic<bool>                       enabled_{false};        // < 是否开启追踪
+    std::atomic<uint64_t>                   generation_{0};         // < 每次 start 递增，使线程重新创建缓冲区
+    std::atomic<uint32_t>                   next_model_id_{0};      // < 下一个模型实例编号
+    std::atomic<uint32_t>                   next_thread_id_{0};     // < 下一个线程编号
+    size_t                                  events_per_thread_{0};  // < 每个线程的缓冲区容量
+    mutable std::mutex                      rings_mutex_;           // < 保护缓冲区列表（仅在线程首次记录和导出时加锁）
+    std::vector<std::shared_ptr<TraceRing>> rings_;                 // < 所有线程的缓冲区
+};
+
+/**
+ * @brief RAII 追踪作用域，构造时记录开始时间，析构时写入事件
+ *
+ * 指定模型实例编号的作用域会成为当前线程的模型上下文，内部未指定编号的作用域沿用该编号。
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) noexcept
+        : name_(name), begin_ns_(TraceRecorder::instance().enabled() ? TraceRecorder::now() : -1) {}
+
+    TraceScope(const char* name, uint32_t model_id) noexcept
+        : TraceScope(name) {
+        previous_model_ = TraceRecorder::exchangeCurrentModel(model_id);
+        scoped_model_   = true;
+    }
+
+    ~TraceScope() {
+        if (begin_ns_ >= 0) TraceRecorder::instance().record(name_, begin_ns_, TraceRecorder::now());
+        if (scoped_model_) TraceRecorder::exchangeCurrentModel(previous_model_);
+    }
+
+    TraceScope(const TraceScope&)            = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;                 // < 阶段名称
+    int64_t     begin_ns_;             // < 开始时间，未开启追踪时为 -1
+    uint32_t    previous_model_{0};    // < 外层作用域的模型实例编号
+    bool        scoped_model_{false};  // < 是否设置了模型上下文
+};
+
+}  // namespace trtyolo
@@ -0,0 +1,61 @@
+/**
+ * @file vector_types.hpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief CUDA 向量类型（int2、int4、float3 等）；定义 TRTYOLO_HOST_ONLY 时使用布局相同的主机端定义，不依赖 CUDA 工具包
+ * @date 2025-07-18
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#pragma once
+
+#ifndef TRTYOLO_HOST_ONLY
+
+#include <vector_functions.h>
+#include <vector_types.h>
+
+#else
+
+// 与 CUDA vector_types.h 的成员和对齐保持一致
+struct alignas(8) int2 {
+    int x, y;
+};
+
+struct alignas(16) int4 {
+    int x, y, z, w;
+};
+
+struct alignas(8) float2 {
+    float x, y;
+};
+
+struct float3 {
+    float x, y, z;
+};
+
+struct alignas(16) float4 {
+    float x, y, z, w;
+};
+
+inline int2 make_int2(int x, int y) {
+    return int2{x, y};
+}
+
+inline int4 make_int4(int x, int y, int z, int w) {
+    return int4{x, y, z, w};
+}
+
+inline float2 make_float2(float x, float y) {
+    return float2{x, y};
+}
+
+inline float3 make_float3(float x, float y, float z) {
+    return float3{x, y, z};
+}
+
+inline float4 make_float4(float x, float y, float z, float w) {
+    return float4{x, y, z, w};
+}
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file test_dlpack.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief ConsumeDLPack 和 DLPack2Images 的单元测试，在内嵌解释器中构造主机内存的 "dltensor" 胶囊，不需要 GPU
+ * @date 2025-07-18
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <pybind11/embed.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "binding/dlpack.hpp"
+
+namespace {
+
+/**
+ * @brief 测试期间保持内嵌解释器存活
+ */
+class PythonEnvironment : public ::testing::Environment {
+public:
+    void SetUp() override { py::initialize_interpreter(); }
+    void TearDown() override { py::finalize_interpreter(); }
+};
+
+const auto* kPythonEnvironment = ::testing::AddGlobalTestEnvironment(new PythonEnvironment);
+
+/**
+ * @brief 模拟 DLPack 生产者：持有像素和张量描述，记录 deleter 被调用的次数
+ */
+struct Producer {
+    std::vector<uint8_t>  pixels;
+    std::vector<int64_t>  shape;
+    std::vector<int64_t>  strides;
+    dlpack::ManagedTensor managed{};
+    int                   deletes = 0;
+
+    Producer(std::vector<int64_t> shape_, std::vector<int64_t> strides_ = {}, uint64_t byte_offset = 0)
+        : pixels(4096), shape(std::move(shape_)), strides(std::move(strides_)) {
+        auto& tensor       = managed.dl_tensor;
+        tensor.data        = pixels.data();
+        tensor.device      = {dlpack::kDLCPU, 0};
+        tensor.ndim        = static_cast<int32_t>(shape.size());
+        tensor.dtype       = {dlpack::kDLUInt, 8, 1};
+        tensor.shape       = shape.data();
+        tensor.strides     = strides.empty() ? nullptr : strides.data();
+        tensor.byte_offset = byte_offset;
+        managed.manager_ctx = this;
+        managed.deleter     = [](dlpack::ManagedTensor* self) { ++static_cast<Producer*>(self->manager_ctx)->deletes; };
+    }
+
+    /**
+     * @brief 按协议导出胶囊：未被消费（名称仍为 "dltensor"）的胶囊销毁时由生产者释放张量
+     */
+    py::object capsule() {
+        PyObject* capsule = PyCapsule_New(&managed, "dltensor", [](PyObject* self) {
+            if (!PyCapsule_IsValid(self, "dltensor")) return;
+            auto* tensor = static_cast<dlpack::ManagedTensor*>(PyCapsule_GetPointer(self, "dltensor"));
+            if (tensor->deleter) tensor->deleter(tensor);
+        });
+        if (capsule == nullptr) throw py::error_already_set();
+        return py::reinterpret_steal<py::object>(capsule);
+    }
+};
+
+std::string capsuleName(const py::object& capsule) {
+    return PyCapsule_GetName(capsule.ptr());
+}
+
+}  // namespace
+
+TEST(DLPack, UnconsumedCapsuleIsReleasedByProducer) {
+    Producer producer({4, 5, 3});
+    producer.capsule();  // 临时对象立即销毁
+    EXPECT_EQ(producer.deletes, 1);
+}
+
+TEST(DLPack, ConsumeRenamesCapsuleAndDeletesOnce) {
+    Producer producer({4, 5, 3});
+    auto     capsule = producer.capsule();
+    {
+        py::capsule owner = ConsumeDLPack(capsule);
+        EXPECT_EQ(capsuleName(capsule), "used_dltensor");
+        EXPECT_EQ(owner.get_pointer<dlpack::ManagedTensor>(), &producer.managed);
+        EXPECT_EQ(producer.deletes, 0);
+    }
+    EXPECT_EQ(producer.deletes, 1);  // 所有权已转移给 owner
+
+    capsule = py::none();
+    EXPECT_EQ(producer.deletes, 1);  // 已重命名的胶囊销毁时不再释放
+}
+
+TEST(DLPack, ConsumedCapsuleCannotBeConsumedAgain) {
+    Producer producer({4, 5, 3});
+    auto     capsule = producer.capsule();
+    {
+        py::capsule owner = ConsumeDLPack(capsule);
+        EXPECT_THROW(ConsumeDLPack(capsule), py::error_already_set);
+    }
+    capsule = py::none();
+    EXPECT_EQ(producer.deletes, 1);
+}
+
+TEST(DLPack, ConsumesDLPackProtocolObject) {
+    Producer producer({4, 5, 3});
+    auto     types  = py::module::import("types");
+    auto     object = types.attr("SimpleNamespace")();
+    object.attr("__dlpack__")        = py::cpp_function([&producer]() { return producer.capsule(); });
+    object.attr("__dlpack_device__") = py::cpp_function([]() { return py::make_tuple(static_cast<int>(dlpack::kDLCPU), 0); });
+
+    ASSERT_TRUE(IsDLPack(object));
+    {
+        auto result = DLPack2Images(object);
+        ASSERT_EQ(result.images.size(), 1u);
+        EXPECT_EQ(result.images[0].ptr, producer.pixels.data());
+        EXPECT_FALSE(result.batch);
+        EXPECT_EQ(result.device, -1);
+        EXPECT_EQ(producer.deletes, 0);  // 推理结束前由 owner 保持张量存活
+    }
+    EXPECT_EQ(producer.deletes, 1);
+}
+
+TEST(DLPack, RejectsNonDLPackObjects) {
+    EXPECT_THROW(ConsumeDLPack(py::int_(1)), py::type_error);
+    EXPECT_FALSE(IsDLPack(py::int_(1)));
+}
+
+TEST(DLPack, MapsStridedBatchWithByteOffset) {
+    Producer producer({2, 4, 5, 3}, {100, 20, 3, 1}, 8);
+    {
+        auto result = DLPack2Images(producer.capsule());
+        ASSERT_EQ(result.images.size(), 2u);
+        EXPECT_TRUE(result.batch);
+        EXPECT_EQ(result.images[0].ptr, producer.pixels.data() + 8);
+        EXPECT_EQ(result.images[1].ptr, producer.pixels.data() + 8 + 100);
+        EXPECT_EQ(result.images[1].pitch, 20u);
+    }
+    EXPECT_EQ(producer.deletes, 1);
+}
+
+TEST(DLPack, RejectedTensorIsReleasedOnce) {
+    Producer bad_dtype({4, 5, 3}), bad_ndim({4, 5}), bad_channels({4, 5, 4});
+    bad_dtype.managed.dl_tensor.dtype = {2, 32, 1};
+
+    EXPECT_THROW(DLPack2Images(bad_dtype.capsule()), std::invalid_argument);
+    EXPECT_THROW(DLPack2Images(bad_ndim.capsule()), std::invalid_argument);
+    EXPECT_THROW(DLPack2Images(bad_channels.capsule()), std::invalid_argument);
+
+    EXPECT_EQ(bad_dtype.deletes, 1);
+    EXPECT_EQ(bad_ndim.deletes, 1);
+    EXPECT_EQ(bad_channels.deletes, 1);
+}
+
+TEST(DLPack, MapsListOfTensors) {
+    Producer first({4, 5, 3}), second({6, 7, 3});
+    {
+        py::list items;
+        items.append(first.capsule());
+        items.append(second.capsule());
+
+        auto result = DLPack2Images(items);
+        ASSERT_EQ(result.images.size(), 2u);
+        EXPECT_TRUE(result.batch);
+        EXPECT_EQ(result.images[1].width, 7);
+        EXPECT_EQ(result.images[1].height, 6);
+    }
+    EXPECT_EQ(first.deletes, 1);
+    EXPECT_EQ(second.deletes, 1);
+}
+
+TEST(DLPack, RejectsBatchedTensorInList) {
+    Producer image({4, 5, 3}), batch({2, 4, 5, 3});
+    {
+        py::list items;
+        items.append(image.capsule());
+        items.append(batch.capsule());
+        EXPECT_THROW(DLPack2Images(items), std::invalid_argument);
+    }
+    EXPECT_EQ(image.deletes, 1);
+    EXPECT_EQ(batch.deletes, 1);
+}
@@ -0,0 +1,170 @@
+/**
+ * @file test_dltensor.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief DLTensor2Images 的单元测试，使用主机内存构造的 DLPack 张量，不需要 Python 和 GPU
+ * @date 2025-07-18
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "binding/dltensor.hpp"
+
+namespace {
+
+/**
+ * @brief 主机内存中的 uint8 DLPack 张量，strides 为空时表示紧密排列
+ */
+struct HostTensor {
+    std::vector<uint8_t> pixels;
+    std::vector<int64_t> shape;
+    std::vector<int64_t> strides;
+    dlpack::Tensor       tensor{};
+
+    HostTensor(std::vector<int64_t> shape_, std::vector<int64_t> strides_ = {}, size_t bytes = 4096, uint64_t byte_offset = 0)
+        : pixels(bytes), shape(std::move(shape_)), strides(std::move(strides_)) {
+        tensor.data        = pixels.data();
+        tensor.device      = {dlpack::kDLCPU, 0};
+        tensor.ndim        = static_cast<int32_t>(shape.size());
+        tensor.dtype       = {dlpack::kDLUInt, 8, 1};
+        tensor.shape       = shape.data();
+        tensor.strides     = strides.empty() ? nullptr : strides.data();
+        tensor.byte_offset = byte_offset;
+    }
+};
+
+std::vector<trtyolo::Image> map(const dlpack::Tensor& tensor, int* device = nullptr) {
+    std::vector<trtyolo::Image> images;
+    int                         result = DLTensor2Images(tensor, images);
+    if (device) *device = result;
+    return images;
+}
+
+}  // namespace
+
+TEST(DLTensor2Images, MapsPackedImage) {
+    HostTensor host({4, 5, 3});
+
+    int  device = 0;
+    auto images = map(host.tensor, &device);
+
+    ASSERT_EQ(images.size(), 1u);
+    EXPECT_EQ(device, -1);
+    EXPECT_EQ(images[0].ptr, host.pixels.data());
+    EXPECT_EQ(images[0].width, 5);
+    EXPECT_EQ(images[0].height, 4);
+    EXPECT_EQ(images[0].channels, 3);
+    EXPECT_EQ(images[0].pitch, 15u);
+}
+
+TEST(DLTensor2Images, MapsStridedBatch) {
+    // 每行填充到 20 字节，每张图像之间再间隔 20 字节，例如从更大的张量中切片得到的视图
+    HostTensor host({2, 4, 5, 3}, {100, 20, 3, 1});
+
+    auto images = map(host.tensor);
+
+    ASSERT_EQ(images.size(), 2u);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(images[i].ptr, host.pixels.data() + i * 100);
+        EXPECT_EQ(images[i].width, 5);
+        EXPECT_EQ(images[i].height, 4);
+        EXPECT_EQ(images[i].pitch, 20u);
+    }
+}
+
+TEST(DLTensor2Images, AppliesByteOffset) {
+    HostTensor host({2, 4, 5, 3}, {}, 4096, 64);
+
+    auto images = map(host.tensor);
+
+    ASSERT_EQ(images.size(), 2u);
+    EXPECT_EQ(images[0].ptr, host.pixels.data() + 64);
+    EXPECT_EQ(images[1].ptr, host.pixels.data() + 64 + 4 * 5 * 3);
+    EXPECT_EQ(images[1].pitch, 15u);
+}
+
+TEST(DLTensor2Images, IgnoresStridesOfUnitDimensions) {
+    // 长度为 1 的维度步长可以是任意值（PyTorch 的 unsqueeze 和 expand 会产生这样的步长）
+    HostTensor host({1, 1, 5, 3}, {0, 7, 3, 1});
+
+    auto images = map(host.tensor);
+
+    ASSERT_EQ(images.size(), 1u);
+    EXPECT_EQ(images[0].ptr, host.pixels.data());
+    EXPECT_EQ(images[0].pitch, 15u);
+}
+
+TEST(DLTensor2Images, AppendsToExistingImages) {
+    HostTensor first({4, 5, 3}), second({2, 4, 5, 3});
+
+    std::vector<trtyolo::Image> images;
+    DLTensor2Images(first.tensor, images);
+    DLTensor2Images(second.tensor, images);
+
+    ASSERT_EQ(images.size(), 3u);
+    EXPECT_EQ(images[0].ptr, first.pixels.data());
+    EXPECT_EQ(images[2].ptr, second.pixels.data() + 4 * 5 * 3);
+}
+
+TEST(DLTensor2Images, ReportsDevice) {
+    HostTensor host({4, 5, 3});
+    int        device = 0;
+
+    host.tensor.device = {dlpack::kDLCUDA, 1};
+    map(host.tensor, &device);
+    EXPECT_EQ(device, 1);
+
+    host.tensor.device = {dlpack::kDLCUDAManaged, 2};
+    map(host.tensor, &device);
+    EXPECT_EQ(device, 2);
+
+    host.tensor.device = {dlpack::kDLCUDAHost, 3};  // 锁页内存由主机访问
+    map(host.tensor, &device);
+    EXPECT_EQ(device, -1);
+
+    host.tensor.device = {4, 0};  // kDLOpenCL
+    EXPECT_THROW(map(host.tensor), std::invalid_argument);
+}
+
+TEST(DLTensor2Images, RejectsDataType) {
+    HostTensor host({4, 5, 3});
+
+    host.tensor.dtype = {2, 32, 1};  // float32
+    EXPECT_THROW(map(host.tensor), std::invalid_argument);
+
+    host.tensor.dtype = {0, 8, 1};  // int8
+    EXPECT_THROW(map(host.tensor), std::invalid_argument);
+
+    host.tensor.dtype = {dlpack::kDLUInt, 16, 1};
+    EXPECT_THROW(map(host.tensor), std::invalid_argument);
+
+    host.tensor.dtype = {dlpack::kDLUInt, 8, 3};
+    EXPECT_THROW(map(host.tensor), std::invalid_argument);
+}
+
+TEST(DLTensor2Images, RejectsShape) {
+    HostTensor gray({4, 5}), five({1, 2, 4, 5, 3}), rgba({4, 5, 4}), single({2, 4, 5, 1});
+
+    EXPECT_THROW(map(gray.tensor), std::invalid_argument);
+    EXPECT_THROW(map(five.tensor), std::invalid_argument);
+    EXPECT_THROW(map(rgba.tensor), std::invalid_argument);
+    EXPECT_THROW(map(single.tensor), std::invalid_argument);
+}
+
+TEST(DLTensor2Images, RejectsUnpackedPixels) {
+    HostTensor planar({4, 5, 3}, {5, 1, 20});         // CHW 张量 permute 得到的 HWC 视图
+    HostTensor strided_pixels({4, 5, 3}, {30, 6, 1});  // 每隔一个像素取样
+    HostTensor overlapping_rows({4, 5, 3}, {9, 3, 1});
+    HostTensor reversed_batch({2, 4, 5, 3}, {-60, 15, 3, 1});
+
+    EXPECT_THROW(map(planar.tensor), std::invalid_argument);
+    EXPECT_THROW(map(strided_pixels.tensor), std::invalid_argument);
+    EXPECT_THROW(map(overlapping_rows.tensor), std::invalid_argument);
+    EXPECT_THROW(map(reversed_batch.tensor), std::invalid_argument);
+}
@@ -0,0 +1,178 @@
+/**
+ * @file test_event_ring.cpp
+ * @author laugh12321 (laugh12321@vip.qq.com)
+ * @brief SampledEventRing 的单元测试，使用假时钟事件源控制事件的记录时间和完成时间
+ * @date 2025-07-18
+ *
+ * @copyright Copyright (c) 2025 laugh12321. All Rights Reserved.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "utils/event_ring.hpp"
+
+namespace {
+
+/**
+ * @brief 假时钟，记录每个事件的记录时间和完成时间
+ */
+struct FakeClock {
+    float              now     = 0.0f;  // < 当前时间（毫秒）
+    float              latency = 0.0f;  // < 之后记录的事件在多久后完成
+    std::vector<float> recorded;        // < 每个事件的记录时间
+    std::vector<float> done_at;         // < 每个事件的完成时间
+    int                created   = 0;   // < 创建的事件数
+    int                destroyed = 0;   // < 销毁的事件数
+    int                records   = 0;   // < 记录事件的次数
+
+    void advance(float ms) { now += ms; }
+};
+
+/**
+ * @brief 基于假时钟的事件源，事件在记录 latency 毫秒后完成
+ */
+struct FakeEventSource {
+    using Event = int;
+
+    std::shared_ptr<FakeClock> clock = std::make_shared<FakeClock>();
+
+    Event create() const {
+        clock->recorded.push_back(0.0f);
+        clock->done_at.push_back(std::numeric_limits<float>::infinity());
+        ++clock->created;
+        return static_cast<Event>(clock->recorded.size() - 1);
+    }
+
+    void destroy(Event) const { ++clock->destroyed; }
+
+    void record(Event event) const {
+        clock->recorded[event] = clock->now;
+        clock->done_at[event]  = clock->now + clock->latency;
+        ++clock->records;
+    }
+
+    bool ready(Event event) const { return clock->now >= clock->done_at[event]; }
+
+    float elapsed(Event start, Event stop) const { return clock->recorded[stop] - clock->recorded[start]; }
+};
+
+using Ring = trtyolo::SampledEventRing<FakeEventSource>;
+
+/**
+ * @brief 模拟一次耗时 duration 毫秒的请求，结束事件在 latency 毫秒后完成
+ */
+bool request(Ring& ring, float duration, float latency = 0.0f) {
+    auto& clock   = *ring.source().clock;
+    bool  sampled = ring.begin();
+    clock.advance(duration);
+    clock.latency = latency;
+    ring.end();
+    return sampled;
+}
+
+std::vector<float> collect(Ring& ring) {
+    std::vector<float> samples;
+    ring.collect([&](float ms) { samples.push_back(ms); });
+    return samples;
+}
+
+}  // namespace
+
+TEST(SampledEventRing, SamplesOneInN) {
+    Ring ring(FakeEventSource{}, 8, 3);
+    auto clock = ring.source().clock;
+
+    std::vector<bool> sampled;
+    for (int i = 0; i < 9; ++i) sampled.push_back(request(ring, static_cast<float>(i + 1)));
+
+    EXPECT_EQ(sampled, (std::vector<bool>{true, false, false, true, false, false, true, false, false}));
+    EXPECT_EQ(clock->records, 6);  // 每个被采样的请求记录开始和结束两个事件
+    EXPECT_EQ(ring.pending(), 3u);
+    EXPECT_EQ(collect(ring), (std::vector<float>{1.0f, 4.0f, 7.0f}));
+    EXPECT_EQ(ring.pending(), 0u);
+    EXPECT_EQ(ring.dropped(), 0u);
+}
+
+TEST(SampledEventRing, ZeroIntervalAndCapacityAreClampedToOne) {
+    Ring ring(FakeEventSource{}, 0, 0);
+    EXPECT_EQ(ring.source().clock->created, 2);
+
+    EXPECT_TRUE(request(ring, 1.0f));
+    EXPECT_FALSE(ring.begin());  // 每次请求都采样，但唯一的槽位尚未读取
+    EXPECT_EQ(ring.dropped(), 1u);
+}
+
+TEST(SampledEventRing, WrapsAroundInRecordingOrder) {
+    Ring ring(FakeEventSource{}, 4, 1);
+    auto clock = ring.source().clock;
+
+    std::vector<float> expected, samples;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            float duration = static_cast<float>(round * 3 + i + 1);
+            EXPECT_TRUE(request(ring, duration));
+            expected.push_back(duration);
+        }
+        auto part = collect(ring);
+        samples.insert(samples.end(), part.begin(), part.end());
+    }
+
+    EXPECT_EQ(samples, expected);
+    EXPECT_EQ(clock->created, 8);  // 事件只在构造时创建，绕回后复用
+    EXPECT_EQ(ring.dropped(), 0u);
+}
+
+TEST(SampledEventRing, StopsAtFirstIncompletePair) {
+    Ring ring(FakeEventSource{}, 4, 1);
+    auto clock = ring.source().clock;
+
+    request(ring, 1.0f, 10.0f);  // 最早的事件对最晚完成
+    request(ring, 2.0f, 0.0f);
+    request(ring, 3.0f, 0.0f);
+
+    clock->advance(1.0f);
+    EXPECT_TRUE(collect(ring).empty());  // 后两个已完成，但必须按记录顺序读取
+    EXPECT_EQ(ring.pending(), 3u);
+
+    clock->advance(10.0f);
+    EXPECT_EQ(collect(ring), (std::vector<float>{1.0f, 2.0f, 3.0f}));
+    EXPECT_EQ(ring.pending(), 0u);
+}
+
+TEST(SampledEventRing, DropsSamplesWhenFull) {
+    Ring ring(FakeEventSource{}, 2, 1);
+    auto clock = ring.source().clock;
+
+    EXPECT_TRUE(request(ring, 1.0f, 100.0f));
+    EXPECT_TRUE(request(ring, 2.0f, 100.0f));
+    EXPECT_FALSE(request(ring, 3.0f, 100.0f));
+    EXPECT_FALSE(request(ring, 4.0f, 100.0f));
+    EXPECT_EQ(ring.dropped(), 2u);
+    EXPECT_EQ(ring.pending(), 2u);
+    EXPECT_EQ(clock->records, 4);  // 跳过的采样不记录事件，也不等待
+
+    EXPECT_TRUE(collect(ring).empty());
+    clock->advance(100.0f);
+    EXPECT_EQ(collect(ring), (std::vector<float>{1.0f, 2.0f}));
+
+    EXPECT_TRUE(request(ring, 5.0f));  // 读取后腾出空位，恢复采样
+    EXPECT_EQ(collect(ring), (std::vector<float>{5.0f}));
+    EXPECT_EQ(ring.dropped(), 2u);
+}
+
+TEST(SampledEventRing, DestroysAllEvents) {
+    auto clock = std::make_shared<FakeClock>();
+    {
+        FakeEventSource source;
+        source.clock = clock;
+        Ring ring(source, 3, 1);
+        request(ring, 1.0f, 5.0f);  // 销毁时仍有未完成的事件对
+    }
+    EXPECT_EQ(clock->created, 6);
+    EXPECT_EQ(clock->destroyed, 6);
+}
@@ -1,5 +1,7 @@
+import os
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
-from typing import Any, Dict, List, Optional, Tuple, Union
+from typing import Any, Dict, Iterator, List, Optional, Tuple, Union
 
 import cv2
 import numpy as np
@@ -31,31 +33,40 @@ class TRTYOLO:
         >>> from trtyolo import TRTYOLO
         >>> det = TRTYOLO("yolo11n.engine", task="detect")
         >>> seg = TRTYOLO("yolo11n-seg.engine", task="segment", device=1)
+        >>> auto = TRTYOLO("yolo11n-pose.engine")  # task inferred from engine outputs
+        >>> fam = TRTYOLO(["yolo11n-b1.engine", "yolo11n-b4.engine", "yolo11n-b16.engine"], task="detect")
         >>> cls = TRTYOLO("yolo11n-cls.engine", task="classify",
         ...               mean=(0.485, 0.456, 0.406), std=(0.229, 0.224, 0.225))
     """
 
     def __init__(
         self,
-        model: Union[str, Path],
-        task: str,
+        model: Union[str, Path, List[Union[str, Path]]],
+        task: Optional[str] = None,
         device: Optional[int] = 0,
         swap_rb: Optional[bool] = True,
         profile: Optional[bool] = False,
+        profile_sampling: Optional[int] = None,
         border_value: Optional[float] = None,
         mean: Optional[Tuple[float, float, float]] = None,
         std: Optional[Tuple[float, float, float]] = None,
         input_size: Optional[Tuple[int, int]] = None,
+        cuda_memory: Optional[bool] = False,
     ) -> None:
         """
         Initialize TRT-YOLO model
 
         Args:
-            model (str | Path): Path to TensorRT engine (*.engine).
-            task (str): Task in {'detect', 'segment', 'classify', 'pose', 'obb'}.
+            model (str | Path | List[str | Path]): Path to TensorRT engine (*.engine), or a list of engines built from
+                                                  the same network with different static batch sizes (e.g. 1, 4, 16);
+                                                  each call then runs on the engine with the fewest padded slots.
+            task (str, optional): Task in {'detect', 'segment', 'classify', 'pose', 'obb'}. Default None
+                                  (inferred from the engine outputs, cached in a `<engine>.info` sidecar file).
             device (int, optional): GPU device id. Default 0.
             swap_rb (bool, optional): Swap R<->B during preprocessing. Default True.
             profile (bool, optional): Enable latency profiler. Default False.
+            profile_sampling (int, optional): Time one request in every N on the GPU when `profile` is enabled.
+                                              Default None (every request; GPU timings are read back asynchronously).
             border_value (float, optional): Pad value for letterbox. Default None (114).
             mean (Tuple[float, float, float], optional): Normalization mean. Must pair with `std`.
             std (Tuple[float, float, float], optional): Normalization std. Must pair with `mean`.
@@ -64,6 +75,9 @@ class TRTYOLO:
                                                    Only useful when **real input size is constant**
                                                    (e.g. video analysis). Does **not** change model
                                                    native shape. Default None (dynamic).
+            cuda_memory (bool, optional): Inputs are CUDA tensors on `device` (e.g. PyTorch or CuPy tensors passed
+                                          through DLPack) and are preprocessed in place on the GPU. Host inputs
+                                          (paths, np.ndarray, CPU tensors) are rejected. Default False.
         """
         option = C.option.InferOption()
         option.set_device_id(device)
@@ -71,12 +85,26 @@ class TRTYOLO:
             option.enable_swap_rb()
         if profile:
             option.enable_profile()
+        if profile_sampling is not None:
+            option.set_profile_sampling(profile_sampling)
         if border_value is not None:
             option.set_border_value(border_value)
         if mean is not None and std is not None:
             option.set_normalize_params(mean, std)
         if input_size is not None:
             option.set_input_dimensions(input_size[0], input_size[1])
+        if cuda_memory:
+            option.enable_cuda_memory()
+
+        if isinstance(model, (list, tuple)):
+            model = [str(m) for m in model]
+        else:
+            model = str(model)
+
+        if task is None:
+            task = C.info.inspect(model[0] if isinstance(model, list) else model).task
+            if task not in self.task_map:
+                raise ValueError("Cannot infer task from engine outputs, please specify `task` explicitly.")
 
         self._task = task
         self._model = self.task_map[task](model, option)
@@ -97,6 +125,44 @@ class TRTYOLO:
         """Get model batch size."""
         return self._model.batch
 
+    @property
+    def num_output_boxes(self) -> int:
+        """Get the maximum number of objects per image (k of top-k for classification)."""
+        return self._model.num_output_boxes
+
+    def allocate_out(self, batch: Optional[int] = None) -> Tuple[Optional[np.ndarray], np.ndarray, np.ndarray]:
+        """
+        Allocate `(boxes, scores, classes)` arrays for `predict(..., out=...)`, once, outside the real-time loop.
+
+        Args:
+            batch (int, optional): Number of images per call. Default None (the model batch size).
+
+        Returns:
+            Tuple[np.ndarray | None, np.ndarray, np.ndarray]: float32 (R, 4) boxes (None for classification),
+                float32 (R,) scores and int32 (R,) classes, where R = `num_output_boxes * batch`.
+        """
+        rows = self.num_output_boxes * (batch or self.batch)
+        boxes = None if self._task == "classify" else np.empty((rows, 4), dtype=np.float32)
+        return boxes, np.empty(rows, dtype=np.float32), np.empty(rows, dtype=np.int32)
+
+    @property
+    def memory_footprint(self) -> C.model.MemoryFootprint:
+        """
+        Get the current and peak bytes held by the model's buffers, per buffer type.
+
+        Pinned host memory is `discrete + mapped`. Use `C.metrics.memory_footprint()` for the whole process.
+        """
+        return self._model.memory_footprint
+
+    @property
+    def batch_occupancy(self) -> C.model.BatchOccupancy:
+        """
+        Get requested images versus executed batch slots, shared with clones.
+
+        Static engines always execute the maximum batch, so `padding` counts the wasted slots.
+        """
+        return self._model.batch_occupancy
+
     def __copy__(self) -> None:
         cls = self.__class__.__name__
         raise NotImplementedError(f"Model '{cls}' does not support copy, use clone() instead.")
@@ -127,25 +193,86 @@ class TRTYOLO:
         new_obj._model = self._model.clone()
         return new_obj
 
+    def reload(self, model: Union[str, Path, List[Union[str, Path]]]) -> None:
+        """
+        Hot-swap the TensorRT engine of a live model.
+
+        The new engine is loaded while other threads keep predicting on the old one. Calls already in flight
+        finish on the old engine, which is released once the last of them returns.
+
+        Args:
+            model (str | Path | List[str | Path]): Path to the new TensorRT engine, or a list of engines of the same network.
+        """
+        if isinstance(model, (list, tuple)):
+            self._model.reload([str(m) for m in model])
+        else:
+            self._model.reload(str(model))
+
+    def reload_from(self, other: "TRTYOLO") -> None:
+        """
+        Switch to the engine currently used by another instance, e.g. propagate a `reload` to all clones
+        without loading the engine again.
+
+        Args:
+            other (TRTYOLO): Instance whose engine should be shared.
+        """
+        self._model.reload_from(other._model)
+
     def predict(
         self,
-        source: Union[str, Path, np.ndarray, List[Union[str, Path, np.ndarray]]],
+        source: Union[str, Path, np.ndarray, Any, List[Union[str, Path, np.ndarray, Any]]],
+        out: Optional[Tuple[Optional[np.ndarray], np.ndarray, np.ndarray]] = None,
     ) -> Union[
         Union[sv.Detections, sv.KeyPoints, sv.Classifications],
         List[Union[sv.Detections, sv.KeyPoints, sv.Classifications]],
+        int,
+        List[int],
     ]:
         """
         Predict on an image or batch of images.
 
         Args:
-            source (str | Path | np.ndarray | List[str | Path | np.ndarray]): Source image or batch of images.
+            source (str | Path | np.ndarray | Tensor | List[str | Path | np.ndarray | Tensor]): Source image or batch of
+                images. A uint8 array of shape (N, H, W, 3) is treated as a batch and passed to the engine without
+                per-image conversion. Tensors of other frameworks (anything implementing `__dlpack__`, such as
+                PyTorch or CuPy tensors) in HWC or NHWC layout are read in place through DLPack; CUDA tensors
+                require `cuda_memory=True`. A list of paths is decoded on a pool of native threads, pipelined with
+                inference, when trtyolo is built with `-DBUILD_OPENCV_IO=ON`, and with `cv2.imread` on a thread pool
+                otherwise.
+            out (Tuple[np.ndarray, np.ndarray, np.ndarray], optional): Preallocated `(boxes, scores, classes)` arrays to
+                write the objects into instead of building result objects, e.g. from `allocate_out()`. The arrays are
+                float32 (R, 4), float32 (R,) and int32 (R,), C-contiguous, with R >= `num_output_boxes` * number of
+                images; image i is written from row `i * num_output_boxes`. Boxes are None for classification. Only
+                NumPy images and paths are accepted. Default None.
 
         Returns:
             Union[sv.Detections, sv.KeyPoints, sv.Classifications] | List[Union[sv.Detections, sv.KeyPoints, sv.Classifications]]: Prediction results for the input image(s).
+            int | List[int]: With `out`, the number of objects written for the image, or for each image of a batch.
+
+        Examples:
+            >>> boxes, scores, classes = out = model.allocate_out()
+            >>> while True:
+            ...     n = model.predict(frame, out=out)
+            ...     draw(frame, boxes[:n], scores[:n], classes[:n])
         """
+        if out is not None:
+            if isinstance(source, (str, Path)):
+                source = read_images([source])[0]
+            elif isinstance(source, list) and source and all(isinstance(s, (str, Path)) for s in source):
+                source = read_images(source)
+            return self._model.predict(source, tuple(out))
+        if is_dlpack(source) or (isinstance(source, list) and source and all(is_dlpack(s) for s in source)):
+            return self._predict_dlpack(source)
+        if isinstance(source, np.ndarray) and source.ndim == 4:
+            batch = self._model.batch
+            results = [r for i in range(0, len(source), batch) for r in self._model.predict(source[i : i + batch])]
+            return [convert_to_sv(res, source.shape[1:3]) for res in results]
         if isinstance(source, list):
-            if all(isinstance(s, (str, Path)) for s in source):
-                source = [cv2.imread(str(s)) for s in source]
+            if source and all(isinstance(s, (str, Path)) for s in source):
+                if C.model.opencv_io:
+                    results, shapes = self._model.predict_paths([str(s) for s in source])
+                    return [convert_to_sv(res, shape) for res, shape in zip(results, shapes)]
+                source = read_images(source)
             elif all(isinstance(s, np.ndarray) for s in source):
                 pass
             else:
@@ -161,11 +288,112 @@ class TRTYOLO:
                 img = source
             return convert_to_sv(self._model.predict(img), img.shape[:2])
 
+    def _predict_dlpack(self, source: Union[Any, List[Any]]) -> Union[
+        Union[sv.Detections, sv.KeyPoints, sv.Classifications],
+        List[Union[sv.Detections, sv.KeyPoints, sv.Classifications]],
+    ]:
+        """Predict on DLPack tensors, split into chunks of the model batch size."""
+        if not isinstance(source, list) and len(source.shape) == 3:
+            return convert_to_sv(self._model.predict(source), tuple(source.shape[:2]))
+        batch = self._model.batch
+        results = [r for i in range(0, len(source), batch) for r in self._model.predict(source[i : i + batch])]
+        return [convert_to_sv(res, tuple(img.shape[:2])) for res, img in zip(results, source)]
+
+    async def predict_async(
+        self,
+        source: Union[np.ndarray, Any, List[Union[np.ndarray, Any]]],
+    ) -> Union[
+        Union[sv.Detections, sv.KeyPoints, sv.Classifications],
+        List[Union[sv.Detections, sv.KeyPoints, sv.Classifications]],
+    ]:
+        """
+        Predict on an image or batch of images without blocking the event loop.
+
+        Inference runs on a native background thread owned by this instance, and the awaitable is completed from
+        that thread through `loop.call_soon_threadsafe`, so no executor is needed. Requests on the same instance
+        run in order; give each concurrent stream its own `clone()` to run them in parallel.
+
+        Args:
+            source (np.ndarray | Tensor | List[np.ndarray | Tensor]): A HWC image, a uint8 array or DLPack tensor of
+                                                                     shape (N, H, W, 3) or a list of HWC images, with
+                                                                     at most `batch` images.
+
+        Returns:
+            Union[sv.Detections, sv.KeyPoints, sv.Classifications] | List[Union[sv.Detections, sv.KeyPoints, sv.Classifications]]: Prediction results for the input image(s).
+        """
+        results = await self._model.predict_async(source)
+        if not isinstance(source, list) and len(source.shape) == 3:
+            return convert_to_sv(results, tuple(source.shape[:2]))
+        shapes = [tuple(img.shape[:2]) for img in source]
+        return [convert_to_sv(res, shape) for res, shape in zip(results, shapes)]
+
+    def predict_batch(
+        self,
+        source: Union[np.ndarray, List[Union[str, Path, np.ndarray]]],
+    ) -> C.result.BatchRes:
+        """
+        Predict on a batch of any length and return columnar results.
+
+        The objects of all images are concatenated into flat arrays (`xyxy`, `confidence`, `class_id`,
+        `image_index`, plus `masks`, `kpts` or `xyxyxyxy` where the task has them), and `counts` holds the
+        number of objects per image. No per-image Python objects are created, which matters at thousands
+        of frames per second. Boxes are in original image coordinates; masks are not pasted. The columns are
+        NumPy arrays, so they can be handed to other frameworks without a copy through DLPack, e.g.
+        `torch.from_dlpack(res.xyxy)`.
+
+        Args:
+            source (np.ndarray | Tensor | List[str | Path | np.ndarray | Tensor]): A uint8 array or DLPack tensor of
+                                                                               shape (N, H, W, 3), or a list of image
+                                                                               paths, HWC arrays or tensors.
+
+        Returns:
+            C.result.BatchRes: Columnar results of the whole batch.
+        """
+        if isinstance(source, list) and source and all(isinstance(s, (str, Path)) for s in source):
+            if C.model.opencv_io:
+                return self._model.predict_batch([str(s) for s in source])
+            source = read_images(source)
+        return self._model.predict_batch(source)
+
+    def stream(
+        self,
+        source: Union[str, Path, int],
+        queue_size: int = 8,
+    ) -> Iterator[Tuple[np.ndarray, Union[sv.Detections, sv.KeyPoints, sv.Classifications]]]:
+        """
+        Iterate over a video file, stream URL or camera, yielding each frame with its prediction.
+
+        Frames are decoded by OpenCV on a native thread and inferred on a clone of the model on another native
+        thread, in batches of the frames decoded so far, so decoding, staging and inference overlap with the
+        Python loop without Python threads or the GIL. At most `queue_size` frames wait in each stage; a slow
+        loop pauses decoding instead of dropping frames. Leaving the loop early stops both threads. Requires
+        trtyolo built with `-DBUILD_OPENCV_IO=ON`.
+
+        Args:
+            source (str | Path | int): Path of a video file, a stream URL, or a camera index.
+            queue_size (int, optional): Capacity of the decoded-frame and result queues. Default 8.
+
+        Yields:
+            Tuple[np.ndarray, Union[sv.Detections, sv.KeyPoints, sv.Classifications]]: The BGR frame and its prediction.
+
+        Examples:
+            >>> for frame, detections in model.stream("video.mp4"):
+            ...     frame = box_annotator.annotate(frame, detections)
+        """
+        video = self._model.stream(source if isinstance(source, int) else str(source), queue_size)
+        try:
+            for frame, result in video:
+                yield frame, convert_to_sv(result, frame.shape[:2])
+        finally:
+            video.close()
+
     def profile(self) -> Tuple[str, str, str]:
         """
         Get latency statistics.
 
-        Requires `profile=True` during initialization.
+        Requires `profile=True` during initialization. The statistics are shared with clones and cover all of them;
+        throughput is the request count over the wall-clock time from the start of the first call to the end of the last
+        one, idle time included. Reading does not reset them, call `reset_profile()` for per-interval figures.
 
         Returns:
             Tuple[str, str, str]: (throughput, cpu_latency, gpu_latency)
@@ -178,6 +406,25 @@ class TRTYOLO:
         """
         return self._model.profile()
 
+    def profile_breakdown(self) -> Dict[str, Any]:
+        """
+        Get per-stage latency statistics.
+
+        Requires `profile=True` during initialization. Shares its statistics with `profile()`.
+
+        Returns:
+            Dict[str, Any]: {'throughput': qps, 'staging': {...}, 'h2d': {...}, 'letterbox': {...}, 'inference': {...},
+                             'd2h': {...}, 'postprocess': {...}, 'cpu_total': {...}, 'gpu_total': {...}}, where each
+                             stage dict holds count, min, max, mean, median, p90, p95 and p99 in milliseconds.
+        """
+        return self._model.profile_breakdown()
+
+    def reset_profile(self) -> None:
+        """
+        Reset the latency statistics of this model and its clones, starting a new measurement window.
+        """
+        self._model.reset_profile()
+
 
 def convert_to_sv(result: C.result.BaseRes, img_shape: Tuple[int, int]) -> Union[sv.Detections, sv.KeyPoints, sv.Classifications]:
     """
@@ -229,6 +476,37 @@ def convert_to_sv(result: C.result.BaseRes, img_shape: Tuple[int, int]) -> Union
         raise ValueError(f"Unknown result type: {type(result)}")
 
 
+def read_images(paths: List[Union[str, Path]]) -> List[np.ndarray]:
+    """
+    Read images in parallel; `cv2.imread` releases the GIL, so the threads decode concurrently.
+
+    Args:
+        paths (List[str | Path]): Image paths.
+
+    Returns:
+        List[np.ndarray]: The BGR images, in the order of `paths`.
+    """
+    with ThreadPoolExecutor(max_workers=min(len(paths), os.cpu_count() or 1)) as pool:
+        images = list(pool.map(lambda path: cv2.imread(str(path)), paths))
+    for path, image in zip(paths, images):
+        if image is None:
+            raise FileNotFoundError(f"Failed to read image: {path}")
+    return images
+
+
+def is_dlpack(source: Any) -> bool:
+    """
+    Check whether the source is a tensor of another framework exchanged through DLPack (NumPy arrays excluded).
+
+    Args:
+        source (Any): Input object.
+
+    Returns:
+        bool: True if the object implements `__dlpack__` and is not a np.ndarray.
+    """
+    return hasattr(source, "__dlpack__") and not isinstance(source, np.ndarray)
+
+
 def split_xy_conf(arr: np.ndarray) -> Tuple[np.ndarray, Optional[np.ndarray]]:
     """
     Split the input array into two parts: coordinates and confidence.
@@ -259,6 +537,7 @@ def paste_masks_in_image(masks: np.ndarray, boxes: np.ndarray, img_shape: Tuple[
     Args:
         masks (np.ndarray): Array containing multiple masks, where each mask represents the segmentation result of an object.
         boxes (np.ndarray): Array containing multiple bounding boxes, each in the format [x1, y1, x2, y2], corresponding to the position of the mask.
+                            Float coordinates are truncated to integer pixels.
         img_shape (Tuple[int, int]): Shape of the target image, formatted as (height, width).
 
     Returns:
@@ -295,4 +574,5 @@ def paste_masks_in_image(masks: np.ndarray, boxes: np.ndarray, img_shape: Tuple[
     if masks.size == 0:
         return None
     im_h, im_w = img_shape
+    boxes = boxes.astype(np.int32)  # result boxes are float32, paste at integer pixels
     return np.array([paste_mask_in_image(mask, box, im_h, im_w) for mask, box in zip(masks, boxes)], dtype=bool)